@@ -23,10 +23,13 @@ class Variable;
 class TypeVariable;
 class TypeDecl;
 class ListTypeExpr;
+class SetTypeExpr;
+class MapTypeExpr;
 class ListVarExpr;
 class IfExpr;
 class Let;
 class InitNext;
+class AutumnValue;
 
 class Expr {
 public:
@@ -50,6 +53,10 @@ public:
     virtual std::any
     visitListTypeExprExpr(std::shared_ptr<ListTypeExpr> stmt) = 0;
     virtual std::any
+    visitSetTypeExprExpr(std::shared_ptr<SetTypeExpr> stmt) = 0;
+    virtual std::any
+    visitMapTypeExprExpr(std::shared_ptr<MapTypeExpr> stmt) = 0;
+    virtual std::any
     visitListVarExprExpr(std::shared_ptr<ListVarExpr> stmt) = 0;
     virtual std::any visitIfExprExpr(std::shared_ptr<IfExpr> stmt) = 0;
     virtual std::any visitLetExpr(std::shared_ptr<Let> stmt) = 0;
@@ -99,6 +106,11 @@ public:
 
   const std::shared_ptr<Expr> callee;
   const std::vector<std::shared_ptr<Expr>> arguments;
+  // Slot in the interpreter's per-step memo, -1 if not memoized
+  int stepMemoSlot = -1;
+  // Number of the call in the program, which random builtins key their
+  // draws by; -1 for calls made outside of it
+  int site = -1;
 };
 
 class Get : public Expr, public std::enable_shared_from_this<Get> {
@@ -111,6 +123,8 @@ public:
 
   const std::shared_ptr<Expr> object;
   const Token name;
+  // Slot in the interpreter's per-step memo, -1 if not memoized
+  int stepMemoSlot = -1;
 };
 
 class Grouping : public Expr, public std::enable_shared_from_this<Grouping> {
@@ -133,6 +147,8 @@ public:
   }
 
   const std::any value;
+  // Immutable value built once by the parser; evaluation returns it as is
+  std::shared_ptr<AutumnValue> constant;
 };
 
 class Logical : public Expr, public std::enable_shared_from_this<Logical> {
@@ -186,6 +202,13 @@ public:
 
   const std::vector<Token> params;
   const std::shared_ptr<Expr> right;
+  // Set when the result depends on nothing but the arguments, so parallel
+  // builtins may call the lambda from several threads
+  bool pure = false;
+  // Set when calling the lambda has no effect: it may read any binding, its
+  // caller's included, but assigns nothing and draws no random numbers, so
+  // a fused list chain may interleave its calls with other stages
+  bool effectFree = false;
 };
 
 class Variable : public Expr, public std::enable_shared_from_this<Variable> {
@@ -236,6 +259,33 @@ public:
   const std::shared_ptr<Expr> typeexpr;
 };
 
+class SetTypeExpr : public Expr,
+                    public std::enable_shared_from_this<SetTypeExpr> {
+public:
+  SetTypeExpr(std::shared_ptr<Expr> typeexpr) : typeexpr(typeexpr) {}
+
+  std::any accept(Visitor &visitor) override {
+    return visitor.visitSetTypeExprExpr(shared_from_this());
+  }
+
+  const std::shared_ptr<Expr> typeexpr;
+};
+
+class MapTypeExpr : public Expr,
+                    public std::enable_shared_from_this<MapTypeExpr> {
+public:
+  MapTypeExpr(std::shared_ptr<Expr> keytypeexpr,
+              std::shared_ptr<Expr> valuetypeexpr)
+      : keytypeexpr(keytypeexpr), valuetypeexpr(valuetypeexpr) {}
+
+  std::any accept(Visitor &visitor) override {
+    return visitor.visitMapTypeExprExpr(shared_from_this());
+  }
+
+  const std::shared_ptr<Expr> keytypeexpr;
+  const std::shared_ptr<Expr> valuetypeexpr;
+};
+
 class ListVarExpr : public Expr,
                     public std::enable_shared_from_this<ListVarExpr> {
 public:
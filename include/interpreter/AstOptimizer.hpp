@@ -0,0 +1,102 @@
+#ifndef _AUTUMN_AST_OPTIMIZER_HPP_
+#define _AUTUMN_AST_OPTIMIZER_HPP_
+#include "Expr.hpp"
+#include "Stmt.hpp"
+#include <any>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace Autumn {
+class PositionTable;
+
+/// Rewrites a program before it runs. Operators applied to literals are
+/// folded, globals that always hold the same literal are replaced by it,
+/// aliases such as (= vcat concat) are resolved to what they name, ifs on
+/// a literal condition keep only the branch they take, and calls to small
+/// global lambdas such as moveRight or abs are replaced by their body.
+///
+/// The stdlib and the program are rewritten together, since the program may
+/// rebind stdlib globals such as GRID_SIZE. A global only counts as constant
+/// if no top-level statement can call a function before its last
+/// assignment, and it is never rebound by an on-clause, a next expression,
+/// a lambda parameter, a let or an object field.
+///
+/// Lambdas see their caller's bindings, so a call is only inlined when its
+/// arguments are literals or variables, the body binds and assigns nothing,
+/// and no code the body may run reads a variable named like a parameter.
+///
+/// Subtrees that do not change are kept as they are; rewritten nodes are new.
+class AstOptimizer : public Expr::Visitor {
+public:
+  struct Stats {
+    size_t folded = 0;   // operators, positions and constants folded
+    size_t aliases = 0;  // alias reads resolved
+    size_t branches = 0; // if branches dropped
+    size_t inlined = 0;  // calls replaced by the callee's body
+  };
+
+  /// Position(x, y) on literals folds to the interned position from
+  /// `positions`; without a table such calls are left alone
+  explicit AstOptimizer(PositionTable *positions = nullptr)
+      : positions(positions) {}
+
+  void optimize(std::vector<std::shared_ptr<Stmt>> &stdlib,
+                std::vector<std::shared_ptr<Stmt>> &program);
+
+  const Stats &getStats() const { return stats; }
+
+  std::any visitAssignExpr(std::shared_ptr<Assign> expr) override;
+  std::any visitBinaryExpr(std::shared_ptr<Binary> expr) override;
+  std::any visitCallExpr(std::shared_ptr<Call> expr) override;
+  std::any visitGetExpr(std::shared_ptr<Get> expr) override;
+  std::any visitGroupingExpr(std::shared_ptr<Grouping> expr) override;
+  std::any visitLiteralExpr(std::shared_ptr<Literal> expr) override;
+  std::any visitLogicalExpr(std::shared_ptr<Logical> expr) override;
+  std::any visitSetExpr(std::shared_ptr<Set> expr) override;
+  std::any visitUnaryExpr(std::shared_ptr<Unary> expr) override;
+  std::any visitLambdaExpr(std::shared_ptr<Lambda> expr) override;
+  std::any visitVariableExpr(std::shared_ptr<Variable> expr) override;
+  std::any visitTypeVariableExpr(std::shared_ptr<TypeVariable> expr) override;
+  std::any visitTypeDeclExpr(std::shared_ptr<TypeDecl> expr) override;
+  std::any visitListTypeExprExpr(std::shared_ptr<ListTypeExpr> expr) override;
+  std::any visitSetTypeExprExpr(std::shared_ptr<SetTypeExpr> expr) override;
+  std::any visitMapTypeExprExpr(std::shared_ptr<MapTypeExpr> expr) override;
+  std::any visitListVarExprExpr(std::shared_ptr<ListVarExpr> expr) override;
+  std::any visitIfExprExpr(std::shared_ptr<IfExpr> expr) override;
+  std::any visitLetExpr(std::shared_ptr<Let> expr) override;
+  std::any visitInitNextExpr(std::shared_ptr<InitNext> expr) override;
+
+private:
+  // Largest body, in nodes, a call is replaced with
+  static constexpr size_t kMaxInlineSize = 24;
+
+  PositionTable *positions;
+  Stats stats;
+  // Globals that always hold the same literal
+  std::unordered_map<std::string, std::shared_ptr<Literal>> constants;
+  // Globals bound to another global, resolved to the end of the chain
+  std::unordered_map<std::string, std::string> aliases;
+  // Global lambdas whose calls may be inlined
+  std::unordered_map<std::string, std::shared_ptr<Lambda>> functions;
+  // Parameters of the lambda being inlined, bound to the call's arguments
+  std::unordered_map<std::string, std::shared_ptr<Expr>> substitutions;
+  // Lambdas being inlined, to stop at recursive calls
+  std::unordered_set<std::string> inlining;
+  bool positionRedefined = false;
+
+  void analyze(const std::vector<std::shared_ptr<Stmt>> &stmts);
+  std::shared_ptr<Expr> rewrite(const std::shared_ptr<Expr> &expr);
+  std::shared_ptr<Stmt> rewrite(const std::shared_ptr<Stmt> &stmt);
+  // expr with a parameter being inlined replaced by its argument
+  std::shared_ptr<Expr> substitute(const std::shared_ptr<Expr> &expr) const;
+  std::shared_ptr<Expr>
+  inlineCall(const std::string &name,
+             const std::vector<std::shared_ptr<Expr>> &arguments);
+};
+
+} // namespace Autumn
+#endif
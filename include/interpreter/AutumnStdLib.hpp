@@ -8,6 +8,14 @@
 
 namespace Autumn {
 
+// Lists this long are split across threads by map, filter, any and foldl
+// when the function they call is pure
+constexpr size_t kParallelMinSize = 1024;
+
+/// Whether callable is a lambda marked pure, which the parallel builtins may
+/// call from several threads at once
+bool isPureLambda(const AutumnCallableValue &callable);
+
 class RenderAll : public AutumnCallable,
                  public std::enable_shared_from_this<RenderAll> {
 public:
@@ -92,6 +100,21 @@ public:
   }
 };
 
+/// (allObjsOf "Ant"): the live renderable instances of one class
+class AllObjsOf : public AutumnCallable,
+                  public std::enable_shared_from_this<AllObjsOf> {
+public:
+  AllObjsOf() {}
+  std::shared_ptr<AutumnValue>
+  call(Interpreter &interpreter,
+       const std::vector<std::shared_ptr<AutumnValue>> &arguments) override;
+  int arity() override { return 1; }
+  std::string toString() const override { return "<native fn: AllObjsOf>"; }
+  std::shared_ptr<AutumnCallable> clone() override {
+    return shared_from_this();
+  }
+};
+
 class Rotate : public AutumnCallable,
               public std::enable_shared_from_this<Rotate> {
 public:
@@ -118,6 +141,12 @@ public:
   std::shared_ptr<AutumnCallable> clone() override {
     return shared_from_this();
   }
+private:
+  // Tests the slices on worker interpreters; a slice stops once an earlier
+  // element is known to pass
+  bool anyParallel(Interpreter &interpreter,
+                   std::shared_ptr<AutumnCallableValue> callable,
+                   const ValueList &values);
 };
 
 class Foldl : public AutumnCallable,
@@ -132,6 +161,22 @@ public:
   std::shared_ptr<AutumnCallable> clone() override {
     return shared_from_this();
   }
+private:
+  // Whether callable is a lambda known to be associative: + or * of its
+  // parameters, a min or max of them, or the concat of the two
+  static bool isAssociative(Interpreter &interpreter,
+                            const AutumnCallableValue &callable);
+  // Folds values into acc one by one, left to right
+  static std::shared_ptr<AutumnValue>
+  foldSequential(Interpreter &interpreter, AutumnCallableValue &callable,
+                 std::shared_ptr<AutumnValue> acc, const ValueList &values);
+  // Folds each slice on a worker interpreter, then folds the slice results
+  // into acc in order. When a call fails, folds again one by one so the
+  // error is the one the sequential fold raises.
+  std::shared_ptr<AutumnValue>
+  foldParallel(Interpreter &interpreter,
+               std::shared_ptr<AutumnCallableValue> callable,
+               std::shared_ptr<AutumnValue> acc, const ValueList &values);
 };
 
 class IsList : public AutumnCallable,
@@ -536,10 +581,10 @@ public:
 private:
   std::shared_ptr<AutumnValue> mapSequential(Interpreter &interpreter,
                                             std::shared_ptr<AutumnCallableValue> callable,
-                                            const std::vector<std::shared_ptr<AutumnValue>> &arguments);
-  std::shared_ptr<AutumnValue> mapParallelSTL(Interpreter &interpreter,
-                                            std::shared_ptr<AutumnCallableValue> callable,
-                                            const std::vector<std::shared_ptr<AutumnValue>> &arguments);
+                                            const ValueList &arguments);
+  std::shared_ptr<AutumnValue> mapParallel(Interpreter &interpreter,
+                                           std::shared_ptr<AutumnCallableValue> callable,
+                                           const ValueList &arguments);
 };
 
 class Filter : public AutumnCallable,
@@ -555,6 +600,12 @@ public:
   std::shared_ptr<AutumnCallable> clone() override {
     return shared_from_this();
   }
+private:
+  // Tests the slices on worker interpreters and keeps the passing elements
+  // in their original order
+  void filterParallel(Interpreter &interpreter,
+                      std::shared_ptr<AutumnCallableValue> callable,
+                      const ValueList &values, ValueList &kept);
 };
 
 class IsWithinBounds : public AutumnCallable,
@@ -591,6 +642,69 @@ public:
   }
 };
 
+// The samplers below draw cells of the grid directly instead of picking from
+// a list of every position, and only fall back to walking the grid when
+// nearly all of it is taken
+
+/// (randomFreePos size): a position of the size x size grid that nothing
+/// occupied at the last render
+class RandomFreePos : public AutumnCallable,
+                      public std::enable_shared_from_this<RandomFreePos> {
+public:
+  RandomFreePos() {}
+  std::shared_ptr<AutumnValue>
+  call(Interpreter &interpreter,
+       const std::vector<std::shared_ptr<AutumnValue>> &arguments) override;
+  int arity() override { return 1; }
+  std::string toString() const override {
+    return "<native fn: RandomFreePos>";
+  }
+
+  std::shared_ptr<AutumnCallable> clone() override {
+    return shared_from_this();
+  }
+};
+
+/// (randomFreePositions size k): k distinct free positions of the grid, or
+/// every free one in random order when fewer are left
+class RandomFreePositions
+    : public AutumnCallable,
+      public std::enable_shared_from_this<RandomFreePositions> {
+public:
+  RandomFreePositions() {}
+  std::shared_ptr<AutumnValue>
+  call(Interpreter &interpreter,
+       const std::vector<std::shared_ptr<AutumnValue>> &arguments) override;
+  int arity() override { return 2; }
+  std::string toString() const override {
+    return "<native fn: RandomFreePositions>";
+  }
+
+  std::shared_ptr<AutumnCallable> clone() override {
+    return shared_from_this();
+  }
+};
+
+/// (randomDistinctPositions size k): k distinct positions of the grid,
+/// occupied or not
+class RandomDistinctPositions
+    : public AutumnCallable,
+      public std::enable_shared_from_this<RandomDistinctPositions> {
+public:
+  RandomDistinctPositions() {}
+  std::shared_ptr<AutumnValue>
+  call(Interpreter &interpreter,
+       const std::vector<std::shared_ptr<AutumnValue>> &arguments) override;
+  int arity() override { return 2; }
+  std::string toString() const override {
+    return "<native fn: RandomDistinctPositions>";
+  }
+
+  std::shared_ptr<AutumnCallable> clone() override {
+    return shared_from_this();
+  }
+};
+
 class AllPositions : public AutumnCallable,
                     public std::enable_shared_from_this<AllPositions> {
 public:
@@ -649,6 +763,116 @@ public:
   }
 };
 
+/// (setOf l): the set of the elements of list l
+class SetOf : public AutumnCallable,
+             public std::enable_shared_from_this<SetOf> {
+public:
+  SetOf() {}
+  std::shared_ptr<AutumnValue>
+  call(Interpreter &interpreter,
+       const std::vector<std::shared_ptr<AutumnValue>> &arguments) override;
+  int arity() override { return 1; }
+  std::string toString() const override { return "<native fn: SetOf>"; }
+  std::shared_ptr<AutumnCallable> clone() override {
+    return shared_from_this();
+  }
+};
+
+/// (mapOf keys values): the map from each of keys to the value at the same
+/// index of values; a repeated key keeps its last value
+class MapOf : public AutumnCallable,
+             public std::enable_shared_from_this<MapOf> {
+public:
+  MapOf() {}
+  std::shared_ptr<AutumnValue>
+  call(Interpreter &interpreter,
+       const std::vector<std::shared_ptr<AutumnValue>> &arguments) override;
+  int arity() override { return 2; }
+  std::string toString() const override { return "<native fn: MapOf>"; }
+  std::shared_ptr<AutumnCallable> clone() override {
+    return shared_from_this();
+  }
+};
+
+/// (insert set x) or (insert map k v): the set with x added, or the map with
+/// k bound to v
+class Insert : public AutumnCallable,
+              public std::enable_shared_from_this<Insert> {
+public:
+  Insert() {}
+  std::shared_ptr<AutumnValue>
+  call(Interpreter &interpreter,
+       const std::vector<std::shared_ptr<AutumnValue>> &arguments) override;
+  int arity() override { return 2; }
+  std::string toString() const override { return "<native fn: Insert>"; }
+  std::shared_ptr<AutumnCallable> clone() override {
+    return shared_from_this();
+  }
+};
+
+/// (remove set x) or (remove map k): the set without x, or the map without
+/// the entry for k
+class Remove : public AutumnCallable,
+              public std::enable_shared_from_this<Remove> {
+public:
+  Remove() {}
+  std::shared_ptr<AutumnValue>
+  call(Interpreter &interpreter,
+       const std::vector<std::shared_ptr<AutumnValue>> &arguments) override;
+  int arity() override { return 2; }
+  std::string toString() const override { return "<native fn: Remove>"; }
+  std::shared_ptr<AutumnCallable> clone() override {
+    return shared_from_this();
+  }
+};
+
+/// (contains set x) or (contains map k): whether x is an element, or k a key
+class Contains : public AutumnCallable,
+                public std::enable_shared_from_this<Contains> {
+public:
+  Contains() {}
+  std::shared_ptr<AutumnValue>
+  call(Interpreter &interpreter,
+       const std::vector<std::shared_ptr<AutumnValue>> &arguments) override;
+  int arity() override { return 2; }
+  std::string toString() const override { return "<native fn: Contains>"; }
+  std::shared_ptr<AutumnCallable> clone() override {
+    return shared_from_this();
+  }
+};
+
+/// (lookup map k) or (lookup map k default): the value bound to k; default,
+/// or an error, when there is none
+class Lookup : public AutumnCallable,
+              public std::enable_shared_from_this<Lookup> {
+public:
+  Lookup() {}
+  std::shared_ptr<AutumnValue>
+  call(Interpreter &interpreter,
+       const std::vector<std::shared_ptr<AutumnValue>> &arguments) override;
+  int arity() override { return 2; }
+  std::string toString() const override { return "<native fn: Lookup>"; }
+  std::shared_ptr<AutumnCallable> clone() override {
+    return shared_from_this();
+  }
+};
+
+/// (keys set) or (keys map): the elements or the keys as a list, in the
+/// collection's iteration order
+class Keys : public AutumnCallable,
+            public std::enable_shared_from_this<Keys> {
+public:
+  Keys() {}
+  std::shared_ptr<AutumnValue>
+  call(Interpreter &interpreter,
+       const std::vector<std::shared_ptr<AutumnValue>> &arguments) override;
+  int arity() override { return 1; }
+  std::string toString() const override { return "<native fn: Keys>"; }
+  std::shared_ptr<AutumnCallable> clone() override {
+    return shared_from_this();
+  }
+};
+
 } // namespace Autumn
 
 #endif // !AUTUMN_STD_LIB_HPP_
@@ -35,7 +35,17 @@ private:
 
   std::vector<std::string> definitionOrder;
 
+  // instId -> variable name, so prev() and removeObj can locate a binding
+  // without scanning every value in scope. Interned values are not indexed.
+  std::unordered_map<int, std::string> idIndex;
+
   std::unordered_set<std::pair<int, int>, pair_hash> occupiedPositions;
+  // GRID_SIZE as bound in this scope, kept in step with the binding so the
+  // grid builtins need not look it up by name; -1 unless it is a number
+  int gridSize = -1;
+  // Bumped on every change of a binding in this scope, so caches over its
+  // values can tell whether any of them moved
+  uint64_t bindingVersion = 0;
   EnvironmentType environmentType;
 
 protected:
@@ -63,6 +73,18 @@ public:
     return occupiedPositions.find({x, y}) == occupiedPositions.end();
   }
 
+  int getGridSize() const { return gridSize; }
+  uint64_t getBindingVersion() const { return bindingVersion; }
+
+  // Occupied positions with 0 <= x < width and 0 <= y < height
+  size_t countOccupied(int width, int height) {
+    size_t count = 0;
+    for (const auto &[x, y] : occupiedPositions) {
+      count += x >= 0 && x < width && y >= 0 && y < height;
+    }
+    return count;
+  }
+
   // Define a new variable in the current environment
   void define(std::string name, std::shared_ptr<AutumnValue> value);
 
@@ -89,9 +111,13 @@ public:
 
   // Assign a new value to a variable, searching enclosing environments if
   // necessary
-  void assign(const Token &name, const std::shared_ptr<AutumnValue> &value);
+  // typeChecked skips the type comparison for values the type checker has
+  // already proven to match
+  void assign(const Token &name, const std::shared_ptr<AutumnValue> &value,
+              bool typeChecked = false);
   void assign(const std::string &name,
-              const std::shared_ptr<AutumnValue> &value);
+              const std::shared_ptr<AutumnValue> &value,
+              bool typeChecked = false);
 
   void assignType(std::string name, const std::shared_ptr<AutumnType> &type);
 
@@ -170,6 +196,8 @@ public:
       values[key] = value->clone();
     }
     newEnv->values = values;
+    newEnv->gridSize = gridSize;
+    newEnv->rebuildIdIndex();
     // Deep copy update states
     std::unordered_map<std::string, bool> updateStates;
     for (const auto &[key, value] : this->updateStates) {
@@ -188,7 +216,7 @@ public:
 
   void copyAll(EnvironmentPtr from) {
     for (const auto &[key, value] : from->values) {
-      values[key] = value->clone();
+      bindValue(key, value->clone());
     }
     for (const auto &[key, value] : from->typeValues) {
       typeValues[key] = value;
@@ -207,7 +235,7 @@ public:
   void selectiveCopy(EnvironmentPtr from, std::vector<std::string> keys) {
     for (const auto &[key, value] : from->values) {
       if (std::find(keys.begin(), keys.end(), key) != keys.end()) {
-        values[key] = value->clone();
+        bindValue(key, value->clone());
       }
     }
     for (const auto &[key, value] : from->typeValues) {
@@ -233,11 +261,11 @@ public:
 
   void setEnclosing(EnvironmentPtr enclosing) { this->enclosing = enclosing; }
 
-  std::shared_ptr<AutumnValue> findId(int instId) {
-    for (const auto &[key, value] : values) {
-      if (value->getInstId() == instId) {
-        return value;
-      }
+  // Reads only, so parallel next runs may call it through prev
+  std::shared_ptr<AutumnValue> findId(int instId) const {
+    auto name = lookupId(instId);
+    if (name != nullptr) {
+      return values.at(*name);
     }
     if (enclosing != nullptr) {
       return enclosing->findId(instId);
@@ -246,12 +274,18 @@ public:
   }
 
   bool removeIdIfExist(int instId) {
-    for (const auto &[key, value] : values) {
-      if (value->getInstId() == instId) {
-        values.erase(key);
-        return true;
+    auto name = lookupId(instId);
+    if (name != nullptr) {
+      if (*name == "GRID_SIZE") {
+        gridSize = -1;
       }
+      values.erase(*name);
+      idIndex.erase(instId);
+      bindingVersion++;
+      return true;
     }
+    // Drop what is left of an entry whose value was re-identified
+    idIndex.erase(instId);
     if (enclosing != nullptr) {
       return enclosing->removeIdIfExist(instId);
     }
@@ -322,11 +356,24 @@ public:
     typeValues.clear();
     assignedTypes.clear();
     definitionOrder.clear();
+    idIndex.clear();
+    gridSize = -1;
+    bindingVersion++;
   }
 
 private:
   // Helper function to traverse to the ancestor environment at a given distance
-  EnvironmentPtr ancestor(int distance);
+  // (borrowed, so walking the chain does not touch reference counts)
+  Environment *ancestor(int distance);
+
+  // Store a binding and keep idIndex in sync with it
+  void bindValue(const std::string &name, std::shared_ptr<AutumnValue> value);
+  void rebuildIdIndex();
+  // Name bound to instId in this scope, or nullptr. Entries whose value has
+  // since been re-identified (setInstId on a shared object) are skipped;
+  // bindValue and removeIdIfExist clear them, so concurrent lookups from
+  // parallel next runs never write.
+  const std::string *lookupId(int instId) const;
 };
 } // namespace Autumn
 
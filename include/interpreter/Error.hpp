@@ -3,16 +3,42 @@
 
 #include "Token.hpp"
 #include <exception>
+#include <functional>
 #include <string>
+#include <vector>
 
 namespace Autumn {
 class Error : public std::exception {
   const std::string message;
+  // Context added by the frames the error unwinds through, innermost first.
+  // Each one receives the message so far; they only run when what() is
+  // called, so failing evaluations do not pay for printing the AST.
+  std::vector<std::function<std::string(const std::string &)>> context;
+  mutable std::string rendered;
+  mutable bool isRendered = false;
 
 public:
   Error(const std::string &message) : message(message) {}
 
-  const char *what() const noexcept override { return message.c_str(); }
+  /// Adds a layer of context; rethrow the same error with `throw;`
+  void wrap(std::function<std::string(const std::string &)> frame) {
+    context.push_back(std::move(frame));
+    isRendered = false;
+  }
+
+  const char *what() const noexcept override {
+    if (context.empty()) {
+      return message.c_str();
+    }
+    if (!isRendered) {
+      rendered = message;
+      for (const auto &frame : context) {
+        rendered = frame(rendered);
+      }
+      isRendered = true;
+    }
+    return rendered.c_str();
+  }
 };
 
 class RuntimeError : public Autumn::Error {
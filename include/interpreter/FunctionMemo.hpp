@@ -0,0 +1,80 @@
+#ifndef _AUTUMN_FUNCTION_MEMO_HPP_
+#define _AUTUMN_FUNCTION_MEMO_HPP_
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace Autumn {
+class AutumnValue;
+
+/// Bounded least-recently-used cache of a pure function's results, keyed on
+/// the structure of its arguments.
+///
+/// Arguments are keyed when they are numbers, booleans, strings, or lists
+/// and instances made of those; anything else (functions, unevaluated cell
+/// expressions) bypasses the cache. Only interned results are kept, and
+/// lists of interned values: any other number or string takes the instId of
+/// the variable it is assigned to. Each hit on a list hands out a new list
+/// sharing the cached elements, so callers never share a value they could
+/// bind to different variables.
+///
+/// A function whose first results are all fresh objects, or whose arguments
+/// never repeat, stops consulting the cache, since hashing its arguments
+/// would be wasted work.
+class FunctionMemo {
+public:
+  struct Stats {
+    size_t hits = 0;      // calls answered from the cache
+    size_t misses = 0;    // calls whose result was added to the cache
+    size_t uncached = 0;  // calls whose result could not be kept
+    size_t evictions = 0; // entries dropped to stay within capacity
+    size_t entries = 0;   // entries currently held
+    bool disabled = false;
+  };
+
+  static constexpr size_t kDefaultCapacity = 256;
+
+  explicit FunctionMemo(size_t capacity = kDefaultCapacity)
+      : capacity(capacity) {}
+
+  bool isEnabled() const { return !stats.disabled; }
+
+  /// Structural hash of the arguments; false if they cannot be keyed
+  static bool hashArguments(const std::vector<std::shared_ptr<AutumnValue>> &arguments,
+                            size_t &hash);
+
+  /// Result of an earlier call with equal arguments, or nullptr
+  std::shared_ptr<AutumnValue>
+  find(size_t hash, const std::vector<std::shared_ptr<AutumnValue>> &arguments);
+  void insert(size_t hash,
+              const std::vector<std::shared_ptr<AutumnValue>> &arguments,
+              const std::shared_ptr<AutumnValue> &result);
+
+  Stats getStats();
+
+private:
+  // Uncacheable results tolerated before the cache is turned off, if
+  // nothing was ever cached
+  static constexpr size_t kProbation = 16;
+  // Multiples of the capacity missed without a single hit before the cache
+  // is turned off
+  static constexpr size_t kColdMisses = 4;
+
+  struct Entry {
+    size_t hash;
+    std::vector<std::shared_ptr<AutumnValue>> arguments;
+    std::shared_ptr<AutumnValue> result;
+  };
+
+  size_t capacity;
+  std::list<Entry> entries; // most recently used first
+  std::unordered_multimap<size_t, std::list<Entry>::iterator> index;
+  Stats stats;
+  // Pure functions may be called from several threads at once
+  std::mutex mutex;
+};
+} // namespace Autumn
+#endif
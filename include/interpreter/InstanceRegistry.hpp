@@ -0,0 +1,50 @@
+#ifndef _AUTUMN_INSTANCE_REGISTRY_HPP_
+#define _AUTUMN_INSTANCE_REGISTRY_HPP_
+#include "AutumnValue.hpp"
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace Autumn {
+class Environment;
+
+/// The live renderable instances, those the globals hold directly or in
+/// (nested) lists, as allObjs lists them.
+///
+/// Each global's instances are kept along with the value they were found
+/// in. A query first checks the environment's binding version: while no
+/// binding changed it answers from the lists of the last query; otherwise
+/// only the globals bound to another value are searched again. Bound lists
+/// are never changed in place, so a value seen before holds the same
+/// instances.
+class InstanceRegistry {
+public:
+  /// Every live renderable instance, in the order of the globals
+  ValueList all(Environment &globals);
+  /// Those of the class named className
+  ValueList ofClass(Environment &globals, const std::string &className);
+
+  void clear();
+
+private:
+  struct Binding {
+    std::shared_ptr<AutumnValue> value;
+    ValueList instances;
+    std::unordered_map<std::string, ValueList> classInstances;
+  };
+
+  // Brings the lists up to date with globals; mutex must be held
+  void refresh(Environment &globals);
+
+  std::mutex mutex;
+  const Environment *scope = nullptr;
+  uint64_t version = 0;
+  std::unordered_map<std::string, Binding> bindings;
+  ValueList instances;
+  std::unordered_map<std::string, ValueList> classInstances;
+};
+
+} // namespace Autumn
+#endif
@@ -3,10 +3,18 @@
 #include "Environment.hpp"
 #include "Error.hpp"
 #include "Expr.hpp"
+#include "FunctionMemo.hpp"
+#include "InstanceRegistry.hpp"
 #include "State.hpp"
 #include "Stmt.hpp"
 #include "Token.hpp"
+#include "TypeChecker.hpp"
+#include "PositionTable.hpp"
+#include "StepMemo.hpp"
+#include "ValuePool.hpp"
 #include <any>
+#include <functional>
+#include <map>
 #include <memory>
 #include <stack>
 #include <string>
@@ -16,6 +24,8 @@
 #include "RandomGenerator.hpp"
 
 namespace Autumn {
+class AutumnCallable;
+
 struct SharedExprPtrHash {
   std::size_t operator()(const std::shared_ptr<Expr> &expr) const noexcept {
     return std::hash<const Expr *>()(expr.get());
@@ -45,7 +55,59 @@ class Interpreter : public Expr::Visitor, public Stmt::Visitor {
 
 
   std::shared_ptr<RandomGenerator> randomGen;
+  // Site of the call being made, which the random builtins draw for
+  int callSite = -1;
   bool verbose = false;
+  // Type check the program once in start() and skip the runtime checks on
+  // the sites the checker proved
+  bool checkedOnce = true;
+  // Fold constants and resolve aliases in the stdlib and program in start()
+  bool optimizeAst = true;
+  TypeChecker typeChecker;
+  // What the type checker found in the program passed to start()
+  std::vector<std::string> typeWarnings;
+  // Backs the values created while this interpreter runs
+  std::shared_ptr<ValuePool> valuePool = std::make_shared<ValuePool>();
+  // Interned Position values, shared by every step of this interpreter
+  PositionTable positions;
+  // Renderable instances held by the globals, for allObjs
+  InstanceRegistry instances;
+  // Whether a lambda parameter, let or field may bind GRID_SIZE, so the grid
+  // builtins must look it up in the current scope
+  bool gridSizeShadowable = true;
+  // Values of the expressions that cannot change within a step
+  StepMemo stepMemo;
+  // Cache the results of the global lambdas proven pure, across steps
+  bool memoizePureFunctions = false;
+  std::map<std::string, std::shared_ptr<FunctionMemo>> functionMemos;
+  // Let parallel builtins split their work across the TaskScheduler
+  bool parallel = true;
+  // Backs the values each worker creates, kept across parallel sections
+  std::vector<std::shared_ptr<ValuePool>> workerPools;
+  // Owner of the type proofs and positions: this interpreter, or the one a
+  // worker was made for
+  Interpreter *root = this;
+
+  // A worker of parent for one thread of a parallel section: it shares the
+  // parent's globals, state and proofs, evaluates in the parent's current
+  // environment and allocates from its own pool
+  Interpreter(Interpreter &parent, size_t index);
+
+  void attachFunctionMemos(const std::vector<std::shared_ptr<Stmt>> &stmts);
+
+  std::any evaluateCall(const std::shared_ptr<Call> &expr);
+  std::any evaluateGet(const std::shared_ptr<Get> &expr);
+  // Evaluates a call of builtin (length, foldl, map, filter or concat)
+  // whose list comes from map, filter and concat calls over a range or a
+  // list in one pass, without building the lists in between. Returns false,
+  // having run nothing with an effect, when expr is not such a call.
+  bool evaluateFused(const std::shared_ptr<Call> &expr,
+                     AutumnCallable *builtin,
+                     std::shared_ptr<AutumnValue> &result);
+
+  bool isProven(const Expr *expr) const {
+    return checkedOnce && root->typeChecker.isProven(expr);
+  }
 
 
   bool isTruthy(std::shared_ptr<AutumnValue> object) {
@@ -67,7 +129,8 @@ class Interpreter : public Expr::Visitor, public Stmt::Visitor {
     return a->isEqual(b);
   }
 
-  void init(std::string = "");
+  // Defines the builtins and returns the parsed stdlib
+  std::vector<std::shared_ptr<Stmt>> init(std::string = "");
 
   enum InterpretingState { NONE, OBJECT };
   std::stack<InterpretingState> stateStack;
@@ -75,6 +138,17 @@ class Interpreter : public Expr::Visitor, public Stmt::Visitor {
 
   std::unordered_map<std::string, std::shared_ptr<Expr>> initMap;
   std::unordered_map<std::string, std::shared_ptr<Expr>> nextMap;
+  // A stretch of nextMap, in its order, where no expression reads the
+  // variable of another; a parallel run evaluates them all before assigning
+  struct NextRun {
+    std::vector<std::pair<std::string, std::shared_ptr<Expr>>> exprs;
+    bool parallel = false;
+  };
+  // Made once the program is loaded; empty when nextMap changed since, and
+  // step() then evaluates the next expressions one at a time
+  std::vector<NextRun> nextRuns;
+  void planNextRuns(const std::vector<std::shared_ptr<Stmt>> &stmts);
+  void stepNextRun(const NextRun &run);
 
   std::vector<std::shared_ptr<Stmt>> onStmts;
   std::shared_ptr<Expr> triggeringConditionExpr = nullptr;
@@ -135,6 +209,8 @@ public:
   std::any visitTypeVariableExpr(std::shared_ptr<TypeVariable> expr) override;
   std::any visitTypeDeclExpr(std::shared_ptr<TypeDecl> expr) override;
   std::any visitListTypeExprExpr(std::shared_ptr<ListTypeExpr> expr) override;
+  std::any visitSetTypeExprExpr(std::shared_ptr<SetTypeExpr> expr) override;
+  std::any visitMapTypeExprExpr(std::shared_ptr<MapTypeExpr> expr) override;
   std::any visitListVarExprExpr(std::shared_ptr<ListVarExpr> expr) override;
   std::any visitIfExprExpr(std::shared_ptr<IfExpr> expr) override;
   std::any visitLetExpr(std::shared_ptr<Let> expr) override;
@@ -160,6 +236,60 @@ public:
 
   void restoreEnvironment() { environment = tmpEnvStack.top(); tmpEnvStack.pop(); }
 
+  // The interned Position at (x, y), or a fresh one off the table
+  std::shared_ptr<AutumnInstance> makePosition(int x, int y) {
+    return root->positions.get(x, y);
+  }
+  PositionTable &getPositions() { return root->positions; }
+  InstanceRegistry &getInstances() { return root->instances; }
+
+  // GRID_SIZE as the code being evaluated sees it
+  int getGridSize();
+
+  // Pool counters since the start of the last step
+  const ValuePool::Stats &getPoolStats() { return valuePool->getStepStats(); }
+  const ValuePool::Stats &getTotalPoolStats() {
+    return valuePool->getTotalStats();
+  }
+
+  // Step memo counters for the last step, and since start()
+  const StepMemo::Stats &getStepMemoStats() { return stepMemo.getStepStats(); }
+  const StepMemo::Stats &getTotalStepMemoStats() {
+    return stepMemo.getTotalStats();
+  }
+  size_t getStepMemoSlotCount() { return stepMemo.getSlotCount(); }
+
+  // Must be set before start()
+  void setMemoizePureFunctions(bool memoize) { memoizePureFunctions = memoize; }
+  bool getMemoizePureFunctions() { return memoizePureFunctions; }
+  // Counters of each memoized function, by name
+  std::map<std::string, FunctionMemo::Stats> getFunctionMemoStats();
+
+  void setCheckedOnce(bool checkedOnce) { this->checkedOnce = checkedOnce; }
+  bool getCheckedOnce() { return checkedOnce; }
+  const std::vector<std::string> &getTypeWarnings() { return typeWarnings; }
+
+  // Must be set before start(). Turn it off before rebinding a folded global
+  // such as GRID_SIZE through tmpExecuteStmt.
+  void setOptimizeAst(bool optimizeAst) { this->optimizeAst = optimizeAst; }
+  bool getOptimizeAst() { return optimizeAst; }
+
+  // Runs task(worker, begin, end) over consecutive slices of [0, count) as
+  // TaskScheduler tasks counted under label, and waits for all of them. Each
+  // slice gets a worker interpreter, so task may only call lambdas marked
+  // pure. An error is rethrown from the first slice that failed.
+  void parallelFor(
+      const char *label, size_t count,
+      const std::function<void(Interpreter &, size_t, size_t)> &task);
+  // Whether parallelFor may use more than the calling thread
+  bool canRunParallel();
+  void setParallel(bool parallel) { this->parallel = parallel; }
+  bool getParallel() { return parallel; }
+
+  // Steps each interpreter once, as tasks on the TaskScheduler, and
+  // rethrows the error of the first one that failed
+  static void stepAll(const std::vector<Interpreter *> &interpreters);
+
   void setVerbose(bool verbose) { this->verbose = verbose; }
   bool getVerbose() { return verbose; }
 
@@ -175,6 +305,11 @@ public:
       return randomGen;
   }
 
+  // Draws for the builtin being called, keyed by where the program calls it
+  RandomGenerator::Stream randomStream() {
+      return randomGen->stream(callSite);
+  }
+
   std::string getBackground();
   int getFrameRate();
 };
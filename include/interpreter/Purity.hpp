@@ -0,0 +1,122 @@
+#ifndef _AUTUMN_PURITY_HPP_
+#define _AUTUMN_PURITY_HPP_
+#include "Expr.hpp"
+#include "Stmt.hpp"
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace Autumn {
+class AutumnCallable;
+class Environment;
+
+/// What a native builtin's result depends on besides its arguments
+enum class BuiltinEffect {
+  PURE,         // nothing
+  HIGHER_ORDER, // nothing, but it calls the functions it is given
+  READS_GRID,   // GRID_SIZE
+  READS_INPUT,  // the frame's clicks and key presses
+  READS_PREV,   // the previous state
+  IMPURE,       // randomness, the live objects, output or in-place updates
+};
+
+BuiltinEffect builtinEffect(const AutumnCallable *callable);
+
+/// Whether a higher-order builtin may call argument `index` of `count`
+bool isCalledArgument(const AutumnCallable *callable, size_t index,
+                      size_t count);
+
+/// Calls visit on every direct sub-expression of expr
+template <typename Visit>
+void forEachChild(const std::shared_ptr<Expr> &expr, Visit &&visit) {
+  if (auto assign = std::dynamic_pointer_cast<Assign>(expr)) {
+    visit(assign->value);
+  } else if (auto binary = std::dynamic_pointer_cast<Binary>(expr)) {
+    visit(binary->left);
+    visit(binary->right);
+  } else if (auto logical = std::dynamic_pointer_cast<Logical>(expr)) {
+    visit(logical->left);
+    visit(logical->right);
+  } else if (auto unary = std::dynamic_pointer_cast<Unary>(expr)) {
+    visit(unary->right);
+  } else if (auto call = std::dynamic_pointer_cast<Call>(expr)) {
+    visit(call->callee);
+    for (const auto &argument : call->arguments) {
+      visit(argument);
+    }
+  } else if (auto get = std::dynamic_pointer_cast<Get>(expr)) {
+    visit(get->object);
+  } else if (auto set = std::dynamic_pointer_cast<Set>(expr)) {
+    visit(set->object);
+    visit(set->value);
+  } else if (auto grouping = std::dynamic_pointer_cast<Grouping>(expr)) {
+    visit(grouping->expression);
+  } else if (auto lambda = std::dynamic_pointer_cast<Lambda>(expr)) {
+    visit(lambda->right);
+  } else if (auto list = std::dynamic_pointer_cast<ListVarExpr>(expr)) {
+    for (const auto &element : list->varExprs) {
+      visit(element);
+    }
+  } else if (auto ifExpr = std::dynamic_pointer_cast<IfExpr>(expr)) {
+    visit(ifExpr->condition);
+    visit(ifExpr->thenBranch);
+    visit(ifExpr->elseBranch);
+  } else if (auto let = std::dynamic_pointer_cast<Let>(expr)) {
+    for (const auto &subexpr : let->exprs) {
+      visit(subexpr);
+    }
+  } else if (auto initNext = std::dynamic_pointer_cast<InitNext>(expr)) {
+    visit(initNext->initializer);
+    visit(initNext->nextExpr);
+  }
+}
+
+/// Names the on-clauses and next expressions of a program may rebind
+/// while it runs
+std::unordered_set<std::string>
+collectWrittenNames(const std::vector<std::shared_ptr<Stmt>> &stmts);
+
+/// Names bound anywhere in a program other than at the top level: lambda
+/// parameters, let bindings and object fields. Lambdas see their caller's
+/// bindings, so a global with one of these names may be shadowed at runtime.
+void collectBoundNames(const std::shared_ptr<Expr> &expr,
+                       std::unordered_set<std::string> &names);
+void collectBoundNames(const std::vector<std::shared_ptr<Stmt>> &stmts,
+                       std::unordered_set<std::string> &names);
+
+/// Names of the global lambdas whose result only depends on their
+/// arguments: they reach nothing but their parameters, local bindings,
+/// unchanging global constants, pure builtins and other such functions, and
+/// never call a function they were handed
+std::vector<std::string>
+findPureFunctions(const std::vector<std::shared_ptr<Stmt>> &stmts,
+                  const std::shared_ptr<Environment> &globals);
+
+/// Sets Lambda::pure on the pure global lambdas and on every lambda written
+/// in the program or in a global lambda that passes the same test on its
+/// own. A lambda reading its enclosing lambda's parameters is not pure.
+/// Also sets Lambda::effectFree on the lambdas whose calls have no effect.
+void markPureLambdas(const std::vector<std::shared_ptr<Stmt>> &stmts,
+                     const std::shared_ptr<Environment> &globals);
+
+/// What decides where a next expression may run within a step
+struct NextExprEffects {
+  // Evaluating it assigns nothing, draws no random numbers and only calls
+  // functions that do the same; it may read the state, the previous state
+  // and the inputs
+  bool effectFree = false;
+  // It calls a higher-order builtin or a global lambda, so it may take long
+  // enough to be worth a thread
+  bool loops = false;
+  // Every name it may read, through the global lambdas it names as well
+  std::unordered_set<std::string> reads;
+};
+
+std::vector<NextExprEffects>
+analyzeNextExprs(const std::vector<std::shared_ptr<Expr>> &exprs,
+                 const std::vector<std::shared_ptr<Stmt>> &stmts,
+                 const std::shared_ptr<Environment> &globals);
+} // namespace Autumn
+#endif
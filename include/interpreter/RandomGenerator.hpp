@@ -1,44 +1,102 @@
 // Add after the existing includes
 #include <cstdint>
+#include <unordered_map>
 
 namespace Autumn {
 
+/// Counter-based random numbers: every draw is a hash of (seed, step, call
+/// site, how many times the site ran this step, draw index), so a draw does
+/// not depend on what else was drawn at other sites before it. Forking an
+/// interpreter leaves each call's numbers as they were.
+///
+/// Calls are told apart by how many times their site ran, not by the index
+/// of the list element they were made for: a call has no element index to
+/// hand, and only the main interpreter ever draws. Parallel builtins and
+/// parallel next runs only take pure or effect-free code, which draws
+/// nothing, so each site runs in the same order, and draws the same
+/// numbers, with or without worker threads.
 class RandomGenerator {
-private:
-    uint32_t seed;
-    uint32_t state;
-    // Using standard minstd_rand parameters
-    static constexpr uint32_t MULTIPLIER = 48271;
-    static constexpr uint32_t MODULUS = 2147483647;  // 2^31 - 1
-
 public:
-    RandomGenerator(uint64_t initialSeed = 0) : seed(static_cast<uint32_t>(initialSeed)), state(static_cast<uint32_t>(initialSeed)) {}
-    
+    /// The draws of one call of a random builtin
+    class Stream {
+    public:
+        explicit Stream(uint64_t key) : key(key), index(0) {}
+
+        // Generate a random number between 0 and max (exclusive), unbiased
+        uint64_t next(uint64_t max) {
+            if (max == 0) return 0;
+            uint64_t draw = index++;
+            // Reject the low values that would make some results likelier;
+            // retries are keyed too, so draw i never depends on draw i-1
+            uint64_t threshold = (0 - max) % max;
+            for (uint64_t attempt = 0;; attempt++) {
+                uint64_t bits = at(draw, attempt);
+                if (bits >= threshold) return bits % max;
+            }
+        }
+
+        // Generate a random number between min and max (inclusive)
+        int64_t nextRange(int64_t min, int64_t max) {
+            if (min >= max) return min;
+            uint64_t range = static_cast<uint64_t>(max - min) + 1;
+            return min + static_cast<int64_t>(next(range));
+        }
+
+        // Generate a random double in [0, 1)
+        double nextDouble() {
+            return static_cast<double>(at(index++, 0) >> 11) * 0x1.0p-53;
+        }
+
+        // Moves past count draws without making them
+        void skip(uint64_t count) { index += count; }
+
+    private:
+        uint64_t at(uint64_t draw, uint64_t attempt) const {
+            return mix(mix(key ^ draw) ^ attempt);
+        }
+
+        uint64_t key;
+        uint64_t index;
+    };
+
+    RandomGenerator(uint64_t initialSeed = 0) : seed(initialSeed) {}
+
     void setSeed(uint64_t newSeed) {
-        seed = static_cast<uint32_t>(newSeed);
-        state = static_cast<uint32_t>(newSeed);
+        seed = newSeed;
+        step = 0;
+        calls.clear();
     }
-    
-    uint64_t getSeed() const { return static_cast<uint64_t>(seed); }
-    
-    // Generate a random number between 0 and max (exclusive)
-    uint64_t next(uint64_t max) {
-        if (max == 0) return 0;
-        state = (MULTIPLIER * state) % MODULUS;
-        return static_cast<uint64_t>(state) % max;
+
+    uint64_t getSeed() const { return seed; }
+
+    // Steps the draws are keyed by; 0 while the program initializes
+    void beginStep() {
+        step++;
+        calls.clear();
     }
-    
-    // Generate a random number between min and max (inclusive)
-    int64_t nextRange(int64_t min, int64_t max) {
-        if (min >= max) return min;
-        uint64_t range = max - min + 1;
-        return min + static_cast<int64_t>(next(range));
+    uint64_t getStep() const { return step; }
+
+    // Draws for the next call made at site, a number fixed for the program.
+    // The nth call at a site in a step gets the nth stream, so a map over a
+    // list draws for its elements in list order.
+    Stream stream(int64_t site) {
+        uint64_t call = calls[site]++;
+        uint64_t key = mix(mix(mix(seed) ^ step) ^ static_cast<uint64_t>(site));
+        return Stream(mix(key ^ call));
     }
-    
-    // Generate a random double between 0 and 1
-    double nextDouble() {
-        state = (MULTIPLIER * state) % MODULUS;
-        return static_cast<double>(state) / static_cast<double>(MODULUS);
+
+private:
+    // SplitMix64 finalizer
+    static uint64_t mix(uint64_t z) {
+        z += 0x9e3779b97f4a7c15ULL;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
     }
+
+    uint64_t seed;
+    uint64_t step = 0;
+    // Calls made at each site in this step
+    std::unordered_map<int64_t, uint64_t> calls;
 };
-}
\ No newline at end of file
+}
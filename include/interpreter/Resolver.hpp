@@ -196,6 +196,15 @@ public:
     expr->typeexpr->accept(*this);
   }
 
+  std::any visitSetTypeExprExpr(SetTypeExpr *expr) {
+    expr->typeexpr->accept(*this);
+  }
+
+  std::any visitMapTypeExprExpr(MapTypeExpr *expr) {
+    expr->keytypeexpr->accept(*this);
+    expr->valuetypeexpr->accept(*this);
+  }
+
   std::any visitListVarExprExpr(ListVarExpr *expr) {
     for (auto vExpr : expr->varExprs) {
       vExpr->accept(*this);
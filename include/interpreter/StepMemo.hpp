@@ -0,0 +1,92 @@
+#ifndef _AUTUMN_STEP_MEMO_HPP_
+#define _AUTUMN_STEP_MEMO_HPP_
+#include "Expr.hpp"
+#include "Stmt.hpp"
+#include <any>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace Autumn {
+class AutumnValue;
+class Environment;
+
+/// Per-step cache for the sub-expressions whose value cannot change while a
+/// step runs.
+///
+/// analyze() walks the on-clauses and next expressions of a program and
+/// marks the calls and field reads that only depend on the previous state
+/// (prev), the inputs of the frame (clicked, left, ...) and pure builtins
+/// over those. Textually identical expressions share a slot, so a guard
+/// repeated across on-clauses is evaluated once per step; expressions under
+/// a lambda get a slot as well, since the lambda may run many times.
+///
+/// Values read out of the previous state are kept as they are: evaluating
+/// the expression again would hand out the same object. Values computed by
+/// builtins are only kept when they are interned (small numbers, booleans,
+/// positions), so one cached object never ends up bound to two variables
+/// and given each one's instId in turn.
+class StepMemo {
+public:
+  struct Stats {
+    size_t hits = 0;     // evaluations answered from the memo
+    size_t misses = 0;   // evaluations that filled a slot
+    size_t uncached = 0; // evaluations whose value could not be kept
+  };
+
+  /// Enables the memo for the duration of one step
+  class Scope {
+  public:
+    explicit Scope(StepMemo &memo);
+    ~Scope();
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+  private:
+    StepMemo &memo;
+  };
+
+  /// Assigns slots in the program; globals resolve the builtin names
+  void analyze(const std::vector<std::shared_ptr<Stmt>> &stmts,
+               const std::shared_ptr<Environment> &globals);
+
+  bool isActive() const { return active; }
+  size_t getSlotCount() const { return kinds.size(); }
+
+  /// Returns the slot's value for this step, computing it on first use
+  template <typename Compute> std::any evaluate(int slot, Compute &&compute) {
+    if (values[slot] != nullptr) {
+      ++stepStats.hits;
+      ++totalStats.hits;
+      return values[slot];
+    }
+    std::any result = compute();
+    auto value = std::any_cast<std::shared_ptr<AutumnValue>>(&result);
+    if (value != nullptr) {
+      store(slot, *value);
+    }
+    return result;
+  }
+
+  // Counters since the start of the last step, and since analyze()
+  const Stats &getStepStats() const { return stepStats; }
+  const Stats &getTotalStats() const { return totalStats; }
+
+  enum class SlotKind {
+    PREVIOUS, // reads the previous state
+    DERIVED,  // computed from stable values
+  };
+
+private:
+  std::vector<SlotKind> kinds;
+  std::vector<std::shared_ptr<AutumnValue>> values;
+  // The nodes holding a slot, reset when the program is analyzed again
+  std::vector<std::shared_ptr<Expr>> slotted;
+  bool active = false;
+  Stats stepStats;
+  Stats totalStats;
+
+  void store(int slot, const std::shared_ptr<AutumnValue> &value);
+};
+} // namespace Autumn
+#endif
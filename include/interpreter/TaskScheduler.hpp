@@ -0,0 +1,113 @@
+#ifndef _AUTUMN_TASK_SCHEDULER_HPP_
+#define _AUTUMN_TASK_SCHEDULER_HPP_
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Autumn {
+
+/// Process-wide pool of worker threads for fork-join work. Every
+/// interpreter in the process submits to the same workers, so nested
+/// parallel builtins and many interpreters stepping at once never start
+/// more threads than the pool has.
+///
+/// Each worker keeps its own deque: it runs the tasks it spawned newest
+/// first and, once out of work, steals the oldest task of another worker.
+/// Tasks submitted from other threads go to a shared queue. A thread waiting
+/// on a TaskGroup runs pending tasks instead of blocking, which lets tasks
+/// wait on nested groups.
+class TaskScheduler {
+public:
+  /// Counters of the tasks run under one label
+  struct Stats {
+    size_t tasks = 0;       // tasks run
+    size_t stolen = 0;      // of which were taken from another worker
+    uint64_t busyNanos = 0; // time spent running them
+  };
+
+  /// A set of tasks the caller waits for together
+  class TaskGroup {
+  public:
+    /// label names the counters the group's tasks add to
+    explicit TaskGroup(const char *label);
+    /// Waits for the tasks still running
+    ~TaskGroup();
+    TaskGroup(const TaskGroup &) = delete;
+    TaskGroup &operator=(const TaskGroup &) = delete;
+
+    /// Queues task; it must not throw
+    void run(std::function<void()> task);
+    /// Returns once every task run so far has finished, running pending
+    /// tasks meanwhile
+    void wait();
+
+  private:
+    friend class TaskScheduler;
+    const char *label;
+    std::atomic<size_t> pending{0};
+  };
+
+  static TaskScheduler &instance();
+
+  /// Threads besides the callers; 0 runs every task on the thread that
+  /// waits for it. Must not be called while tasks are running.
+  void setWorkerCount(size_t count);
+  size_t getWorkerCount();
+
+  std::map<std::string, Stats> getStats();
+  void resetStats();
+
+private:
+  struct Task {
+    std::function<void()> run;
+    TaskGroup *group;
+  };
+  struct Worker {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+    std::thread thread;
+  };
+
+  TaskScheduler();
+  ~TaskScheduler();
+
+  void start(size_t count);
+  void stop();
+  void submit(Task task);
+  // Takes a task for the calling thread: its own newest, else the shared
+  // queue's oldest, else another worker's oldest
+  bool take(Task &task, bool &stolen);
+  void execute(Task &task, bool stolen);
+  void workerLoop(size_t index);
+
+  std::mutex configMutex;
+  bool started = false;
+  size_t workerCount;
+  std::vector<std::unique_ptr<Worker>> workers;
+
+  // Tasks from threads that are not workers
+  std::mutex sharedMutex;
+  std::deque<Task> shared;
+
+  // Idle workers and waiting groups sleep here until a task is queued or
+  // finishes
+  std::mutex sleepMutex;
+  std::condition_variable wakeup;
+  std::atomic<size_t> queued{0};
+  bool stopping = false;
+
+  std::mutex statsMutex;
+  std::map<std::string, Stats> stats;
+};
+
+} // namespace Autumn
+#endif
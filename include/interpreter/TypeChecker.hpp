@@ -0,0 +1,113 @@
+#ifndef _AUTUMN_TYPE_CHECKER_HPP_
+#define _AUTUMN_TYPE_CHECKER_HPP_
+#include "AutumnType.hpp"
+#include "Expr.hpp"
+#include "Stmt.hpp"
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace Autumn {
+/// Ahead-of-time type check over a parsed program.
+///
+/// Types are the runtime's AutumnType objects: the primitive singletons and
+/// interned collection types, compared as the runtime compares them. Object
+/// classes do not exist until the program runs, so the checker stands in a
+/// type known only by its name for each. Anything the checker cannot see
+/// through (lambdas, most builtins, runtime globals like click) is Unknown
+/// and left to the runtime checks.
+///
+/// Besides reporting errors, the checker records the sites it proved
+/// well-typed: object constructor calls whose arguments match the declared
+/// field types, assignments whose value matches the declared type, and
+/// initnext variables whose init and next both match. The interpreter skips
+/// the runtime validation for those sites.
+class TypeChecker : public Expr::Visitor, public Stmt::Visitor {
+public:
+  // Returns the list of type errors found, empty if the program checks. The
+  // interpreter reports them as warnings.
+  std::vector<std::string>
+  check(const std::vector<std::shared_ptr<Stmt>> &stmts);
+
+  bool isProven(const Expr *expr) const {
+    return provenExprs.find(expr) != provenExprs.end();
+  }
+  bool isProvenNext(const std::string &name) const {
+    return provenNexts.find(name) != provenNexts.end();
+  }
+
+  std::any visitAssignExpr(std::shared_ptr<Assign> expr) override;
+  std::any visitBinaryExpr(std::shared_ptr<Binary> expr) override;
+  std::any visitCallExpr(std::shared_ptr<Call> expr) override;
+  std::any visitGetExpr(std::shared_ptr<Get> expr) override;
+  std::any visitGroupingExpr(std::shared_ptr<Grouping> expr) override;
+  std::any visitLiteralExpr(std::shared_ptr<Literal> expr) override;
+  std::any visitLogicalExpr(std::shared_ptr<Logical> expr) override;
+  std::any visitSetExpr(std::shared_ptr<Set> expr) override;
+  std::any visitUnaryExpr(std::shared_ptr<Unary> expr) override;
+  std::any visitLambdaExpr(std::shared_ptr<Lambda> expr) override;
+  std::any visitVariableExpr(std::shared_ptr<Variable> expr) override;
+  std::any visitTypeVariableExpr(std::shared_ptr<TypeVariable> expr) override;
+  std::any visitTypeDeclExpr(std::shared_ptr<TypeDecl> expr) override;
+  std::any visitListTypeExprExpr(std::shared_ptr<ListTypeExpr> expr) override;
+  std::any visitSetTypeExprExpr(std::shared_ptr<SetTypeExpr> expr) override;
+  std::any visitMapTypeExprExpr(std::shared_ptr<MapTypeExpr> expr) override;
+  std::any visitListVarExprExpr(std::shared_ptr<ListVarExpr> expr) override;
+  std::any visitIfExprExpr(std::shared_ptr<IfExpr> expr) override;
+  std::any visitLetExpr(std::shared_ptr<Let> expr) override;
+  std::any visitInitNextExpr(std::shared_ptr<InitNext> expr) override;
+
+  std::any visitBlockStmt(std::shared_ptr<Block> stmt) override;
+  std::any visitObjectStmt(std::shared_ptr<Object> stmt) override;
+  std::any visitExpressionStmt(std::shared_ptr<Expression> stmt) override;
+  std::any visitOnStmtStmt(std::shared_ptr<OnStmt> stmt) override;
+
+private:
+  using TypePtr = std::shared_ptr<AutumnType>;
+
+  struct ClassInfo {
+    TypePtr type;
+    std::vector<std::string> fieldNames;
+    std::vector<TypePtr> fieldTypes;
+    bool hasInitializer; // objects take an extra origin argument
+  };
+
+  std::unordered_map<std::string, ClassInfo> classes;
+  // Stands for Cell, which is not a class the checker knows the fields of
+  TypePtr cellType;
+  std::unordered_map<std::string, TypePtr> declaredTypes;
+  // Names bound by enclosing lambdas or object fields, innermost last
+  std::vector<std::unordered_map<std::string, TypePtr>> scopes;
+  std::vector<std::string> errors;
+
+  // Declared variables whose every write is proven, so reads can rely on
+  // the declared type
+  std::unordered_set<std::string> trustedVars;
+  std::unordered_set<std::string> unprovenWrites;
+  // Object fields replaced through updateObj, which does not type check
+  std::unordered_set<std::string> rewrittenFields;
+  bool anyFieldRewritten = false;
+
+  // Keeps the checked program alive so proven addresses are not reused
+  std::vector<std::shared_ptr<Stmt>> program;
+  std::unordered_set<const Expr *> provenExprs;
+  std::unordered_set<std::string> provenNexts;
+
+  TypePtr typeOf(const std::shared_ptr<Expr> &expr);
+  TypePtr lookup(const std::string &name);
+  bool isShadowed(const std::string &name) const;
+  TypePtr fieldType(const ClassInfo &info, size_t index) const;
+  TypePtr resolveTypeExpr(const std::shared_ptr<Expr> &expr);
+  TypePtr builtinResultType(const std::string &name);
+  bool checkValue(const std::string &name, const TypePtr &valueType);
+  void defineClass(const std::string &name,
+                   std::vector<std::string> fieldNames,
+                   std::vector<TypePtr> fieldTypes, bool hasInitializer);
+
+  static bool isKnown(const TypePtr &type);
+  static bool isCollection(const TypePtr &type);
+};
+} // namespace Autumn
+#endif
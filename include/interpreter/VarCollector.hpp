@@ -71,6 +71,12 @@ class VariableCollector: public Expr::Visitor, public Stmt::Visitor {
   std::any visitListTypeExprExpr(std::shared_ptr<ListTypeExpr> expr) override{
     return std::make_shared<std::vector<std::string>>();
   }
+  std::any visitSetTypeExprExpr(std::shared_ptr<SetTypeExpr> expr) override{
+    return std::make_shared<std::vector<std::string>>();
+  }
+  std::any visitMapTypeExprExpr(std::shared_ptr<MapTypeExpr> expr) override{
+    return std::make_shared<std::vector<std::string>>();
+  }
   std::any visitListVarExprExpr(std::shared_ptr<ListVarExpr> expr) override{
     std::shared_ptr<std::vector<std::string>> varExprs = std::make_shared<std::vector<std::string>>();
     varExprs->reserve(expr->varExprs.size());
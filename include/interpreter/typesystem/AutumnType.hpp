@@ -1,17 +1,51 @@
 #ifndef __AUTUMN_TYPE_HPP__
 #define __AUTUMN_TYPE_HPP__
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
 namespace Autumn {
+class AutumnListType;
+
 class AutumnType {
+  friend class AutumnListType;
+  static std::atomic<int> nextTypeId;
+  // Unique per type object; interned types share one id per distinct type
+  const int typeId;
+  // Canonical List<this>, see AutumnListType::getInstance
+  mutable std::weak_ptr<AutumnListType> listOf;
+
 public:
+  AutumnType() : typeId(nextTypeId++) {}
+  AutumnType(const AutumnType &) = delete;
+  AutumnType &operator=(const AutumnType &) = delete;
+
   virtual std::string toString() const = 0;
   virtual ~AutumnType() = default;
   virtual bool operator==(const AutumnType &other) const {
-    return toString() == other.toString();
+    return sameType(this, &other);
+  }
+
+  int getTypeId() const { return typeId; }
+
+  // List<Unknown>, Set<Unknown> or a Map missing its key or value type,
+  // accepted wherever a collection of any element type is expected
+  virtual bool isWildcard() const { return false; }
+
+  // Type identity: equal ids, or structurally equal types that were built
+  // separately. The structural answer is memoized per pair of type objects
+  // in each thread, so repeated checks never rebuild type strings or wait on
+  // a lock.
+  static bool sameType(const AutumnType *lhs, const AutumnType *rhs);
+
+  // Whether a value of type actual may be stored where expected is declared
+  static bool isAssignable(const AutumnType *expected,
+                           const AutumnType *actual) {
+    return expected->typeId == actual->typeId || actual->isWildcard() ||
+           expected->isWildcard() || sameType(expected, actual);
   }
 };
 
@@ -71,21 +105,25 @@ public:
 class AutumnListType : public AutumnType {
 private:
   std::shared_ptr<AutumnType> elementType;
+  bool wildcard;
 
 public:
   AutumnListType(std::shared_ptr<AutumnType> elementType)
-      : elementType(elementType) {}
+      : elementType(elementType),
+        wildcard(elementType->toString() == "Unknown") {}
 
   static std::shared_ptr<AutumnListType> getInstance() {
     static std::shared_ptr<AutumnListType> instance =
-        std::make_shared<AutumnListType>(AutumnUnknownType::getInstance());
+        getInstance(AutumnUnknownType::getInstance());
     return instance;
   }
 
+  // List types are interned per element type, so two List<T> built from the
+  // same T are the same object and can be compared by pointer. Each thread
+  // remembers the ones it has asked for, and only takes the lock for a type
+  // it has not seen.
   static std::shared_ptr<AutumnListType>
-  getInstance(std::shared_ptr<AutumnType> elementType) {
-    return std::make_shared<AutumnListType>(elementType);
-  }
+  getInstance(std::shared_ptr<AutumnType> elementType);
 
   bool operator==(const AutumnType &other) const override {
     const AutumnListType *otherListType =
@@ -93,9 +131,11 @@ public:
     if (otherListType == nullptr) {
       return false;
     }
-    return elementType->toString() == otherListType->elementType->toString();
+    return sameType(elementType.get(), otherListType->elementType.get());
   }
 
+  bool isWildcard() const override { return wildcard; }
+
   std::string toString() const override {
     return "List<" + elementType->toString() + ">";
   }
@@ -103,6 +143,80 @@ public:
   std::shared_ptr<AutumnType> getElementType() const { return elementType; }
 };
 
+class AutumnSetType : public AutumnType {
+private:
+  std::shared_ptr<AutumnType> elementType;
+  bool wildcard;
+
+public:
+  AutumnSetType(std::shared_ptr<AutumnType> elementType)
+      : elementType(elementType),
+        wildcard(elementType->toString() == "Unknown") {}
+
+  static std::shared_ptr<AutumnSetType> getInstance();
+
+  // Interned per element type, like list types
+  static std::shared_ptr<AutumnSetType>
+  getInstance(std::shared_ptr<AutumnType> elementType);
+
+  bool operator==(const AutumnType &other) const override {
+    const AutumnSetType *otherSetType =
+        dynamic_cast<const AutumnSetType *>(&other);
+    if (otherSetType == nullptr) {
+      return false;
+    }
+    return sameType(elementType.get(), otherSetType->elementType.get());
+  }
+
+  bool isWildcard() const override { return wildcard; }
+
+  std::string toString() const override {
+    return "Set<" + elementType->toString() + ">";
+  }
+
+  std::shared_ptr<AutumnType> getElementType() const { return elementType; }
+};
+
+class AutumnMapType : public AutumnType {
+private:
+  std::shared_ptr<AutumnType> keyType;
+  std::shared_ptr<AutumnType> valueType;
+  bool wildcard;
+
+public:
+  AutumnMapType(std::shared_ptr<AutumnType> keyType,
+                std::shared_ptr<AutumnType> valueType)
+      : keyType(keyType), valueType(valueType),
+        wildcard(keyType->toString() == "Unknown" ||
+                 valueType->toString() == "Unknown") {}
+
+  static std::shared_ptr<AutumnMapType> getInstance();
+
+  // Interned per key and value type, like list types
+  static std::shared_ptr<AutumnMapType>
+  getInstance(std::shared_ptr<AutumnType> keyType,
+              std::shared_ptr<AutumnType> valueType);
+
+  bool operator==(const AutumnType &other) const override {
+    const AutumnMapType *otherMapType =
+        dynamic_cast<const AutumnMapType *>(&other);
+    if (otherMapType == nullptr) {
+      return false;
+    }
+    return sameType(keyType.get(), otherMapType->keyType.get()) &&
+           sameType(valueType.get(), otherMapType->valueType.get());
+  }
+
+  bool isWildcard() const override { return wildcard; }
+
+  std::string toString() const override {
+    return "Map<" + keyType->toString() + ", " + valueType->toString() + ">";
+  }
+
+  std::shared_ptr<AutumnType> getKeyType() const { return keyType; }
+  std::shared_ptr<AutumnType> getValueType() const { return valueType; }
+};
+
 class AutumnMetaType : public AutumnType {
 private:
   std::shared_ptr<AutumnType> type;
@@ -127,7 +241,7 @@ public:
     if (otherMetaType == nullptr) {
       return false;
     }
-    return type->toString() == otherMetaType->type->toString();
+    return sameType(type.get(), otherMetaType->type.get());
   }
 
   std::string toString() const override {
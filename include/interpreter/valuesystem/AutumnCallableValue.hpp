@@ -26,8 +26,6 @@ public:
 class AutumnCallableValue : public AutumnValue,
                             public std::enable_shared_from_this<AutumnCallableValue> {
 
-  std::string callableString;
-
 public:
   std::shared_ptr<AutumnCallable> callable;
   AutumnCallableValue(std::shared_ptr<AutumnCallable> callable)
@@ -36,8 +34,6 @@ public:
     if (callable == nullptr) {
       throw Error("Error Initializing AutumnCallableValue: callable is null");
     }
-    AstPrinter printer;
-    callableString = std::any_cast<std::string>(callable->toString());
   }
 
   AutumnCallableValue(int instId, std::shared_ptr<AutumnCallable> callable)
@@ -47,8 +43,6 @@ public:
       throw Error(
           "Error Initializing Cloned AutumnCallableValue: callable is null");
     }
-    AstPrinter printer;
-    callableString = std::any_cast<std::string>(callable->toString());
   }
 
   bool isEqual(std::shared_ptr<AutumnValue> other) override {
@@ -9,6 +9,7 @@
 #include "Expr.hpp"
 #include "Interpreter.hpp"
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -19,11 +20,7 @@ public:
   AutumnConstructor(std::shared_ptr<Lambda> declaration,
                std::shared_ptr<Environment> closure)
       : declaration_(std::make_shared<Lambda>(*declaration)),
-        closure_(closure) {
-    AstPrinter printer;
-    lambdaName = std::any_cast<std::string>(
-        declaration_->accept(printer)); // Get the lambda's name
-  }
+        closure_(closure) {}
 
   // Returns the number of parameters the lambda expects
   int arity() override { return declaration_->params.size(); }
@@ -42,9 +39,13 @@ public:
     for (size_t i = 0; i < declaration_->params.size(); ++i) {
       try {
         environment->define(declaration_->params[i].lexeme, arguments[i]);
-      } catch (const Error &e) {
-        throw Error("Error visiting: " + AstPrinter().print(declaration_) +
-                    "\nGot: " + e.what());
+      } catch (Error &e) {
+        auto declaration = declaration_;
+        e.wrap([declaration](const std::string &what) {
+          return "Error visiting: " + AstPrinter().print(declaration) +
+                 "\nGot: " + what;
+        });
+        throw;
       }
     }
 
@@ -57,25 +58,31 @@ public:
 
       interpreter.setEnvironment(environment->getEnclosing());
       return retVal;
-    } catch (const Error &e) {
-      std::string argumentStrings = "(";
-      for (size_t i = 0; i < declaration_->params.size(); ++i) {
-        argumentStrings +=
-            "{" + declaration_->params[i].lexeme + ": " +
-            environment->get(declaration_->params[i].lexeme)->toString() + "}";
-      }
-      argumentStrings += ")";
-      throw Error("Error calling: " + AstPrinter().print(declaration_) +
-                  // "\nwith arguments: " + argumentStrings + "\nGot: \n" +
-                  ": " +
-                  e.what());
+    } catch (Error &e) {
+      auto declaration = declaration_;
+      e.wrap([declaration](const std::string &what) {
+        return "Error calling: " + AstPrinter().print(declaration) + ": " +
+               what;
+      });
+      throw;
     }
     // std::cerr << "Lambda Res: " << retVal->toString() << std::endl;
     // Restore the previous environment
   }
 
+  const std::shared_ptr<Lambda> &getDeclaration() const {
+    return declaration_;
+  }
+
   // Returns a string representation of the lambda
-  std::string toString() const override { return std::string(lambdaName); }
+  std::string toString() const override {
+    // Printed on first use: lambdas are created on every evaluation of their
+    // expression and are rarely shown. Worker threads may print the same
+    // one, so the first print is guarded.
+    std::call_once(lambdaNameOnce,
+                   [this] { lambdaName = AstPrinter().print(declaration_); });
+    return lambdaName;
+  }
 
   // Returns a clone of the lambda
   std::shared_ptr<AutumnCallable> clone() override {
@@ -84,7 +91,8 @@ public:
   }
 
 private:
-  std::string lambdaName;
+  mutable std::once_flag lambdaNameOnce;
+  mutable std::string lambdaName;
   std::shared_ptr<Lambda> declaration_;
   std::shared_ptr<Environment> closure_;
   bool isInitializer_ = false; // Determines if the lambda is an initializer
@@ -24,8 +24,8 @@ public:
     }
     for (size_t i = 0; i < fieldnames.size(); i++) {
       if (aclass->getFieldTypes()[i] != nullptr &&
-          fieldvalues[i]->getType()->toString() !=
-              aclass->getFieldTypes()[i]->toString() && fieldvalues[i]->getType()->toString() != "List<Unknown>") {
+          !AutumnType::isAssignable(aclass->getFieldTypes()[i].get(),
+                                    fieldvalues[i]->getType().get())) {
         std::cerr << "Field type mismatch: " << fieldnames[i] << " with type "
                   << aclass->getFieldTypes()[i]->toString() << " vs "
                   << fieldvalues[i]->toString() << std::endl;
@@ -33,12 +33,15 @@ public:
                     fieldvalues[i]->getType()->toString() + " vs " +
                     aclass->getFieldTypes()[i]->toString());
       }
-      this->fields[fieldnames[i]] = fieldvalues[i];
+      this->fields[fieldnames[i]] = std::move(fieldvalues[i]);
     }
   }
 
+  // The first trustedFields values were proven to match their field types by
+  // the type checker and are not checked again
   AutumnInstance(std::shared_ptr<AutumnClass> aclass,
-                 std::vector<std::shared_ptr<AutumnValue>> fieldvalues)
+                 std::vector<std::shared_ptr<AutumnValue>> fieldvalues,
+                 size_t trustedFields = 0)
       : AutumnValue(std::any(), aclass), aclass(aclass) {
     const std::vector<std::string> &fieldnames = aclass->getFieldNames();
     if (fieldnames.size() != fieldvalues.size()) {
@@ -48,11 +51,9 @@ public:
     }
 
     for (size_t i = 0; i < fieldnames.size(); i++) {
-      if (aclass->getFieldTypes()[i] != nullptr &&
-          fieldvalues[i]->getType()->toString() !=
-              aclass->getFieldTypes()[i]->toString() && fieldvalues[i]->getType()->toString() != "List<Unknown>"
-              && aclass->getFieldTypes()[i]->toString() != "List<Unknown>"
-              ) {
+      if (i >= trustedFields && aclass->getFieldTypes()[i] != nullptr &&
+          !AutumnType::isAssignable(aclass->getFieldTypes()[i].get(),
+                                    fieldvalues[i]->getType().get())) {
         std::cerr << "Field type mismatch: " << fieldnames[i] << " with type "
                   << aclass->getFieldTypes()[i]->toString() << " vs "
                   << fieldvalues[i]->toString() << std::endl;
@@ -60,7 +61,7 @@ public:
                     fieldvalues[i]->getType()->toString() + " vs " +
                     aclass->getFieldTypes()[i]->toString());
       }
-      this->fields[fieldnames[i]] = fieldvalues[i];
+      this->fields[fieldnames[i]] = std::move(fieldvalues[i]);
     }
   }
 
@@ -69,10 +70,8 @@ public:
     int i = 0;
     for (const auto &key : aclass->getFieldNames()) {
       std::shared_ptr<AutumnValue> value = fields.at(key);
-      if (value->getType()->toString() !=
-          aclass->getFieldTypes()[i]->toString() && aclass->getFieldTypes()[i]->toString() != "List<Unknown>"
-          && value->getType()->toString() != "List<Unknown>"
-          ) {
+      if (!AutumnType::isAssignable(aclass->getFieldTypes()[i].get(),
+                                    value->getType().get())) {
         throw Error("Field type mismatch in toString: " + key + " with type " +
                     aclass->getFieldTypes()[i]->toString() + " vs " +
                     value->toString() + " in " + aclass->name);
@@ -142,6 +141,10 @@ public:
   }
 
   void set(const std::string &name, std::shared_ptr<AutumnValue> value) {
+    if (internOwner != nullptr) {
+      throw Error("Cannot set field '" + name + "' of immutable " +
+                  aclass->name);
+    }
     std::string normalizedName = normalizeName(name);
     if (this->fields.find(normalizedName) != fields.end()) {
       this->fields[normalizedName] = value;
@@ -157,11 +160,18 @@ public:
   }
 
   bool isEqual(std::shared_ptr<AutumnValue> other) override {
+    if (other.get() == this) {
+      return true;
+    }
     std::shared_ptr<AutumnInstance> otherInstance =
         std::dynamic_pointer_cast<AutumnInstance>(other);
     if (otherInstance == nullptr) {
       return false;
     }
+    // The same table never holds two equal values
+    if (internOwner != nullptr && internOwner == otherInstance->internOwner) {
+      return false;
+    }
     // Else, check matching in terms of fields
     if (fields.size() != otherInstance->fields.size()) {
       return false;
@@ -195,7 +205,7 @@ public:
       fieldvalues.push_back(fields[key]->clone());
     }
 
-    return std::make_shared<AutumnInstance>(aclass, fieldvalues);
+    return makeValue<AutumnInstance>(aclass, std::move(fieldvalues));
   }
 
   std::shared_ptr<AutumnClass> getClass() { return aclass; }
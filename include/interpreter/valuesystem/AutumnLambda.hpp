@@ -7,8 +7,10 @@
 #include "Environment.hpp"
 #include "Error.hpp"
 #include "Expr.hpp"
+#include "FunctionMemo.hpp"
 #include "Interpreter.hpp"
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -20,19 +22,56 @@ public:
   AutumnLambda(std::shared_ptr<Lambda> declaration,
                std::shared_ptr<Environment> closure)
       : declaration_(std::make_shared<Lambda>(*declaration)),
-        closure_(closure) {
-    AstPrinter printer;
-    lambdaName = std::any_cast<std::string>(
-        declaration_->accept(printer)); // Get the lambda's name
-  }
+        closure_(closure) {}
 
   // Returns the number of parameters the lambda expects
   int arity() override { return declaration_->params.size(); }
 
-  // Executes the lambda with the given arguments
+  // Executes the lambda with the given arguments, answering from its memo
+  // when it has one
   std::shared_ptr<AutumnValue>
   call(Interpreter &interpreter,
        const std::vector<std::shared_ptr<AutumnValue>> &arguments) override {
+    size_t key;
+    if (memo_ != nullptr && memo_->isEnabled() &&
+        FunctionMemo::hashArguments(arguments, key)) {
+      if (auto cached = memo_->find(key, arguments)) {
+        return cached;
+      }
+      std::shared_ptr<AutumnValue> result = invoke(interpreter, arguments);
+      memo_->insert(key, arguments, result);
+      return result;
+    }
+    return invoke(interpreter, arguments);
+  }
+
+  const std::shared_ptr<Lambda> &getDeclaration() const {
+    return declaration_;
+  }
+
+  // Only set on lambdas whose result depends on nothing but their arguments
+  void setMemo(std::shared_ptr<FunctionMemo> memo) { memo_ = std::move(memo); }
+  const std::shared_ptr<FunctionMemo> &getMemo() const { return memo_; }
+
+  // Returns a string representation of the lambda
+  std::string toString() const override {
+    // Printed on first use: lambdas are created on every evaluation of their
+    // expression and are rarely shown. Worker interpreters share lambdas, so
+    // the first print is guarded.
+    std::call_once(lambdaNameOnce,
+                   [this] { lambdaName = AstPrinter().print(declaration_); });
+    return lambdaName;
+  }
+
+  // Returns a clone of the lambda
+  std::shared_ptr<AutumnCallable> clone() override {
+    return shared_from_this();
+  }
+
+private:
+  std::shared_ptr<AutumnValue>
+  invoke(Interpreter &interpreter,
+         const std::vector<std::shared_ptr<AutumnValue>> &arguments) {
     // std::cerr << "Lambda call: " << lambdaName << std::endl;
     // Create a new environment for the lambda's execution
     auto environment =
@@ -43,9 +82,13 @@ public:
     for (size_t i = 0; i < declaration_->params.size(); ++i) {
       try {
         environment->define(declaration_->params[i].lexeme, arguments[i]);
-      } catch (const Error &e) {
-        throw Error("Error visiting: " + AstPrinter().print(declaration_) +
-                    "\nGot: " + e.what());
+      } catch (Error &e) {
+        auto declaration = declaration_;
+        e.wrap([declaration](const std::string &what) {
+          return "Error visiting: " + AstPrinter().print(declaration) +
+                 "\nGot: " + what;
+        });
+        throw;
       }
     }
 
@@ -58,35 +101,23 @@ public:
 
       interpreter.setEnvironment(environment->getEnclosing());
       return retVal;
-    } catch (const Error &e) {
-      std::string argumentStrings = "(";
-      for (size_t i = 0; i < declaration_->params.size(); ++i) {
-        argumentStrings +=
-            "{" + declaration_->params[i].lexeme + ": " +
-            environment->get(declaration_->params[i].lexeme)->toString() + "}";
-      }
-      argumentStrings += ")";
-      throw Error("Error calling: " + AstPrinter().print(declaration_) +
-                  // "\nwith arguments: " + argumentStrings + "\nGot: \n" +
-                  ": " +
-                  e.what());
+    } catch (Error &e) {
+      auto declaration = declaration_;
+      e.wrap([declaration](const std::string &what) {
+        return "Error calling: " + AstPrinter().print(declaration) + ": " +
+               what;
+      });
+      throw;
     }
     // std::cerr << "Lambda Res: " << retVal->toString() << std::endl;
     // Restore the previous environment
   }
 
-  // Returns a string representation of the lambda
-  std::string toString() const override { return std::string(lambdaName); }
-
-  // Returns a clone of the lambda
-  std::shared_ptr<AutumnCallable> clone() override {
-    return shared_from_this();
-  }
-
-private:
-  std::string lambdaName;
+  mutable std::once_flag lambdaNameOnce;
+  mutable std::string lambdaName;
   std::shared_ptr<Lambda> declaration_;
   std::shared_ptr<Environment> closure_;
+  std::shared_ptr<FunctionMemo> memo_;
   bool isInitializer_ = false; // Determines if the lambda is an initializer
 };
 
@@ -3,7 +3,12 @@
 
 #include "AutumnType.hpp"
 #include "Error.hpp"
+#include "PersistentHashMap.hpp"
+#include "PersistentVector.hpp"
+#include "ValuePool.hpp"
 #include <any>
+#include <atomic>
+#include <cstddef>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -30,7 +35,8 @@ using AutumnValueVariant = ValueVariant<
 // TODO: Implement this with Autumn Values
 */
 class AutumnValue {
-  static int instCount;
+  // Values may be created on the worker threads of parallel builtins
+  static std::atomic<int> instCount;
 
 protected:
   int instId;
@@ -38,12 +44,16 @@ protected:
       : instId(instId), value(value), type(type) {}
 
   std::any value;
-  std::shared_ptr<AutumnType> type;
+  // mutable so lists can fill in their element type lazily
+  mutable std::shared_ptr<AutumnType> type;
+  // Cache or table that shares this value, if any. Interned values are
+  // immutable and carry no variable identity (instId).
+  const void *internOwner = nullptr;
 
 public:
   AutumnValue(std::any value, std::shared_ptr<AutumnType> type)
       : value(value), type(type) {
-    instId = instCount++;
+    instId = instCount.fetch_add(1, std::memory_order_relaxed);
   } // This is for inner class definition
   virtual std::string toString() const = 0;
   virtual bool isEqual(std::shared_ptr<AutumnValue> other) {
@@ -54,11 +64,18 @@ public:
   virtual std::shared_ptr<AutumnValue> clone() = 0;
   int getInstId() { return instId; }
   void setInstId(int instId) { this->instId = instId; }
+  // Every value created from now on gets an id of at least this
+  static int peekInstId() { return instCount.load(std::memory_order_relaxed); }
+  void renewInstId() {
+    instId = instCount.fetch_add(1, std::memory_order_relaxed);
+  }
+  void markInterned(const void *owner) { internOwner = owner; }
+  bool isInterned() const { return internOwner != nullptr; }
   std::any getValue() { return value; }
   void setValue(std::any value) { this->value = value; }
   // copy
   virtual std::shared_ptr<AutumnValue> copy() = 0;
-  std::shared_ptr<AutumnType> getType() { return type; }
+  virtual std::shared_ptr<AutumnType> getType() { return type; }
 };
 
 class AutumnNumber final: public AutumnValue,
@@ -69,6 +86,8 @@ public:
       : AutumnValue(instId, value, AutumnNumberType::getInstance()) {}
   AutumnNumber(int value)
       : AutumnValue(value, AutumnNumberType::getInstance()) {}
+  /// Shared value for small integers, a fresh one otherwise
+  static std::shared_ptr<AutumnNumber> of(int value);
   std::string toString() const override {
     return "(" + std::to_string(std::any_cast<int>(value)) + ": N)";
   }
@@ -95,7 +114,7 @@ public:
   }
 
   std::shared_ptr<AutumnValue> copy() override {
-    return std::make_shared<AutumnNumber>(std::any_cast<int>(value));
+    return makeValue<AutumnNumber>(std::any_cast<int>(value));
   }
 };
 ;
@@ -139,6 +158,8 @@ public:
       : AutumnValue(instId, value, AutumnBoolType::getInstance()) {}
   AutumnBool(std::any value)
       : AutumnValue(value, AutumnBoolType::getInstance()) {}
+  /// Shared true/false values
+  static std::shared_ptr<AutumnBool> of(bool value);
   std::string toString() const override {
     return std::string("(") + (std::any_cast<bool>(value) ? "true" : "false") +
            ": " + type->toString() + ")";
@@ -154,48 +175,57 @@ public:
   AutumnBool(AutumnBool &other) : AutumnValue(other) {}
 
   std::shared_ptr<AutumnValue> copy() override {
-    return std::make_shared<AutumnBool>(value);
+    return makeValue<AutumnBool>(value);
   }
 };
 
+using ValueList = PersistentVector<std::shared_ptr<AutumnValue>>;
+
 class AutumnList final: public AutumnValue,
                    public std::enable_shared_from_this<AutumnList> {
 public:
-  static std::shared_ptr<AutumnType>
-  inferType(const std::vector<std::shared_ptr<AutumnValue>> &values) {
+  template <typename Container>
+  static std::shared_ptr<AutumnType> inferType(const Container &values) {
     std::shared_ptr<AutumnType> type = AutumnUnknownType::getInstance();
-    for (size_t i = 0; i < values.size(); i++) {
-      if (values[i]->getType() == AutumnUnknownType::getInstance()) {
+    for (const auto &value : values) {
+      if (value->getType() == AutumnUnknownType::getInstance()) {
         continue;
       }
       if (type == AutumnUnknownType::getInstance()) {
-        type = values[i]->getType();
-      } else if (type != values[i]->getType()) {
+        type = value->getType();
+      } else if (type != value->getType()) {
         return AutumnUnknownType::getInstance();
       }
     }
     return AutumnListType::getInstance(type);
   }
 
+  // Lists built from existing values infer their element type on first
+  // getType() rather than scanning every element up front.
   AutumnList(int instId,
              std::shared_ptr<std::vector<std::shared_ptr<AutumnValue>>> values)
-      : AutumnValue(instId, values, inferType(*values)) {}
+      : AutumnValue(instId, std::make_shared<ValueList>(*values), nullptr) {}
 
   AutumnList(std::shared_ptr<std::vector<std::shared_ptr<AutumnValue>>> values)
-      : AutumnValue(values, inferType(*values)) {}
+      : AutumnValue(std::make_shared<ValueList>(*values), nullptr) {}
+
+  AutumnList(const ValueList &values)
+      : AutumnValue(std::make_shared<ValueList>(values), nullptr) {}
+
+  // Shares the elements of values; type is trusted rather than re-inferred.
+  // A null type falls back to lazy inference.
+  AutumnList(const ValueList &values, std::shared_ptr<AutumnType> type)
+      : AutumnValue(std::make_shared<ValueList>(values), type) {}
 
   AutumnList()
-      : AutumnValue(std::make_shared<std::vector<std::shared_ptr<AutumnValue>>>(
-                        std::vector<std::shared_ptr<AutumnValue>>({})),
+      : AutumnValue(std::make_shared<ValueList>(),
                     AutumnListType::getInstance()) {}
 
   std::string toString() const override {
     std::string result = "([";
-    std::shared_ptr<std::vector<std::shared_ptr<AutumnValue>>> plist;
+    std::shared_ptr<ValueList> plist;
     try {
-      plist = std::any_cast<
-          std::shared_ptr<std::vector<std::shared_ptr<AutumnValue>>>>(value);
-      result.reserve(2 + (plist->size() * 20) + (plist->size() - 1) * 2 + 3 + type->toString().length());
+      plist = std::any_cast<std::shared_ptr<ValueList>>(value);
     } catch (const std::bad_any_cast &e) {
       std::cerr << "Error in toString(): bad_any_cast for 'value'."
                 << std::endl;
@@ -206,9 +236,11 @@ public:
       std::cerr << "Error in toString(): 'plist' is null." << std::endl;
       return "([Null List])";
     }
+    auto type = getListType();
+    result.reserve(2 + (plist->size() * 20) + (plist->size() - 1) * 2 + 3 + type->toString().length());
 
-    for (size_t i = 0; i < plist->size(); i++) {
-      auto &element = (*plist)[i];
+    size_t i = 0;
+    for (const auto &element : *plist) {
       if (!element) {
         std::cerr << "WARNING: Element at index " << i << " is null."
                   << std::endl;
@@ -225,6 +257,7 @@ public:
       if (i != plist->size() - 1) {
         result += ", ";
       }
+      i++;
     }
     result += "] :" + (type ? type->toString() : "Unknown Type") + ")";
     return result;
@@ -235,10 +268,18 @@ public:
     return shared_from_this();
   }
 
-  std::shared_ptr<std::vector<std::shared_ptr<AutumnValue>>> getValues() {
+  std::shared_ptr<AutumnType> getType() override { return getListType(); }
+
+  // Element type if it is already known, without forcing inference
+  std::shared_ptr<AutumnType> getKnownType() const { return type; }
+
+  // Infers the element types of this list and of the lists in its elements
+  // and their fields, so threads sharing them afterwards only read them
+  void settleTypes();
+
+  std::shared_ptr<ValueList> getValues() {
     try {
-      return std::any_cast<
-          std::shared_ptr<std::vector<std::shared_ptr<AutumnValue>>>>(value);
+      return std::any_cast<std::shared_ptr<ValueList>>(value);
     } catch (std::bad_any_cast &e) {
       std::cerr << "AutumnList::getValues Error: " << e.what() << std::endl;
       throw e;
@@ -246,31 +287,122 @@ public:
   }
 
   void add(std::shared_ptr<AutumnValue> elem);
+  // Replace the element at index, with the same element type check as add
+  void set(size_t index, std::shared_ptr<AutumnValue> elem);
   bool isTruthy() override {
     // If value is nullptr, it's also false
     if (value.has_value() == false) {
       return false;
     }
-    if (std::any_cast<
-            std::shared_ptr<std::vector<std::shared_ptr<AutumnValue>>>>(value)
-            ->size() == 0) {
+    if (std::any_cast<std::shared_ptr<ValueList>>(value)->empty()) {
       return false;
     }
     return true;
   }
 
   std::shared_ptr<AutumnValue> copy() override {
-    auto pList = std::any_cast<
-        std::shared_ptr<std::vector<std::shared_ptr<AutumnValue>>>>(value);
-    std::vector<std::shared_ptr<AutumnValue>> newlist;
-    newlist.reserve(pList->size());
-    for (size_t i = 0; i < pList->size(); i++) {
-      newlist.push_back((*pList)[i]->copy());
+    auto pList = std::any_cast<std::shared_ptr<ValueList>>(value);
+    ValueList newlist;
+    for (const auto &elem : *pList) {
+      newlist.push_back(elem->copy());
+    }
+    return makeValue<AutumnList>(newlist);
+  }
+
+private:
+  std::shared_ptr<AutumnType> getListType() const {
+    if (type == nullptr) {
+      type = inferType(*std::any_cast<std::shared_ptr<ValueList>>(value));
     }
-    auto pNewList =
-        std::make_shared<std::vector<std::shared_ptr<AutumnValue>>>(newlist);
-    return std::make_shared<AutumnList>(pNewList);
+    return type;
+  }
+  void checkElementType(const std::shared_ptr<AutumnValue> &elem);
+};
+
+/// Hash and equality of set elements and map keys: numbers, strings and
+/// positions, compared by value
+struct ValueKeyHash {
+  size_t operator()(const std::shared_ptr<AutumnValue> &key) const;
+};
+
+struct ValueKeyEqual {
+  bool operator()(const std::shared_ptr<AutumnValue> &lhs,
+                  const std::shared_ptr<AutumnValue> &rhs) const;
+};
+
+/// Whether value may be a set element or a map key
+bool isValueKey(const std::shared_ptr<AutumnValue> &value);
+
+using ValueSet = PersistentHashMap<std::shared_ptr<AutumnValue>, std::nullptr_t,
+                                   ValueKeyHash, ValueKeyEqual>;
+using ValueMap =
+    PersistentHashMap<std::shared_ptr<AutumnValue>,
+                      std::shared_ptr<AutumnValue>, ValueKeyHash, ValueKeyEqual>;
+
+class AutumnSet final : public AutumnValue,
+                        public std::enable_shared_from_this<AutumnSet> {
+public:
+  // type is trusted to be Set<T> for the type T of every element, or
+  // Set<Unknown>
+  AutumnSet(const ValueSet &values, std::shared_ptr<AutumnType> type)
+      : AutumnValue(std::make_shared<ValueSet>(values), type) {}
+
+  AutumnSet()
+      : AutumnValue(std::make_shared<ValueSet>(),
+                    AutumnSetType::getInstance()) {}
+
+  std::string toString() const override;
+  bool isEqual(std::shared_ptr<AutumnValue> other) override;
+  bool isTruthy() override { return !getValues()->empty(); }
+
+  std::shared_ptr<AutumnValue> clone() override {
+    return shared_from_this();
+  }
+
+  // Sets are never changed in place, so a copy shares the elements
+  std::shared_ptr<AutumnValue> copy() override {
+    return makeValue<AutumnSet>(*getValues(), type);
+  }
+
+  std::shared_ptr<ValueSet> getValues() const {
+    return std::any_cast<std::shared_ptr<ValueSet>>(value);
+  }
+
+  // The elements, in iteration order
+  ValueList toList() const;
+};
+
+class AutumnMap final : public AutumnValue,
+                        public std::enable_shared_from_this<AutumnMap> {
+public:
+  // type is trusted to be Map<K, V> for the types of every key and value,
+  // with Unknown where they differ
+  AutumnMap(const ValueMap &values, std::shared_ptr<AutumnType> type)
+      : AutumnValue(std::make_shared<ValueMap>(values), type) {}
+
+  AutumnMap()
+      : AutumnValue(std::make_shared<ValueMap>(),
+                    AutumnMapType::getInstance()) {}
+
+  std::string toString() const override;
+  bool isEqual(std::shared_ptr<AutumnValue> other) override;
+  bool isTruthy() override { return !getValues()->empty(); }
+
+  std::shared_ptr<AutumnValue> clone() override {
+    return shared_from_this();
   }
+
+  // Maps are never changed in place, so a copy shares the entries
+  std::shared_ptr<AutumnValue> copy() override {
+    return makeValue<AutumnMap>(*getValues(), type);
+  }
+
+  std::shared_ptr<ValueMap> getValues() const {
+    return std::any_cast<std::shared_ptr<ValueMap>>(value);
+  }
+
+  // The keys, in iteration order
+  ValueList keys() const;
 };
 
 class AutumnNull final: public AutumnValue,
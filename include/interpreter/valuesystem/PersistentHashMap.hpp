@@ -0,0 +1,229 @@
+#ifndef __AUTUMN_PERSISTENT_HASH_MAP_HPP__
+#define __AUTUMN_PERSISTENT_HASH_MAP_HPP__
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Autumn {
+
+/// Copy-on-write hash map backed by a hash array mapped trie. Each level
+/// consumes five bits of the key's hash, and a node only stores the slots
+/// in use, indexed by a bitmap. Copying a PersistentHashMap is O(1) and
+/// shares all nodes; insert and erase clone the nodes on the path they
+/// touch, so lookups and updates cost O(log32 n) and leave other versions
+/// intact. Nodes that are not shared are mutated in place, the same as in
+/// PersistentVector.
+///
+/// Iteration follows the hash bits, so it is the same for equal contents
+/// but unrelated to insertion order.
+///
+/// Not thread-safe for concurrent mutation of the same version; concurrent
+/// reads of a version nobody is writing are fine.
+template <typename K, typename V, typename Hash, typename Equal>
+class PersistentHashMap {
+  static constexpr unsigned kBits = 5;
+  static constexpr size_t kMask = (1u << kBits) - 1;
+  // Below this depth keys whose hashes are equal share a plain list
+  static constexpr unsigned kHashBits = sizeof(size_t) * CHAR_BIT;
+
+  struct Node;
+  using NodePtr = std::shared_ptr<Node>;
+
+  // A key and its value, or a subtree for the keys sharing this slot
+  struct Entry {
+    size_t hash = 0;
+    K key{};
+    V value{};
+    NodePtr child;
+  };
+
+  struct Node {
+    uint32_t bitmap = 0; // slots in use; entries are kept in slot order
+    std::vector<Entry> entries;
+  };
+
+  NodePtr root;
+  size_t length = 0;
+
+public:
+  using key_type = K;
+  using mapped_type = V;
+  using size_type = size_t;
+
+  size_t size() const { return length; }
+  bool empty() const { return length == 0; }
+
+  /// The value stored for key, or null
+  const V *find(const K &key) const {
+    size_t hash = Hash()(key);
+    const Node *node = root.get();
+    for (unsigned shift = 0; node != nullptr; shift += kBits) {
+      if (shift >= kHashBits) {
+        for (const auto &entry : node->entries) {
+          if (Equal()(entry.key, key)) {
+            return &entry.value;
+          }
+        }
+        return nullptr;
+      }
+      uint32_t bit = slotBit(hash, shift);
+      if ((node->bitmap & bit) == 0) {
+        return nullptr;
+      }
+      const Entry &entry = node->entries[indexOf(node, bit)];
+      if (entry.child == nullptr) {
+        return entry.hash == hash && Equal()(entry.key, key) ? &entry.value
+                                                              : nullptr;
+      }
+      node = entry.child.get();
+    }
+    return nullptr;
+  }
+
+  bool contains(const K &key) const { return find(key) != nullptr; }
+
+  /// Stores value for key, replacing the value already there. Returns
+  /// whether key is new.
+  bool insert(const K &key, const V &value) {
+    if (root == nullptr) {
+      root = std::make_shared<Node>();
+    }
+    bool added = insertAt(root, 0, Hash()(key), key, value);
+    if (added) {
+      ++length;
+    }
+    return added;
+  }
+
+  /// Removes key. Returns whether it was there.
+  bool erase(const K &key) {
+    if (!contains(key)) {
+      return false;
+    }
+    eraseAt(root, 0, Hash()(key), key);
+    if (--length == 0) {
+      clear();
+    }
+    return true;
+  }
+
+  void clear() {
+    root = nullptr;
+    length = 0;
+  }
+
+  /// Calls visit(key, value) on every entry
+  template <typename Visit> void forEach(Visit &&visit) const {
+    if (root != nullptr) {
+      visitNode(root.get(), visit);
+    }
+  }
+
+private:
+  static Node *detach(NodePtr &node) {
+    if (node.use_count() != 1) {
+      node = std::make_shared<Node>(*node);
+    }
+    return node.get();
+  }
+
+  static uint32_t slotBit(size_t hash, unsigned shift) {
+    return 1u << ((hash >> shift) & kMask);
+  }
+
+  static size_t indexOf(const Node *node, uint32_t bit) {
+    return popcount(node->bitmap & (bit - 1));
+  }
+
+  static size_t popcount(uint32_t bits) {
+    size_t count = 0;
+    for (; bits != 0; bits &= bits - 1) {
+      count++;
+    }
+    return count;
+  }
+
+  static bool insertAt(NodePtr &node, unsigned shift, size_t hash,
+                       const K &key, const V &value) {
+    Node *n = detach(node);
+    if (shift >= kHashBits) {
+      for (auto &entry : n->entries) {
+        if (Equal()(entry.key, key)) {
+          entry.value = value;
+          return false;
+        }
+      }
+      n->entries.push_back({hash, key, value, nullptr});
+      return true;
+    }
+    uint32_t bit = slotBit(hash, shift);
+    size_t index = indexOf(n, bit);
+    if ((n->bitmap & bit) == 0) {
+      n->entries.insert(n->entries.begin() + index,
+                        Entry{hash, key, value, nullptr});
+      n->bitmap |= bit;
+      return true;
+    }
+    Entry &entry = n->entries[index];
+    if (entry.child != nullptr) {
+      return insertAt(entry.child, shift + kBits, hash, key, value);
+    }
+    if (entry.hash == hash && Equal()(entry.key, key)) {
+      entry.value = value;
+      return false;
+    }
+    // Two keys share this slot: move both one level down
+    NodePtr child = std::make_shared<Node>();
+    insertAt(child, shift + kBits, entry.hash, entry.key, entry.value);
+    insertAt(child, shift + kBits, hash, key, value);
+    entry = Entry{0, K{}, V{}, child};
+    return true;
+  }
+
+  // key must be present
+  static void eraseAt(NodePtr &node, unsigned shift, size_t hash,
+                      const K &key) {
+    Node *n = detach(node);
+    if (shift >= kHashBits) {
+      for (size_t i = 0; i < n->entries.size(); i++) {
+        if (Equal()(n->entries[i].key, key)) {
+          n->entries.erase(n->entries.begin() + i);
+          return;
+        }
+      }
+      return;
+    }
+    uint32_t bit = slotBit(hash, shift);
+    size_t index = indexOf(n, bit);
+    Entry &entry = n->entries[index];
+    if (entry.child != nullptr) {
+      eraseAt(entry.child, shift + kBits, hash, key);
+      const Node *child = entry.child.get();
+      // A subtree left with one key folds back into this slot
+      if (child->entries.size() == 1 && child->entries[0].child == nullptr) {
+        Entry last = child->entries[0];
+        entry = last;
+      }
+      return;
+    }
+    n->entries.erase(n->entries.begin() + index);
+    n->bitmap &= ~bit;
+  }
+
+  template <typename Visit>
+  static void visitNode(const Node *node, Visit &visit) {
+    for (const auto &entry : node->entries) {
+      if (entry.child != nullptr) {
+        visitNode(entry.child.get(), visit);
+      } else {
+        visit(entry.key, entry.value);
+      }
+    }
+  }
+};
+
+} // namespace Autumn
+#endif
@@ -0,0 +1,365 @@
+#ifndef __AUTUMN_PERSISTENT_VECTOR_HPP__
+#define __AUTUMN_PERSISTENT_VECTOR_HPP__
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace Autumn {
+
+/// Copy-on-write vector backed by a chunked tree with per-node size tables
+/// (a relaxed radix tree). Copying a PersistentVector is O(1) and shares all
+/// nodes; mutating a copy only clones the nodes on the path it touches, so
+/// push_back, set and erase are O(log n) and leave other versions intact.
+/// Nodes that are not shared are mutated in place, which makes building a
+/// fresh list with push_back as cheap as with std::vector.
+///
+/// Not thread-safe for concurrent mutation of the same version; concurrent
+/// reads of a version nobody is writing are fine.
+template <typename T> class PersistentVector {
+  static constexpr size_t kBranch = 32;
+
+  struct Node {
+    bool leaf;
+    std::vector<T> items;                        // leaf only
+    std::vector<std::shared_ptr<Node>> children; // internal only
+    std::vector<size_t> sizes; // sizes[i] = elements in children[0..i]
+
+    explicit Node(bool leaf) : leaf(leaf) {}
+    size_t count() const {
+      if (leaf) {
+        return items.size();
+      }
+      return sizes.empty() ? 0 : sizes.back();
+    }
+  };
+  using NodePtr = std::shared_ptr<Node>;
+
+  NodePtr root;
+  size_t height = 0; // 0 when root is a leaf
+  size_t length = 0;
+
+public:
+  using value_type = T;
+  using size_type = size_t;
+
+  class const_iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T *;
+    using reference = const T &;
+
+    const_iterator() = default;
+    const_iterator(const PersistentVector *vec, size_t index)
+        : vec(vec), index(index) {
+      seek();
+    }
+
+    reference operator*() const { return leaf[index - leafStart]; }
+    pointer operator->() const { return &leaf[index - leafStart]; }
+    const_iterator &operator++() {
+      ++index;
+      if (index >= leafEnd) {
+        seek();
+      }
+      return *this;
+    }
+    const_iterator operator++(int) {
+      const_iterator tmp = *this;
+      ++(*this);
+      return tmp;
+    }
+    bool operator==(const const_iterator &other) const {
+      return index == other.index;
+    }
+    bool operator!=(const const_iterator &other) const {
+      return index != other.index;
+    }
+
+  private:
+    void seek() {
+      if (vec == nullptr || index >= vec->length) {
+        leafStart = leafEnd = index;
+        return;
+      }
+      const Node *leafNode = vec->leafFor(index, leafStart);
+      leaf = leafNode->items.data();
+      leafEnd = leafStart + leafNode->items.size();
+    }
+
+    const PersistentVector *vec = nullptr;
+    size_t index = 0;
+    const T *leaf = nullptr;
+    size_t leafStart = 0;
+    size_t leafEnd = 0;
+  };
+  using iterator = const_iterator;
+
+  PersistentVector() = default;
+  PersistentVector(const std::vector<T> &values) {
+    for (const auto &value : values) {
+      push_back(value);
+    }
+  }
+  PersistentVector(std::initializer_list<T> values) {
+    for (const auto &value : values) {
+      push_back(value);
+    }
+  }
+
+  size_t size() const { return length; }
+  bool empty() const { return length == 0; }
+
+  const T &operator[](size_t index) const {
+    size_t start;
+    const Node *leafNode = leafFor(index, start);
+    return leafNode->items[index - start];
+  }
+  const T &at(size_t index) const {
+    if (index >= length) {
+      throw std::out_of_range("PersistentVector::at");
+    }
+    return (*this)[index];
+  }
+  const T &front() const { return (*this)[0]; }
+  const T &back() const { return (*this)[length - 1]; }
+
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, length); }
+
+  void push_back(const T &value) {
+    if (root == nullptr) {
+      root = std::make_shared<Node>(true);
+      root->items.reserve(kBranch);
+      height = 0;
+    }
+    NodePtr split = pushBack(root, height, value);
+    if (split != nullptr) {
+      growRoot(split);
+    }
+    ++length;
+  }
+
+  void set(size_t index, const T &value) {
+    if (index >= length) {
+      throw std::out_of_range("PersistentVector::set");
+    }
+    Node *node = detach(root);
+    for (size_t h = height; h > 0; --h) {
+      size_t slot = childFor(node, index);
+      node = detach(node->children[slot]);
+    }
+    node->items[index] = value;
+  }
+
+  void erase(size_t index) {
+    if (index >= length) {
+      throw std::out_of_range("PersistentVector::erase");
+    }
+    eraseAt(root, height, index);
+    --length;
+    while (height > 0 && root->children.size() == 1) {
+      NodePtr child = root->children[0];
+      root = child;
+      --height;
+    }
+    if (length == 0) {
+      clear();
+    }
+  }
+
+  void pop_back() { erase(length - 1); }
+
+  void clear() {
+    root = nullptr;
+    height = 0;
+    length = 0;
+  }
+
+  /// Append every element of other. Large operands are joined as subtrees
+  /// rather than copied element by element.
+  void append(const PersistentVector &other) {
+    if (other.empty()) {
+      return;
+    }
+    if (empty()) {
+      *this = other;
+      return;
+    }
+    if (other.length < kBranch) {
+      for (const auto &value : other) {
+        push_back(value);
+      }
+      return;
+    }
+    if (height >= other.height) {
+      NodePtr split = attachRight(root, height, other.root, other.height);
+      if (split != nullptr) {
+        growRoot(split);
+      }
+    } else {
+      NodePtr newRoot = other.root;
+      NodePtr split = attachLeft(newRoot, other.height, root, height);
+      root = newRoot;
+      height = other.height;
+      if (split != nullptr) {
+        // split holds the leftmost children, so it goes first
+        NodePtr right = root;
+        root = split;
+        growRoot(right);
+      }
+    }
+    length += other.length;
+  }
+
+  std::vector<T> toVector() const {
+    std::vector<T> result;
+    result.reserve(length);
+    for (const auto &value : *this) {
+      result.push_back(value);
+    }
+    return result;
+  }
+
+private:
+  static Node *detach(NodePtr &node) {
+    if (node.use_count() != 1) {
+      node = std::make_shared<Node>(*node);
+    }
+    return node.get();
+  }
+
+  static size_t childFor(const Node *node, size_t &index) {
+    size_t slot =
+        std::upper_bound(node->sizes.begin(), node->sizes.end(), index) -
+        node->sizes.begin();
+    if (slot > 0) {
+      index -= node->sizes[slot - 1];
+    }
+    return slot;
+  }
+
+  static void recount(Node *node, size_t from) {
+    size_t total = from == 0 ? 0 : node->sizes[from - 1];
+    node->sizes.resize(node->children.size());
+    for (size_t i = from; i < node->children.size(); i++) {
+      total += node->children[i]->count();
+      node->sizes[i] = total;
+    }
+  }
+
+  const Node *leafFor(size_t index, size_t &leafStart) const {
+    const Node *node = root.get();
+    leafStart = 0;
+    size_t local = index;
+    for (size_t h = height; h > 0; --h) {
+      size_t slot = childFor(node, local);
+      node = node->children[slot].get();
+    }
+    leafStart = index - local;
+    return node;
+  }
+
+  void growRoot(const NodePtr &right) {
+    auto newRoot = std::make_shared<Node>(false);
+    newRoot->children = {root, right};
+    recount(newRoot.get(), 0);
+    root = newRoot;
+    ++height;
+  }
+
+  // Returns a new right sibling when node overflowed
+  static NodePtr pushBack(NodePtr &node, size_t h, const T &value) {
+    Node *n = detach(node);
+    if (h == 0) {
+      if (n->items.size() < kBranch) {
+        n->items.push_back(value);
+        return nullptr;
+      }
+      auto sibling = std::make_shared<Node>(true);
+      sibling->items.reserve(kBranch);
+      sibling->items.push_back(value);
+      return sibling;
+    }
+    NodePtr split = pushBack(n->children.back(), h - 1, value);
+    if (split == nullptr) {
+      n->sizes.back()++;
+      return nullptr;
+    }
+    return addChild(n, split);
+  }
+
+  static NodePtr addChild(Node *n, const NodePtr &child) {
+    if (n->children.size() < kBranch) {
+      n->children.push_back(child);
+      n->sizes.push_back(n->sizes.back() + child->count());
+      return nullptr;
+    }
+    auto sibling = std::make_shared<Node>(false);
+    sibling->children = {child};
+    sibling->sizes = {child->count()};
+    return sibling;
+  }
+
+  static void eraseAt(NodePtr &node, size_t h, size_t index) {
+    Node *n = detach(node);
+    if (h == 0) {
+      n->items.erase(n->items.begin() + index);
+      return;
+    }
+    size_t slot = childFor(n, index);
+    eraseAt(n->children[slot], h - 1, index);
+    if (n->children[slot]->count() == 0) {
+      n->children.erase(n->children.begin() + slot);
+    }
+    recount(n, slot);
+  }
+
+  // Hang sub (of height hs < h) off the right spine of node
+  static NodePtr attachRight(NodePtr &node, size_t h, const NodePtr &sub,
+                             size_t hs) {
+    if (h == hs) {
+      return sub;
+    }
+    Node *n = detach(node);
+    NodePtr split = attachRight(n->children.back(), h - 1, sub, hs);
+    recount(n, n->children.size() - 1);
+    if (split == nullptr) {
+      return nullptr;
+    }
+    return addChild(n, split);
+  }
+
+  // Hang sub (of height hs < h) off the left spine of node. A returned split
+  // holds the leftmost children and belongs before node.
+  static NodePtr attachLeft(NodePtr &node, size_t h, const NodePtr &sub,
+                            size_t hs) {
+    if (h == hs) {
+      return sub;
+    }
+    Node *n = detach(node);
+    NodePtr split = attachLeft(n->children.front(), h - 1, sub, hs);
+    if (split == nullptr) {
+      recount(n, 0);
+      return nullptr;
+    }
+    if (n->children.size() < kBranch) {
+      n->children.insert(n->children.begin(), split);
+      recount(n, 0);
+      return nullptr;
+    }
+    recount(n, 0);
+    auto sibling = std::make_shared<Node>(false);
+    sibling->children = {split};
+    sibling->sizes = {split->count()};
+    return sibling;
+  }
+};
+
+} // namespace Autumn
+#endif
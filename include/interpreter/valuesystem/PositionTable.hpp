@@ -0,0 +1,66 @@
+#ifndef __AUTUMN_POSITION_TABLE_HPP__
+#define __AUTUMN_POSITION_TABLE_HPP__
+
+#include "AutumnValue.hpp"
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace Autumn {
+class AutumnInstance;
+
+/// Per-interpreter table of interned Position values. Every (x, y) pair with
+/// 0 <= x, y < kExtent maps to a single immutable AutumnInstance, so
+/// positions built by the stdlib and the Position constructor are shared and
+/// compare by pointer. Interned positions carry no identity: list literals
+/// and addObj store a copy, and removeObj never matches them.
+class PositionTable {
+public:
+  /// Coordinates interned per axis; wider than any grid Autumn programs use
+  static constexpr int kExtent = 256;
+
+  PositionTable() = default;
+  PositionTable(const PositionTable &) = delete;
+  PositionTable &operator=(const PositionTable &) = delete;
+
+  /// The interned position at (x, y), or a fresh mutable one outside
+  /// [0, kExtent)
+  std::shared_ptr<AutumnInstance> get(int x, int y);
+
+  /// Every (x, y) with 0 <= x < width and 0 <= y < height, x-major, as
+  /// allPositions lists them. The last size asked for is kept, and a copy
+  /// of a ValueList shares its nodes, so repeated calls cost O(1).
+  ValueList grid(int width, int height);
+
+  /// The neighbours of (x, y) on a size x size grid in the order
+  /// adjPositions lists them: left, right, up, down, those within bounds
+  ValueList neighbors(int x, int y, int size);
+
+  size_t size() const { return positions.size(); }
+
+private:
+  static uint64_t key(int x, int y) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) |
+           static_cast<uint32_t>(y);
+  }
+
+  // map() may evaluate on worker threads
+  std::mutex mutex;
+  std::unordered_map<uint64_t, std::shared_ptr<AutumnInstance>> positions;
+
+  // Tables derived from one grid size, rebuilt when another is asked for;
+  // locked before mutex when both are held
+  std::mutex tablesMutex;
+  int gridWidth = -1;
+  int gridHeight = -1;
+  ValueList gridPositions;
+  int neighborsSize = -1;
+  // Filled in per cell as adjPositions asks
+  std::vector<ValueList> neighborLists;
+  std::vector<bool> neighborsBuilt;
+};
+
+} // namespace Autumn
+#endif
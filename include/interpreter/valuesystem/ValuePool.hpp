@@ -0,0 +1,128 @@
+#ifndef __AUTUMN_VALUE_POOL_HPP__
+#define __AUTUMN_VALUE_POOL_HPP__
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace Autumn {
+
+/// Size-classed free-list allocator for the values an interpreter creates.
+/// Each interpreter owns one pool; values made through makeValue while the
+/// pool is active on the current thread share their control block and object
+/// in one pooled slot, and the slot goes back on the free list when the last
+/// reference dies.
+///
+/// Only the thread that activated the pool allocates from it. Values may be
+/// released from any thread: foreign releases are queued and folded back into
+/// the free lists at the next beginStep().
+class ValuePool {
+public:
+  struct Stats {
+    size_t allocations = 0; // slots handed out
+    size_t recycled = 0;    // of which came from a free list
+    size_t releases = 0;    // slots given back
+    size_t chunkBytes = 0;  // memory reserved from the system
+    size_t live = 0;        // slots currently in use
+  };
+
+  /// Makes a pool the current one for this thread while in scope
+  class Scope {
+  public:
+    explicit Scope(const std::shared_ptr<ValuePool> &pool);
+    ~Scope();
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+  private:
+    std::shared_ptr<ValuePool> previous;
+  };
+
+  ValuePool() = default;
+  ~ValuePool();
+  ValuePool(const ValuePool &) = delete;
+  ValuePool &operator=(const ValuePool &) = delete;
+
+  static const std::shared_ptr<ValuePool> &current();
+
+  void *allocate(size_t bytes);
+  void deallocate(void *ptr, size_t bytes);
+
+  /// Reclaims slots released by other threads and starts a new set of
+  /// per-step counters
+  void beginStep();
+  const Stats &getStepStats() const { return stepStats; }
+  const Stats &getTotalStats() const { return totalStats; }
+
+private:
+  static constexpr size_t kGranule = 16;
+  static constexpr size_t kClasses = 32; // slots up to 512 bytes are pooled
+  static constexpr size_t kChunkBytes = 64 * 1024;
+
+  struct FreeSlot {
+    FreeSlot *next;
+  };
+
+  static size_t classOf(size_t bytes) {
+    return (bytes + kGranule - 1) / kGranule - 1;
+  }
+
+  FreeSlot *freeLists[kClasses] = {};
+  std::vector<void *> chunks;
+  char *bump = nullptr;
+  char *bumpEnd = nullptr;
+  std::atomic<std::thread::id> owner{};
+
+  std::mutex remoteMutex;
+  FreeSlot *remoteFrees[kClasses] = {};
+  size_t remoteCount = 0;
+
+  Stats stepStats;
+  Stats totalStats;
+};
+
+/// Minimal allocator routing std::allocate_shared through a ValuePool
+template <typename T> class PoolAllocator {
+public:
+  using value_type = T;
+
+  explicit PoolAllocator(std::shared_ptr<ValuePool> pool)
+      : pool(std::move(pool)) {}
+  template <typename U>
+  PoolAllocator(const PoolAllocator<U> &other) : pool(other.pool) {}
+
+  T *allocate(size_t n) {
+    return static_cast<T *>(pool->allocate(n * sizeof(T)));
+  }
+  void deallocate(T *ptr, size_t n) { pool->deallocate(ptr, n * sizeof(T)); }
+
+  template <typename U> bool operator==(const PoolAllocator<U> &other) const {
+    return pool == other.pool;
+  }
+  template <typename U> bool operator!=(const PoolAllocator<U> &other) const {
+    return pool != other.pool;
+  }
+
+private:
+  template <typename U> friend class PoolAllocator;
+  std::shared_ptr<ValuePool> pool;
+};
+
+/// Creates a value in the current thread's pool, or with make_shared when no
+/// pool is active
+template <typename T, typename... Args>
+std::shared_ptr<T> makeValue(Args &&...args) {
+  const std::shared_ptr<ValuePool> &pool = ValuePool::current();
+  if (pool == nullptr) {
+    return std::make_shared<T>(std::forward<Args>(args)...);
+  }
+  return std::allocate_shared<T>(PoolAllocator<T>(pool),
+                                 std::forward<Args>(args)...);
+}
+
+} // namespace Autumn
+#endif
@@ -1,5 +1,6 @@
 #ifndef _AUTUMN_ASTPRINTER_HPP_
 #define _AUTUMN_ASTPRINTER_HPP_
+#include "AutumnValue.hpp"
 #include "Error.hpp"
 #include "Expr.hpp"
 #include "Stmt.hpp"
@@ -68,24 +69,20 @@ public:
 
   std::any visitLiteralExpr(std::shared_ptr<Literal> expr) override {
     // Check if literal is string, boolean or int
-    try {
-      std::any_cast<int>(expr->value);
-      return "(NUMBER " + std::to_string(std::any_cast<int>(expr->value)) + ")";
-    } catch (const std::bad_any_cast &e) {
-      try {
-        std::any_cast<bool>(expr->value);
-        return std::any_cast<bool>(expr->value) ? std::string("(BOOL true)")
-                                                : std::string("(BOOL false)");
-      } catch (const std::bad_any_cast &e) {
-        try {
-          std::any_cast<std::string>(expr->value);
-          return "(STRING " + std::any_cast<std::string>(expr->value) + ")";
-        } catch (const std::bad_any_cast &e) {
-          throw Error("Unknown literal type");
-        }
-      }
-    }
-    return std::to_string(std::any_cast<int>(expr->value));
+    if (auto number = std::any_cast<int>(&expr->value)) {
+      return "(NUMBER " + std::to_string(*number) + ")";
+    }
+    if (auto boolean = std::any_cast<bool>(&expr->value)) {
+      return *boolean ? std::string("(BOOL true)") : std::string("(BOOL false)");
+    }
+    if (auto str = std::any_cast<std::string>(&expr->value)) {
+      return "(STRING " + *str + ")";
+    }
+    // Values the optimizer folded, such as positions
+    if (expr->constant != nullptr) {
+      return "(CONST " + expr->constant->toString() + ")";
+    }
+    throw Error("Unknown literal type");
   }
 
   std::any visitGroupingExpr(std::shared_ptr<Grouping> expr) override {
@@ -154,6 +151,20 @@ public:
     return "(<List> " + typeString + ")";
   }
 
+  std::any visitSetTypeExprExpr(std::shared_ptr<SetTypeExpr> expr) override {
+    std::string typeString =
+        std::any_cast<std::string>(expr->typeexpr->accept(*this));
+    return "(<Set> " + typeString + ")";
+  }
+
+  std::any visitMapTypeExprExpr(std::shared_ptr<MapTypeExpr> expr) override {
+    std::string keyString =
+        std::any_cast<std::string>(expr->keytypeexpr->accept(*this));
+    std::string valueString =
+        std::any_cast<std::string>(expr->valuetypeexpr->accept(*this));
+    return "(<Map> " + keyString + " " + valueString + ")";
+  }
+
   std::any visitListVarExprExpr(std::shared_ptr<ListVarExpr> expr) override {
     std::vector<std::string> varExprs;
     for (const auto &varExpr : expr->varExprs) {
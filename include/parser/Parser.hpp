@@ -51,6 +51,23 @@ private:
 public:
   SExpParser(const std::string &source) : source(source) {}
 
+  // Creates a literal together with the value every evaluation shares
+  static std::shared_ptr<Literal> makeLiteral(std::any value) {
+    auto literal = std::make_shared<Literal>(value);
+    if (value.type() == typeid(int)) {
+      literal->constant = AutumnNumber::of(std::any_cast<int>(value));
+    } else if (value.type() == typeid(bool)) {
+      literal->constant = AutumnBool::of(std::any_cast<bool>(value));
+    } else if (value.type() == typeid(std::string)) {
+      literal->constant =
+          std::make_shared<AutumnString>(std::any_cast<std::string>(value));
+    }
+    if (literal->constant != nullptr && !literal->constant->isInterned()) {
+      literal->constant->markInterned(literal.get());
+    }
+    return literal;
+  }
+
   std::shared_ptr<Expr> parseTypeExpr(std::shared_ptr<sexpresso::Sexp> sexp,
                                       int line = -1) {
     auto head = sexp;
@@ -74,6 +91,13 @@ public:
       if (tok.lexeme == "List") {
         return std::make_shared<ListTypeExpr>(parseTypeExpr(sexp->getChild(1)));
       }
+      if (tok.lexeme == "Set") {
+        return std::make_shared<SetTypeExpr>(parseTypeExpr(sexp->getChild(1)));
+      }
+      if (tok.lexeme == "Map") {
+        return std::make_shared<MapTypeExpr>(parseTypeExpr(sexp->getChild(1)),
+                                             parseTypeExpr(sexp->getChild(2)));
+      }
       return std::make_shared<TypeVariable>(Token(
           TokenType::IDENTIFIER, head->getString(), head->getString(), line));
     } else {
@@ -166,7 +190,7 @@ public:
       int num = std::stoi(toks[1].lexeme);
       return std::make_shared<Unary>(
           Token(toks[0].type, toks[0].lexeme, toks[0].literal, line),
-          std::make_shared<Literal>(num));
+          makeLiteral(num));
     }
     auto tok = Lexer(sexp->getChild(0)->getString()).scanTokens()[0];
     return std::make_shared<Unary>(
@@ -250,17 +274,17 @@ public:
       } else if (tok.type == TokenType::DOTDOT) {
         return parseGetExpr(sexp, line);
       } else if (tok.type == TokenType::NUMBER) {
-        return std::make_shared<Literal>(std::stoi(tok.lexeme));
+        return makeLiteral(std::stoi(tok.lexeme));
       } else if (tok.type == TokenType::STRING) {
-        return std::make_shared<Literal>(tok.lexeme);
+        return makeLiteral(tok.lexeme);
       } else if (tok.type == TokenType::FUN) {
         return parseFunction(sexp, line);
       } else if (tok.type == TokenType::MAPTO) {
         return parseFunction(sexp, line);
       } else if (tok.type == TokenType::TRUE) {
-        return std::make_shared<Literal>(true);
+        return makeLiteral(true);
       } else if (tok.type == TokenType::FALSE) {
-        return std::make_shared<Literal>(false);
+        return makeLiteral(false);
       } else if (tok.type == TokenType::IDENTIFIER) {
         if (tok.lexeme == "list") {
           return parseListVarExpr(sexp, line);
@@ -0,0 +1,652 @@
+#include "AstOptimizer.hpp"
+#include "AutumnInstance.hpp"
+#include "Parser.hpp"
+#include "PositionTable.hpp"
+#include "Purity.hpp"
+#include <algorithm>
+#include <climits>
+#include <functional>
+#include <unordered_set>
+
+namespace Autumn {
+
+static const int *numberOf(const std::shared_ptr<Expr> &expr) {
+  auto literal = std::dynamic_pointer_cast<Literal>(expr);
+  return literal == nullptr ? nullptr : std::any_cast<int>(&literal->value);
+}
+
+static const bool *boolOf(const std::shared_ptr<Expr> &expr) {
+  auto literal = std::dynamic_pointer_cast<Literal>(expr);
+  return literal == nullptr ? nullptr : std::any_cast<bool>(&literal->value);
+}
+
+static const std::string *stringOf(const std::shared_ptr<Expr> &expr) {
+  auto literal = std::dynamic_pointer_cast<Literal>(expr);
+  return literal == nullptr ? nullptr
+                            : std::any_cast<std::string>(&literal->value);
+}
+
+// Number literal for an int result, or nullptr if it overflows
+static std::shared_ptr<Expr> numberLiteral(long long value) {
+  if (value < INT_MIN || value > INT_MAX) {
+    return nullptr;
+  }
+  return SExpParser::makeLiteral(static_cast<int>(value));
+}
+
+// The literal `left op right` evaluates to, or nullptr if it cannot be
+// folded without changing what the program does
+static std::shared_ptr<Expr> foldBinary(TokenType op,
+                                        const std::shared_ptr<Expr> &left,
+                                        const std::shared_ptr<Expr> &right) {
+  const int *x = numberOf(left);
+  const int *y = numberOf(right);
+  if (x != nullptr && y != nullptr) {
+    long long a = *x;
+    long long b = *y;
+    switch (op) {
+    case TokenType::PLUS:
+      return numberLiteral(a + b);
+    case TokenType::MINUS:
+      return numberLiteral(a - b);
+    case TokenType::STAR:
+      return numberLiteral(a * b);
+    case TokenType::SLASH:
+      // Division by zero must still fail when it runs
+      return b == 0 ? nullptr : numberLiteral(a / b);
+    case TokenType::MODULO:
+      return b == 0 ? nullptr : numberLiteral(a % b);
+    case TokenType::GREATER:
+      return SExpParser::makeLiteral(a > b);
+    case TokenType::GREATER_EQUAL:
+      return SExpParser::makeLiteral(a >= b);
+    case TokenType::LESS:
+      return SExpParser::makeLiteral(a < b);
+    case TokenType::LESS_EQUAL:
+      return SExpParser::makeLiteral(a <= b);
+    case TokenType::EQUAL_EQUAL:
+      return SExpParser::makeLiteral(a == b);
+    case TokenType::BANG_EQUAL:
+      return SExpParser::makeLiteral(a != b);
+    default:
+      return nullptr;
+    }
+  }
+  if (op != TokenType::EQUAL_EQUAL && op != TokenType::BANG_EQUAL) {
+    return nullptr;
+  }
+  bool equal;
+  if (boolOf(left) != nullptr && boolOf(right) != nullptr) {
+    equal = *boolOf(left) == *boolOf(right);
+  } else if (stringOf(left) != nullptr && stringOf(right) != nullptr) {
+    equal = *stringOf(left) == *stringOf(right);
+  } else {
+    return nullptr;
+  }
+  return SExpParser::makeLiteral(op == TokenType::EQUAL_EQUAL ? equal : !equal);
+}
+
+static size_t countNodes(const std::shared_ptr<Expr> &expr) {
+  size_t count = 1;
+  forEachChild(expr, [&](const std::shared_ptr<Expr> &child) {
+    count += countNodes(child);
+  });
+  return count;
+}
+
+// Names that code run by a call may read from its caller's bindings:
+// variables read inside a lambda or a cell that no enclosing lambda, let or
+// object field binds
+static void collectFreeNames(const std::shared_ptr<Expr> &expr,
+                             std::vector<std::string> &scope, bool inBody,
+                             std::unordered_set<std::string> &names) {
+  if (expr == nullptr) {
+    return;
+  }
+  if (auto variable = std::dynamic_pointer_cast<Variable>(expr)) {
+    if (inBody && std::find(scope.begin(), scope.end(),
+                            variable->name.lexeme) == scope.end()) {
+      names.insert(variable->name.lexeme);
+    }
+    return;
+  }
+  size_t depth = scope.size();
+  if (auto lambda = std::dynamic_pointer_cast<Lambda>(expr)) {
+    for (const auto &param : lambda->params) {
+      scope.push_back(param.lexeme);
+    }
+    collectFreeNames(lambda->right, scope, true, names);
+  } else if (auto let = std::dynamic_pointer_cast<Let>(expr)) {
+    for (const auto &subexpr : let->exprs) {
+      auto assign = std::dynamic_pointer_cast<Assign>(subexpr);
+      collectFreeNames(assign != nullptr ? assign->value : subexpr, scope,
+                       inBody, names);
+      if (assign != nullptr) {
+        scope.push_back(assign->name.lexeme);
+      }
+    }
+  } else {
+    forEachChild(expr, [&](const std::shared_ptr<Expr> &child) {
+      collectFreeNames(child, scope, inBody, names);
+    });
+  }
+  scope.resize(depth);
+}
+
+void AstOptimizer::optimize(std::vector<std::shared_ptr<Stmt>> &stdlib,
+                            std::vector<std::shared_ptr<Stmt>> &program) {
+  std::vector<std::shared_ptr<Stmt>> stmts(stdlib);
+  stmts.insert(stmts.end(), program.begin(), program.end());
+  analyze(stmts);
+  for (auto &stmt : stdlib) {
+    stmt = rewrite(stmt);
+  }
+  for (auto &stmt : program) {
+    stmt = rewrite(stmt);
+  }
+}
+
+void AstOptimizer::analyze(const std::vector<std::shared_ptr<Stmt>> &stmts) {
+  constants.clear();
+  aliases.clear();
+  functions.clear();
+  positionRedefined = false;
+
+  std::unordered_set<std::string> writtenNames = collectWrittenNames(stmts);
+  std::unordered_set<std::string> boundNames;
+  collectBoundNames(stmts, boundNames);
+  auto isStable = [&](const std::string &name) {
+    return writtenNames.count(name) == 0 && boundNames.count(name) == 0;
+  };
+
+  // The last top-level assignment of each global, and the first top-level
+  // statement that may call a function and so run code reading the globals
+  struct Binding {
+    size_t index;
+    std::shared_ptr<Expr> value;
+  };
+  std::unordered_map<std::string, Binding> bindings;
+  size_t firstCall = stmts.size();
+  for (size_t i = 0; i < stmts.size(); i++) {
+    if (auto object = std::dynamic_pointer_cast<Object>(stmts[i])) {
+      positionRedefined = positionRedefined || object->name.lexeme == "Position";
+      continue;
+    }
+    if (std::dynamic_pointer_cast<OnStmt>(stmts[i]) != nullptr) {
+      continue;
+    }
+    auto exprStmt = std::dynamic_pointer_cast<Expression>(stmts[i]);
+    if (exprStmt != nullptr) {
+      if (std::dynamic_pointer_cast<TypeDecl>(exprStmt->expression) != nullptr) {
+        continue;
+      }
+      auto assign = std::dynamic_pointer_cast<Assign>(exprStmt->expression);
+      if (assign != nullptr) {
+        // Next expressions and initializers run after every statement
+        if (std::dynamic_pointer_cast<InitNext>(assign->value) != nullptr) {
+          continue;
+        }
+        bindings[assign->name.lexeme] = {i, assign->value};
+        if (std::dynamic_pointer_cast<Literal>(assign->value) != nullptr ||
+            std::dynamic_pointer_cast<Lambda>(assign->value) != nullptr ||
+            std::dynamic_pointer_cast<Variable>(assign->value) != nullptr) {
+          continue;
+        }
+      }
+    }
+    firstCall = std::min(firstCall, i);
+  }
+
+  for (const auto &[name, binding] : bindings) {
+    if (!isStable(name) || binding.index >= firstCall) {
+      continue;
+    }
+    auto literal = std::dynamic_pointer_cast<Literal>(binding.value);
+    if (literal != nullptr && literal->constant != nullptr) {
+      constants[name] = literal;
+      continue;
+    }
+    // An alias holds what its target held when it was assigned, so the
+    // target must not be rebound afterwards
+    auto variable = std::dynamic_pointer_cast<Variable>(binding.value);
+    if (variable == nullptr || !isStable(variable->name.lexeme)) {
+      continue;
+    }
+    auto target = bindings.find(variable->name.lexeme);
+    if (target == bindings.end() || target->second.index < binding.index) {
+      aliases[name] = variable->name.lexeme;
+    }
+  }
+  for (auto &[name, target] : aliases) {
+    for (size_t hops = 0; hops < aliases.size() && aliases.count(target) != 0;
+         hops++) {
+      target = aliases[target];
+    }
+  }
+
+  std::unordered_set<std::string> freeNames;
+  std::vector<std::string> scope;
+  for (const auto &stmt : stmts) {
+    if (auto object = std::dynamic_pointer_cast<Object>(stmt)) {
+      for (const auto &field : object->fields) {
+        if (auto decl = std::dynamic_pointer_cast<TypeDecl>(field)) {
+          scope.push_back(decl->name.lexeme);
+        }
+      }
+      collectFreeNames(object->Cell, scope, true, freeNames);
+      scope.clear();
+    } else if (auto onStmt = std::dynamic_pointer_cast<OnStmt>(stmt)) {
+      collectFreeNames(onStmt->condition, scope, false, freeNames);
+      collectFreeNames(onStmt->expr, scope, false, freeNames);
+    } else if (auto exprStmt = std::dynamic_pointer_cast<Expression>(stmt)) {
+      collectFreeNames(exprStmt->expression, scope, false, freeNames);
+    }
+  }
+  // prev reads a lone variable argument by name, which a parameter would
+  // no longer have once inlined
+  auto mayBePrev = [&](const std::shared_ptr<Expr> &callee) {
+    auto variable = std::dynamic_pointer_cast<Variable>(callee);
+    if (variable == nullptr || !isStable(variable->name.lexeme)) {
+      return true;
+    }
+    auto alias = aliases.find(variable->name.lexeme);
+    return (alias == aliases.end() ? variable->name.lexeme : alias->second) ==
+           "prev";
+  };
+  for (const auto &[name, binding] : bindings) {
+    auto lambda = std::dynamic_pointer_cast<Lambda>(binding.value);
+    if (lambda == nullptr || !isStable(name) || binding.index >= firstCall ||
+        countNodes(lambda->right) > kMaxInlineSize) {
+      continue;
+    }
+    std::unordered_set<std::string> params;
+    bool inlinable = true;
+    for (const auto &param : lambda->params) {
+      params.insert(param.lexeme);
+      inlinable = inlinable && freeNames.count(param.lexeme) == 0;
+    }
+    std::function<void(const std::shared_ptr<Expr> &)> check =
+        [&](const std::shared_ptr<Expr> &expr) {
+          if (std::dynamic_pointer_cast<Lambda>(expr) != nullptr ||
+              std::dynamic_pointer_cast<Let>(expr) != nullptr ||
+              std::dynamic_pointer_cast<Assign>(expr) != nullptr ||
+              std::dynamic_pointer_cast<Set>(expr) != nullptr ||
+              std::dynamic_pointer_cast<InitNext>(expr) != nullptr ||
+              std::dynamic_pointer_cast<TypeDecl>(expr) != nullptr) {
+            inlinable = false;
+            return;
+          }
+          auto call = std::dynamic_pointer_cast<Call>(expr);
+          if (call != nullptr && call->arguments.size() == 1) {
+            auto argument =
+                std::dynamic_pointer_cast<Variable>(call->arguments[0]);
+            if (argument != nullptr && params.count(argument->name.lexeme) &&
+                mayBePrev(call->callee)) {
+              inlinable = false;
+              return;
+            }
+          }
+          forEachChild(expr, check);
+        };
+    check(lambda->right);
+    if (inlinable) {
+      functions[name] = lambda;
+    }
+  }
+}
+
+std::shared_ptr<Expr> AstOptimizer::rewrite(const std::shared_ptr<Expr> &expr) {
+  return std::any_cast<std::shared_ptr<Expr>>(expr->accept(*this));
+}
+
+std::shared_ptr<Stmt> AstOptimizer::rewrite(const std::shared_ptr<Stmt> &stmt) {
+  if (auto exprStmt = std::dynamic_pointer_cast<Expression>(stmt)) {
+    // A top-level alias reads its target when it runs, which may be before
+    // the target's last assignment
+    auto assign = std::dynamic_pointer_cast<Assign>(exprStmt->expression);
+    if (assign != nullptr &&
+        std::dynamic_pointer_cast<Variable>(assign->value) != nullptr) {
+      return stmt;
+    }
+    auto expression = rewrite(exprStmt->expression);
+    if (expression == exprStmt->expression) {
+      return stmt;
+    }
+    return std::make_shared<Expression>(expression);
+  }
+  if (auto onStmt = std::dynamic_pointer_cast<OnStmt>(stmt)) {
+    auto condition = rewrite(onStmt->condition);
+    auto body = rewrite(onStmt->expr);
+    if (condition == onStmt->condition && body == onStmt->expr) {
+      return stmt;
+    }
+    return std::make_shared<OnStmt>(condition, body);
+  }
+  if (auto object = std::dynamic_pointer_cast<Object>(stmt)) {
+    bool changed = false;
+    std::vector<std::shared_ptr<Expr>> fields;
+    for (const auto &field : object->fields) {
+      fields.push_back(rewrite(field));
+      changed = changed || fields.back() != field;
+    }
+    auto cell = object->Cell == nullptr ? nullptr : rewrite(object->Cell);
+    if (!changed && cell == object->Cell) {
+      return stmt;
+    }
+    return std::make_shared<Object>(object->name, fields, cell);
+  }
+  if (auto block = std::dynamic_pointer_cast<Block>(stmt)) {
+    bool changed = false;
+    std::vector<std::shared_ptr<Stmt>> statements;
+    for (const auto &statement : block->statements) {
+      statements.push_back(rewrite(statement));
+      changed = changed || statements.back() != statement;
+    }
+    return changed ? std::make_shared<Block>(statements) : stmt;
+  }
+  return stmt;
+}
+
+std::shared_ptr<Expr> AstOptimizer::inlineCall(
+    const std::string &name,
+    const std::vector<std::shared_ptr<Expr>> &arguments) {
+  auto function = functions.find(name);
+  if (function == functions.end() || inlining.count(name) != 0 ||
+      function->second->params.size() != arguments.size()) {
+    return nullptr;
+  }
+  // Other arguments could be evaluated a different number of times or in a
+  // different order than the call would
+  std::unordered_map<std::string, std::shared_ptr<Expr>> bound;
+  for (size_t i = 0; i < arguments.size(); i++) {
+    if (std::dynamic_pointer_cast<Literal>(arguments[i]) == nullptr &&
+        std::dynamic_pointer_cast<Variable>(arguments[i]) == nullptr) {
+      return nullptr;
+    }
+    bound[function->second->params[i].lexeme] = arguments[i];
+  }
+  Stats before = stats;
+  std::swap(substitutions, bound);
+  inlining.insert(name);
+  std::shared_ptr<Expr> body = rewrite(function->second->right);
+  inlining.erase(name);
+  std::swap(substitutions, bound);
+  if (countNodes(body) > kMaxInlineSize) {
+    stats = before;
+    return nullptr;
+  }
+  ++stats.inlined;
+  return body;
+}
+
+std::any AstOptimizer::visitAssignExpr(std::shared_ptr<Assign> expr) {
+  auto value = rewrite(expr->value);
+  if (value == expr->value) {
+    return std::shared_ptr<Expr>(expr);
+  }
+  return std::shared_ptr<Expr>(std::make_shared<Assign>(expr->name, value));
+}
+
+std::any AstOptimizer::visitBinaryExpr(std::shared_ptr<Binary> expr) {
+  auto left = rewrite(expr->left);
+  auto right = rewrite(expr->right);
+  if (auto folded = foldBinary(expr->op.type, left, right)) {
+    ++stats.folded;
+    return folded;
+  }
+  if (left == expr->left && right == expr->right) {
+    return std::shared_ptr<Expr>(expr);
+  }
+  return std::shared_ptr<Expr>(
+      std::make_shared<Binary>(left, expr->op, right));
+}
+
+std::any AstOptimizer::visitCallExpr(std::shared_ptr<Call> expr) {
+  auto callee = rewrite(expr->callee);
+  bool changed = callee != expr->callee;
+  // prev reads a lone variable argument by name, so any such argument is
+  // kept as written
+  bool byName = expr->arguments.size() == 1 &&
+                std::dynamic_pointer_cast<Variable>(expr->arguments[0]) !=
+                    nullptr;
+  std::vector<std::shared_ptr<Expr>> arguments;
+  arguments.reserve(expr->arguments.size());
+  for (const auto &argument : expr->arguments) {
+    arguments.push_back(byName ? substitute(argument) : rewrite(argument));
+    changed = changed || arguments.back() != argument;
+  }
+
+  auto name = std::dynamic_pointer_cast<Variable>(callee);
+  if (positions != nullptr && !positionRedefined && name != nullptr &&
+      name->name.lexeme == "Position" && arguments.size() == 2) {
+    const int *x = numberOf(arguments[0]);
+    const int *y = numberOf(arguments[1]);
+    // Only interned positions are immutable enough to share
+    auto position = x != nullptr && y != nullptr ? positions->get(*x, *y)
+                                                 : nullptr;
+    if (position != nullptr && position->isInterned()) {
+      auto literal = std::make_shared<Literal>(std::any());
+      literal->constant = position;
+      ++stats.folded;
+      return std::shared_ptr<Expr>(literal);
+    }
+  }
+  if (name != nullptr) {
+    if (auto body = inlineCall(name->name.lexeme, arguments)) {
+      return body;
+    }
+  }
+  if (!changed) {
+    return std::shared_ptr<Expr>(expr);
+  }
+  auto rewritten = std::make_shared<Call>(callee, arguments);
+  rewritten->site = expr->site;
+  return std::shared_ptr<Expr>(rewritten);
+}
+
+std::any AstOptimizer::visitGetExpr(std::shared_ptr<Get> expr) {
+  auto object = rewrite(expr->object);
+  // Fields of a folded position
+  auto literal = std::dynamic_pointer_cast<Literal>(object);
+  auto position = literal == nullptr ? nullptr
+                                     : std::dynamic_pointer_cast<AutumnInstance>(
+                                           literal->constant);
+  if (position != nullptr && position->getClassName() == "Position" &&
+      (expr->name.lexeme == "x" || expr->name.lexeme == "y")) {
+    auto number = std::dynamic_pointer_cast<AutumnNumber>(
+        position->get(expr->name.lexeme));
+    if (number != nullptr) {
+      ++stats.folded;
+      return std::shared_ptr<Expr>(
+          SExpParser::makeLiteral(number->getNumber()));
+    }
+  }
+  if (object == expr->object) {
+    return std::shared_ptr<Expr>(expr);
+  }
+  return std::shared_ptr<Expr>(std::make_shared<Get>(object, expr->name));
+}
+
+std::any AstOptimizer::visitGroupingExpr(std::shared_ptr<Grouping> expr) {
+  auto expression = rewrite(expr->expression);
+  if (expression == expr->expression) {
+    return std::shared_ptr<Expr>(expr);
+  }
+  return std::shared_ptr<Expr>(std::make_shared<Grouping>(expression));
+}
+
+std::any AstOptimizer::visitLiteralExpr(std::shared_ptr<Literal> expr) {
+  return std::shared_ptr<Expr>(expr);
+}
+
+std::any AstOptimizer::visitLogicalExpr(std::shared_ptr<Logical> expr) {
+  auto left = rewrite(expr->left);
+  auto right = rewrite(expr->right);
+  if (const bool *value = boolOf(left)) {
+    // (| true x) and (& false x) never evaluate x
+    if ((expr->op.type == TokenType::OR) == *value) {
+      ++stats.folded;
+      return std::shared_ptr<Expr>(SExpParser::makeLiteral(*value));
+    }
+    if (const bool *rightValue = boolOf(right)) {
+      ++stats.folded;
+      return std::shared_ptr<Expr>(SExpParser::makeLiteral(*rightValue));
+    }
+  }
+  if (left == expr->left && right == expr->right) {
+    return std::shared_ptr<Expr>(expr);
+  }
+  return std::shared_ptr<Expr>(
+      std::make_shared<Logical>(left, expr->op, right));
+}
+
+std::any AstOptimizer::visitSetExpr(std::shared_ptr<Set> expr) {
+  auto object = rewrite(expr->object);
+  auto value = rewrite(expr->value);
+  if (object == expr->object && value == expr->value) {
+    return std::shared_ptr<Expr>(expr);
+  }
+  return std::shared_ptr<Expr>(
+      std::make_shared<Set>(object, expr->name, value));
+}
+
+std::any AstOptimizer::visitUnaryExpr(std::shared_ptr<Unary> expr) {
+  auto right = rewrite(expr->right);
+  std::shared_ptr<Expr> folded;
+  if (const int *number = numberOf(right)) {
+    if (expr->op.type == TokenType::MINUS) {
+      folded = numberLiteral(-static_cast<long long>(*number));
+    } else if (expr->op.type == TokenType::PLUS) {
+      folded = numberLiteral(*number);
+    }
+  } else if (const bool *value = boolOf(right)) {
+    if (expr->op.type == TokenType::BANG) {
+      folded = SExpParser::makeLiteral(!*value);
+    }
+  }
+  if (folded != nullptr) {
+    ++stats.folded;
+    return folded;
+  }
+  if (right == expr->right) {
+    return std::shared_ptr<Expr>(expr);
+  }
+  return std::shared_ptr<Expr>(std::make_shared<Unary>(expr->op, right));
+}
+
+std::any AstOptimizer::visitLambdaExpr(std::shared_ptr<Lambda> expr) {
+  auto right = rewrite(expr->right);
+  if (right == expr->right) {
+    return std::shared_ptr<Expr>(expr);
+  }
+  return std::shared_ptr<Expr>(std::make_shared<Lambda>(expr->params, right));
+}
+
+std::shared_ptr<Expr>
+AstOptimizer::substitute(const std::shared_ptr<Expr> &expr) const {
+  auto variable = std::dynamic_pointer_cast<Variable>(expr);
+  if (variable == nullptr) {
+    return expr;
+  }
+  auto argument = substitutions.find(variable->name.lexeme);
+  return argument == substitutions.end() ? expr : argument->second;
+}
+
+std::any AstOptimizer::visitVariableExpr(std::shared_ptr<Variable> expr) {
+  const std::string &name = expr->name.lexeme;
+  auto argument = substitutions.find(name);
+  if (argument != substitutions.end()) {
+    return argument->second;
+  }
+  auto alias = aliases.find(name);
+  const std::string &resolved = alias == aliases.end() ? name : alias->second;
+  auto constant = constants.find(resolved);
+  if (constant != constants.end()) {
+    ++stats.folded;
+    return std::shared_ptr<Expr>(constant->second);
+  }
+  if (alias == aliases.end()) {
+    return std::shared_ptr<Expr>(expr);
+  }
+  ++stats.aliases;
+  return std::shared_ptr<Expr>(std::make_shared<Variable>(
+      Token(expr->name.type, resolved, resolved, expr->name.line)));
+}
+
+std::any AstOptimizer::visitTypeVariableExpr(
+    std::shared_ptr<TypeVariable> expr) {
+  return std::shared_ptr<Expr>(expr);
+}
+
+std::any AstOptimizer::visitTypeDeclExpr(std::shared_ptr<TypeDecl> expr) {
+  return std::shared_ptr<Expr>(expr);
+}
+
+std::any AstOptimizer::visitListTypeExprExpr(
+    std::shared_ptr<ListTypeExpr> expr) {
+  return std::shared_ptr<Expr>(expr);
+}
+
+std::any AstOptimizer::visitSetTypeExprExpr(std::shared_ptr<SetTypeExpr> expr) {
+  return std::shared_ptr<Expr>(expr);
+}
+
+std::any AstOptimizer::visitMapTypeExprExpr(std::shared_ptr<MapTypeExpr> expr) {
+  return std::shared_ptr<Expr>(expr);
+}
+
+std::any AstOptimizer::visitListVarExprExpr(std::shared_ptr<ListVarExpr> expr) {
+  bool changed = false;
+  std::vector<std::shared_ptr<Expr>> elements;
+  elements.reserve(expr->varExprs.size());
+  for (const auto &element : expr->varExprs) {
+    elements.push_back(rewrite(element));
+    changed = changed || elements.back() != element;
+  }
+  if (!changed) {
+    return std::shared_ptr<Expr>(expr);
+  }
+  return std::shared_ptr<Expr>(std::make_shared<ListVarExpr>(elements));
+}
+
+std::any AstOptimizer::visitIfExprExpr(std::shared_ptr<IfExpr> expr) {
+  auto condition = rewrite(expr->condition);
+  if (const bool *value = boolOf(condition)) {
+    ++stats.branches;
+    return rewrite(*value ? expr->thenBranch : expr->elseBranch);
+  }
+  auto thenBranch = rewrite(expr->thenBranch);
+  auto elseBranch = rewrite(expr->elseBranch);
+  if (condition == expr->condition && thenBranch == expr->thenBranch &&
+      elseBranch == expr->elseBranch) {
+    return std::shared_ptr<Expr>(expr);
+  }
+  return std::shared_ptr<Expr>(
+      std::make_shared<IfExpr>(condition, thenBranch, elseBranch));
+}
+
+std::any AstOptimizer::visitLetExpr(std::shared_ptr<Let> expr) {
+  bool changed = false;
+  std::vector<std::shared_ptr<Expr>> exprs;
+  exprs.reserve(expr->exprs.size());
+  for (const auto &subexpr : expr->exprs) {
+    exprs.push_back(rewrite(subexpr));
+    changed = changed || exprs.back() != subexpr;
+  }
+  if (!changed) {
+    return std::shared_ptr<Expr>(expr);
+  }
+  return std::shared_ptr<Expr>(std::make_shared<Let>(exprs));
+}
+
+std::any AstOptimizer::visitInitNextExpr(std::shared_ptr<InitNext> expr) {
+  auto initializer = rewrite(expr->initializer);
+  auto nextExpr = rewrite(expr->nextExpr);
+  if (initializer == expr->initializer && nextExpr == expr->nextExpr) {
+    return std::shared_ptr<Expr>(expr);
+  }
+  return std::shared_ptr<Expr>(
+      std::make_shared<InitNext>(initializer, nextExpr));
+}
+
+} // namespace Autumn
@@ -7,17 +7,33 @@ Autumn::Environment::Environment() : enclosing(nullptr), environmentType(Environ
 Autumn::Environment::Environment(EnvironmentPtr enclosingEnv, EnvironmentType environmentType)
     : enclosing(enclosingEnv), environmentType(environmentType) {}
 
-Autumn::EnvironmentPtr Autumn::Environment::ancestor(int distance) {
-  EnvironmentPtr environment = shared_from_this();
+// The listing of defined variables is only built if the error is printed:
+// lookups that are expected to fail (e.g. while closing over cell arguments)
+// are caught without ever showing it.
+static Autumn::Error undefinedVariable(const std::string &name,
+                                       std::weak_ptr<Autumn::Environment> env) {
+  Autumn::Error error("Undefined variable '" + name +
+                      "'. Defined arguments are: ");
+  error.wrap([env](const std::string &what) {
+    auto environment = env.lock();
+    return environment != nullptr
+               ? what + environment->printAllDefinedVariablesCrossStack()
+               : what;
+  });
+  return error;
+}
+
+Autumn::Environment *Autumn::Environment::ancestor(int distance) {
+  Environment *environment = this;
   for (int i = 0; i < distance; i++) {
-    environment = environment->enclosing;
+    environment = environment->enclosing.get();
   }
   return environment;
 }
 
 void Autumn::Environment::define(std::string name,
                                  std::shared_ptr<AutumnValue> value) {
-  values[name] = value;
+  bindValue(name, std::move(value));
   definitionOrder.push_back(name);
   updateStates[name] = false;
 }
@@ -35,34 +51,36 @@ Autumn::Environment::getAt(int distance, const std::string &name) {
 void Autumn::Environment::assignAt(
     int distance, const Token &name,
     const std::shared_ptr<Autumn::AutumnValue> &value) {
-  ancestor(distance)->values[name.lexeme] = value;
+  ancestor(distance)->bindValue(name.lexeme, value);
   updateStates[name.lexeme] = true;
 }
 
 std::shared_ptr<Autumn::AutumnValue>
 Autumn::Environment::get(const Token &name) {
-  if (values.find(name.lexeme) != values.end()) {
-    return values[name.lexeme];
+  auto it = values.find(name.lexeme);
+  if (it != values.end()) {
+    return it->second;
   }
 
   if (enclosing != nullptr) {
     return enclosing->get(name);
   }
 
-  throw Error(std::string("Undefined variable '" + name.lexeme + "'. Defined arguments are: ") + this->printAllDefinedVariablesCrossStack());
+  throw undefinedVariable(name.lexeme, weak_from_this());
 }
 
 std::shared_ptr<Autumn::AutumnValue>
 Autumn::Environment::get(const std::string &name) {
-  if (values.find(name) != values.end()) {
-    return values[name];
+  auto it = values.find(name);
+  if (it != values.end()) {
+    return it->second;
   }
 
   if (enclosing != nullptr) {
     return enclosing->get(name);
   }
 
-  throw Error(std::string("Undefined variable '" + name + "'. Defined arguments are: ") + this->printAllDefinedVariablesCrossStack());
+  throw undefinedVariable(name, weak_from_this());
 }
 
 std::shared_ptr<Autumn::AutumnType>
@@ -79,33 +97,44 @@ Autumn::Environment::getTypeValue(const Token &name) {
 }
 
 void Autumn::Environment::assign(const Token &name,
-                                 const std::shared_ptr<AutumnValue> &value) {
-  return assign(name.lexeme, value);
+                                 const std::shared_ptr<AutumnValue> &value,
+                                 bool typeChecked) {
+  return assign(name.lexeme, value, typeChecked);
 }
 
 void Autumn::Environment::assign(const std::string &name,
-                                 const std::shared_ptr<AutumnValue> &value) {
-  if (values.find(name) != values.end()) {
-    auto oldType = values[name]->getType();
-    auto newType = value->getType();
-    if (oldType->toString() != newType->toString() &&
-        std::dynamic_pointer_cast<AutumnList>(value) == nullptr) {
-      throw Error(std::string("Cannot assign value of type '") +
-                  newType->toString() + "' to variable of type '" +
-                  oldType->toString() + "' for variable '" + name + "'.");
+                                 const std::shared_ptr<AutumnValue> &value,
+                                 bool typeChecked) {
+  auto it = values.find(name);
+  if (it != values.end()) {
+    // Lists, sets and maps may change element type, so their type is not
+    // checked
+    if (!typeChecked && dynamic_cast<AutumnList *>(value.get()) == nullptr &&
+        dynamic_cast<AutumnSet *>(value.get()) == nullptr &&
+        dynamic_cast<AutumnMap *>(value.get()) == nullptr) {
+      auto oldType = it->second->getType();
+      auto newType = value->getType();
+      if (!AutumnType::sameType(oldType.get(), newType.get())) {
+        throw Error(std::string("Cannot assign value of type '") +
+                    newType->toString() + "' to variable of type '" +
+                    oldType->toString() + "' for variable '" + name + "'.");
+      }
+    }
+    // Interned values are shared, so they neither take nor pass on the
+    // binding's identity
+    if (!value->isInterned() && !it->second->isInterned()) {
+      value->setInstId(it->second->getInstId());
     }
-    int oldInstId = values[name]->getInstId();
-    values[name] = value;
-    values[name]->setInstId(oldInstId);
+    bindValue(name, value);
     updateStates[name] = true;
     return;
   } else {
-    auto ans = enclosing;
+    Environment *ans = enclosing.get();
     while (ans != nullptr && ans->values.find(name) == ans->values.end()) {
-      ans = ans->enclosing;
+      ans = ans->enclosing.get();
     }
     if (ans != nullptr) {
-      ans->assign(name, value);
+      ans->assign(name, value, typeChecked);
     } else {
       define(name, value);
     }
@@ -122,3 +151,56 @@ void Autumn::Environment::resetUpdateStates() {
     entry.second = false;
   }
 }
+
+void Autumn::Environment::bindValue(const std::string &name,
+                                    std::shared_ptr<AutumnValue> value) {
+  auto it = values.find(name);
+  if (it != values.end() && it->second != nullptr &&
+      !it->second->isInterned()) {
+    auto idIt = idIndex.find(it->second->getInstId());
+    if (idIt != idIndex.end() && idIt->second == name) {
+      idIndex.erase(idIt);
+    }
+  }
+  if (value != nullptr && !value->isInterned()) {
+    idIndex[value->getInstId()] = name;
+  }
+  bindingVersion++;
+  if (name == "GRID_SIZE") {
+    auto number = dynamic_cast<AutumnNumber *>(value.get());
+    gridSize = number != nullptr ? number->getNumber() : -1;
+  }
+  if (it != values.end()) {
+    it->second = std::move(value);
+  } else {
+    values.emplace(name, std::move(value));
+  }
+  // Entries a re-identified value left behind (see lookupId) only go away
+  // here, since lookups must not write to the index
+  if (idIndex.size() > 2 * values.size() + 16) {
+    rebuildIdIndex();
+  }
+}
+
+void Autumn::Environment::rebuildIdIndex() {
+  idIndex.clear();
+  idIndex.reserve(values.size());
+  for (const auto &[key, value] : values) {
+    if (value != nullptr && !value->isInterned()) {
+      idIndex[value->getInstId()] = key;
+    }
+  }
+}
+
+const std::string *Autumn::Environment::lookupId(int instId) const {
+  auto idIt = idIndex.find(instId);
+  if (idIt == idIndex.end()) {
+    return nullptr;
+  }
+  auto it = values.find(idIt->second);
+  if (it == values.end() || it->second == nullptr ||
+      it->second->getInstId() != instId) {
+    return nullptr;
+  }
+  return &idIt->second;
+}
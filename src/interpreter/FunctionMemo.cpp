@@ -0,0 +1,207 @@
+#include "FunctionMemo.hpp"
+#include "AutumnCallableValue.hpp"
+#include "AutumnInstance.hpp"
+#include "AutumnValue.hpp"
+#include <functional>
+#include <typeinfo>
+
+namespace Autumn {
+
+static void combine(size_t &seed, size_t value) {
+  seed ^= value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+}
+
+static bool hashValue(const std::shared_ptr<AutumnValue> &value, size_t &hash) {
+  AutumnValue *raw = value.get();
+  if (raw == nullptr) {
+    return false;
+  }
+  combine(hash, typeid(*raw).hash_code());
+  if (auto number = dynamic_cast<AutumnNumber *>(raw)) {
+    combine(hash, std::hash<int>()(number->getNumber()));
+    return true;
+  }
+  if (auto boolean = dynamic_cast<AutumnBool *>(raw)) {
+    combine(hash, boolean->isTruthy());
+    return true;
+  }
+  if (auto string = dynamic_cast<AutumnString *>(raw)) {
+    combine(hash, std::hash<std::string>()(string->getString()));
+    return true;
+  }
+  if (auto list = dynamic_cast<AutumnList *>(raw)) {
+    for (const auto &element : *list->getValues()) {
+      if (!hashValue(element, hash)) {
+        return false;
+      }
+    }
+    return true;
+  }
+  if (auto instance = dynamic_cast<AutumnInstance *>(raw)) {
+    combine(hash, std::hash<void *>()(instance->getClass().get()));
+    for (const auto &name : instance->getClass()->getFieldNames()) {
+      if (!hashValue(instance->get(name), hash)) {
+        return false;
+      }
+    }
+    return true;
+  }
+  return false;
+}
+
+// Stricter than isEqual: a number never matches a boolean and instances
+// must share their class
+static bool isSameValue(const std::shared_ptr<AutumnValue> &a,
+                        const std::shared_ptr<AutumnValue> &b) {
+  if (a == b) {
+    return true;
+  }
+  if (a == nullptr || b == nullptr || typeid(*a) != typeid(*b)) {
+    return false;
+  }
+  if (auto number = dynamic_cast<AutumnNumber *>(a.get())) {
+    return number->getNumber() ==
+           static_cast<AutumnNumber *>(b.get())->getNumber();
+  }
+  if (auto boolean = dynamic_cast<AutumnBool *>(a.get())) {
+    return boolean->isTruthy() == b->isTruthy();
+  }
+  if (auto string = dynamic_cast<AutumnString *>(a.get())) {
+    return string->getString() ==
+           static_cast<AutumnString *>(b.get())->getString();
+  }
+  if (auto list = dynamic_cast<AutumnList *>(a.get())) {
+    auto other = static_cast<AutumnList *>(b.get());
+    auto values = list->getValues();
+    auto otherValues = other->getValues();
+    if (values->size() != otherValues->size()) {
+      return false;
+    }
+    for (size_t i = 0; i < values->size(); i++) {
+      if (!isSameValue(values->at(i), otherValues->at(i))) {
+        return false;
+      }
+    }
+    return true;
+  }
+  if (auto instance = dynamic_cast<AutumnInstance *>(a.get())) {
+    auto other = static_cast<AutumnInstance *>(b.get());
+    if (instance->getClass() != other->getClass()) {
+      return false;
+    }
+    for (const auto &name : instance->getClass()->getFieldNames()) {
+      if (!isSameValue(instance->get(name), other->get(name))) {
+        return false;
+      }
+    }
+    return true;
+  }
+  return false;
+}
+
+// Only interned values may be handed out on every hit. Assigning a value to a
+// variable gives it the variable's instId, so a cached number or string
+// handed to two callers would change identity under the first one.
+static bool isShareable(AutumnValue *value) {
+  return value != nullptr && value->isInterned();
+}
+
+static bool isCacheable(const std::shared_ptr<AutumnValue> &result) {
+  if (isShareable(result.get())) {
+    return true;
+  }
+  auto list = dynamic_cast<AutumnList *>(result.get());
+  if (list == nullptr) {
+    return false;
+  }
+  for (const auto &element : *list->getValues()) {
+    if (!isShareable(element.get())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool FunctionMemo::hashArguments(
+    const std::vector<std::shared_ptr<AutumnValue>> &arguments, size_t &hash) {
+  hash = arguments.size();
+  for (const auto &argument : arguments) {
+    if (!hashValue(argument, hash)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::shared_ptr<AutumnValue>
+FunctionMemo::find(size_t hash,
+                   const std::vector<std::shared_ptr<AutumnValue>> &arguments) {
+  std::shared_ptr<AutumnValue> result;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto range = index.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      const Entry &entry = *it->second;
+      if (entry.arguments.size() != arguments.size()) {
+        continue;
+      }
+      bool same = true;
+      for (size_t i = 0; i < arguments.size() && same; i++) {
+        same = isSameValue(entry.arguments[i], arguments[i]);
+      }
+      if (same) {
+        entries.splice(entries.begin(), entries, it->second);
+        result = entry.result;
+        ++stats.hits;
+        break;
+      }
+    }
+  }
+  auto list = std::dynamic_pointer_cast<AutumnList>(result);
+  if (list != nullptr) {
+    return makeValue<AutumnList>(*list->getValues(), list->getKnownType());
+  }
+  return result;
+}
+
+void FunctionMemo::insert(
+    size_t hash, const std::vector<std::shared_ptr<AutumnValue>> &arguments,
+    const std::shared_ptr<AutumnValue> &result) {
+  bool cacheable = isCacheable(result);
+  std::lock_guard<std::mutex> lock(mutex);
+  if (!cacheable) {
+    ++stats.uncached;
+    if (stats.misses == 0 && stats.uncached >= kProbation) {
+      stats.disabled = true;
+    }
+    return;
+  }
+  ++stats.misses;
+  // Arguments that never repeat make every lookup wasted work
+  if (stats.hits == 0 && stats.misses >= kColdMisses * capacity) {
+    stats.disabled = true;
+  }
+  entries.push_front({hash, arguments, result});
+  index.emplace(hash, entries.begin());
+  if (entries.size() > capacity) {
+    auto last = std::prev(entries.end());
+    auto range = index.equal_range(last->hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->second == last) {
+        index.erase(it);
+        break;
+      }
+    }
+    entries.pop_back();
+    ++stats.evictions;
+  }
+}
+
+FunctionMemo::Stats FunctionMemo::getStats() {
+  std::lock_guard<std::mutex> lock(mutex);
+  Stats result = stats;
+  result.entries = entries.size();
+  return result;
+}
+
+} // namespace Autumn
@@ -0,0 +1,80 @@
+#include "InstanceRegistry.hpp"
+#include "AutumnClass.hpp"
+#include "AutumnInstance.hpp"
+#include "Environment.hpp"
+
+namespace Autumn {
+
+// Adds the renderable instances value holds, itself or within lists
+static void collectInstances(const std::shared_ptr<AutumnValue> &value,
+                             ValueList &instances) {
+  if (auto list = dynamic_cast<AutumnList *>(value.get())) {
+    for (const auto &element : *list->getValues()) {
+      collectInstances(element, instances);
+    }
+  } else if (auto instance = dynamic_cast<AutumnInstance *>(value.get())) {
+    if (instance->getClass()->findMethod("render") != nullptr) {
+      instances.push_back(value);
+    }
+  }
+}
+
+ValueList InstanceRegistry::all(Environment &globals) {
+  std::lock_guard<std::mutex> lock(mutex);
+  refresh(globals);
+  return instances;
+}
+
+ValueList InstanceRegistry::ofClass(Environment &globals,
+                                    const std::string &className) {
+  std::lock_guard<std::mutex> lock(mutex);
+  refresh(globals);
+  auto it = classInstances.find(className);
+  return it != classInstances.end() ? it->second : ValueList();
+}
+
+void InstanceRegistry::clear() {
+  std::lock_guard<std::mutex> lock(mutex);
+  scope = nullptr;
+  bindings.clear();
+  instances = ValueList();
+  classInstances.clear();
+}
+
+void InstanceRegistry::refresh(Environment &globals) {
+  if (scope == &globals && version == globals.getBindingVersion()) {
+    return;
+  }
+  if (scope != &globals) {
+    scope = &globals;
+    bindings.clear();
+  }
+  const auto &values = globals.getDefinedVariables();
+  if (bindings.size() > values.size()) {
+    for (auto it = bindings.begin(); it != bindings.end();) {
+      it = values.count(it->first) == 0 ? bindings.erase(it) : std::next(it);
+    }
+  }
+  instances = ValueList();
+  classInstances.clear();
+  for (const auto &[name, value] : values) {
+    Binding &binding = bindings[name];
+    if (binding.value != value) {
+      binding.value = value;
+      binding.instances = ValueList();
+      binding.classInstances.clear();
+      collectInstances(value, binding.instances);
+      for (const auto &instance : binding.instances) {
+        auto object = static_cast<AutumnInstance *>(instance.get());
+        binding.classInstances[object->getClassName()].push_back(instance);
+      }
+    }
+    instances.append(binding.instances);
+    for (const auto &[className, classList] : binding.classInstances) {
+      classInstances[className].append(classList);
+    }
+  }
+  version = globals.getBindingVersion();
+}
+
+} // namespace Autumn
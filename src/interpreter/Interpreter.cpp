@@ -1,5 +1,6 @@
 #include "VarCollector.hpp"
 #include "Interpreter.hpp"
+#include "AstOptimizer.hpp"
 #include "AstPrinter.hpp"
 #include "AutumnCallableValue.hpp"
 #include "AutumnExprValue.hpp"
@@ -12,8 +13,12 @@
 #include "Environment.hpp"
 #include "Expr.hpp"
 #include "Parser.hpp"
+#include "Purity.hpp"
 #include "Stmt.hpp"
+#include "TaskScheduler.hpp"
+#include <algorithm>
 #include <any>
+#include <exception>
 #include <fstream>
 #include <memory>
 #include <unordered_map>
@@ -31,9 +36,216 @@ namespace Autumn {
 Interpreter::Interpreter() {
 }
 
-void Interpreter::init(std::string stdlib) {
+Interpreter::Interpreter(Interpreter &parent, size_t index)
+    : state(parent.state), globals(parent.globals),
+      environment(parent.environment),
+      prev_environment(parent.prev_environment), verbose(parent.verbose),
+      checkedOnce(parent.checkedOnce), optimizeAst(parent.optimizeAst),
+      valuePool(parent.workerPools[index]), parallel(false),
+      root(parent.root) {
+  // Pure lambdas draw no random numbers; a stream of its own keeps a worker
+  // off the parent's generator all the same
+  uint64_t seed = parent.randomGen != nullptr ? parent.randomGen->getSeed() : 0;
+  randomGen = std::make_shared<RandomGenerator>(seed + index + 1);
+}
+
+bool Interpreter::canRunParallel() {
+  return parallel && TaskScheduler::instance().getWorkerCount() > 0;
+}
+
+void Interpreter::parallelFor(
+    const char *label, size_t count,
+    const std::function<void(Interpreter &, size_t, size_t)> &task) {
+  // A few slices per thread, so workers that finish early steal the rest
+  static constexpr size_t kSlicesPerThread = 4;
+  size_t threads = TaskScheduler::instance().getWorkerCount() + 1;
+  size_t slices = std::min(count, threads * kSlicesPerThread);
+  if (!parallel || threads == 1 || slices <= 1) {
+    task(*this, 0, count);
+    return;
+  }
+  while (workerPools.size() < slices) {
+    workerPools.push_back(std::make_shared<ValuePool>());
+  }
+  std::vector<std::exception_ptr> errors(slices);
+  TaskScheduler::TaskGroup group(label);
+  for (size_t i = 0; i < slices; i++) {
+    group.run([&, i] {
+      try {
+        Interpreter worker(*this, i);
+        ValuePool::Scope poolScope(worker.valuePool);
+        worker.valuePool->beginStep();
+        task(worker, count * i / slices, count * (i + 1) / slices);
+      } catch (...) {
+        errors[i] = std::current_exception();
+      }
+    });
+  }
+  group.wait();
+  for (const auto &error : errors) {
+    if (error != nullptr) {
+      std::rethrow_exception(error);
+    }
+  }
+}
+
+void Interpreter::stepAll(const std::vector<Interpreter *> &interpreters) {
+  std::vector<std::exception_ptr> errors(interpreters.size());
+  TaskScheduler::TaskGroup group("step");
+  for (size_t i = 0; i < interpreters.size(); i++) {
+    group.run([&, i] {
+      try {
+        interpreters[i]->step();
+      } catch (...) {
+        errors[i] = std::current_exception();
+      }
+    });
+  }
+  group.wait();
+  for (const auto &error : errors) {
+    if (error != nullptr) {
+      std::rethrow_exception(error);
+    }
+  }
+}
+
+void Interpreter::planNextRuns(const std::vector<std::shared_ptr<Stmt>> &stmts) {
+  std::vector<std::pair<std::string, std::shared_ptr<Expr>>> ordered(
+      nextMap.begin(), nextMap.end());
+  std::vector<std::shared_ptr<Expr>> exprs;
+  for (const auto &[key, expr] : ordered) {
+    exprs.push_back(expr);
+  }
+  std::vector<NextExprEffects> effects = analyzeNextExprs(exprs, stmts, globals);
+
+  // An expression joins the current run unless it reads a variable the run
+  // assigns; one with effects gets a run of its own
+  nextRuns.clear();
+  std::unordered_set<std::string> assigned;
+  std::vector<size_t> loops;
+  for (size_t i = 0; i < ordered.size(); i++) {
+    bool joins = !nextRuns.empty() && effects[i].effectFree &&
+                 nextRuns.back().parallel;
+    for (const auto &name : assigned) {
+      joins = joins && effects[i].reads.count(name) == 0;
+    }
+    if (!joins) {
+      nextRuns.emplace_back();
+      nextRuns.back().parallel = effects[i].effectFree;
+      assigned.clear();
+      loops.push_back(0);
+    }
+    nextRuns.back().exprs.push_back(ordered[i]);
+    assigned.insert(ordered[i].first);
+    loops.back() += effects[i].loops ? 1 : 0;
+  }
+  // Threads only pay off for a run with two expressions that loop
+  for (size_t i = 0; i < nextRuns.size(); i++) {
+    nextRuns[i].parallel = nextRuns[i].parallel && loops[i] >= 2;
+  }
+}
+
+// Adds the values reachable from value that were made since firstId
+static void collectFresh(const std::shared_ptr<AutumnValue> &value,
+                         int firstId, std::vector<AutumnValue *> &fresh) {
+  if (value == nullptr || value->isInterned() ||
+      value->getInstId() < firstId) {
+    return;
+  }
+  fresh.push_back(value.get());
+  if (auto list = std::dynamic_pointer_cast<AutumnList>(value)) {
+    for (const auto &elem : *list->getValues()) {
+      collectFresh(elem, firstId, fresh);
+    }
+  } else if (auto set = std::dynamic_pointer_cast<AutumnSet>(value)) {
+    set->getValues()->forEach(
+        [&](const std::shared_ptr<AutumnValue> &elem, std::nullptr_t) {
+          collectFresh(elem, firstId, fresh);
+        });
+  } else if (auto map = std::dynamic_pointer_cast<AutumnMap>(value)) {
+    map->getValues()->forEach([&](const std::shared_ptr<AutumnValue> &key,
+                                  const std::shared_ptr<AutumnValue> &elem) {
+      collectFresh(key, firstId, fresh);
+      collectFresh(elem, firstId, fresh);
+    });
+  } else if (auto instance = std::dynamic_pointer_cast<AutumnInstance>(value)) {
+    for (const auto &name : instance->getClass()->getFieldNames()) {
+      collectFresh(instance->get(name), firstId, fresh);
+    }
+  }
+}
+
+void Interpreter::stepNextRun(const NextRun &run) {
+  auto allDefineds = environment->getDefinedVariables();
+  std::vector<const std::pair<std::string, std::shared_ptr<Expr>> *> due;
+  for (const auto &entry : run.exprs) {
+    if (!environment->isUpdated(entry.first) &&
+        allDefineds.find(entry.first) != allDefineds.end()) {
+      due.push_back(&entry);
+    }
+  }
+  if (!run.parallel || due.size() < 2) {
+    for (const auto *entry : due) {
+      std::shared_ptr<AutumnValue> value =
+          std::any_cast<std::shared_ptr<AutumnValue>>(
+              entry->second->accept(*this));
+      environment->assign(entry->first, value,
+                          checkedOnce && typeChecker.isProvenNext(entry->first));
+    }
+    return;
+  }
+
+  // Workers share the state while they read it
+  for (const auto &[name, value] : allDefineds) {
+    if (auto list = std::dynamic_pointer_cast<AutumnList>(value)) {
+      list->settleTypes();
+    }
+  }
+  for (const auto &[name, value] : prev_environment->getDefinedVariables()) {
+    if (auto list = std::dynamic_pointer_cast<AutumnList>(value)) {
+      list->settleTypes();
+    }
+  }
+  int firstId = AutumnValue::peekInstId();
+  std::vector<std::shared_ptr<AutumnValue>> values(due.size());
+  std::vector<std::exception_ptr> errors(due.size());
+  parallelFor("next", due.size(),
+              [&](Interpreter &worker, size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) {
+                  try {
+                    values[i] = std::any_cast<std::shared_ptr<AutumnValue>>(
+                        due[i]->second->accept(worker));
+                  } catch (...) {
+                    errors[i] = std::current_exception();
+                  }
+                }
+              });
+
+  // Assign in nextMap order, first giving each value's new objects ids in
+  // the order the sequential loop would have made them
+  for (size_t i = 0; i < due.size(); i++) {
+    if (errors[i] != nullptr) {
+      std::rethrow_exception(errors[i]);
+    }
+    std::vector<AutumnValue *> fresh;
+    collectFresh(values[i], firstId, fresh);
+    std::sort(fresh.begin(), fresh.end(),
+              [](AutumnValue *a, AutumnValue *b) {
+                return a->getInstId() < b->getInstId();
+              });
+    fresh.erase(std::unique(fresh.begin(), fresh.end()), fresh.end());
+    for (AutumnValue *value : fresh) {
+      value->renewInstId();
+    }
+    environment->assign(due[i]->first, values[i],
+                        checkedOnce && typeChecker.isProvenNext(due[i]->first));
+  }
+}
+
+std::vector<std::shared_ptr<Stmt>> Interpreter::init(std::string stdlib) {
   globals = std::make_shared<Environment>();
   environment = globals;
+  instances.clear();
   // Reset onClauseCovered
   onClauseCovered.clear();
   onStmts.clear();
@@ -41,7 +253,7 @@ void Interpreter::init(std::string stdlib) {
 
   std::shared_ptr<AutumnCallable> map = std::make_shared<Map>();
   try {
-    globals->define("GRID_SIZE", std::make_shared<AutumnNumber>(16));
+    globals->define("GRID_SIZE", AutumnNumber::of(16));
     globals->define("map", std::make_shared<AutumnCallableValue>(map));
     globals->define("concat", std::make_shared<AutumnCallableValue>(
                                   std::make_shared<Concat>()));
@@ -104,6 +316,14 @@ void Interpreter::init(std::string stdlib) {
     globals->define("randomPositions",
                     std::make_shared<AutumnCallableValue>(
                         std::make_shared<RandomPositions>()));
+    globals->define("randomFreePos", std::make_shared<AutumnCallableValue>(
+                                         std::make_shared<RandomFreePos>()));
+    globals->define("randomFreePositions",
+                    std::make_shared<AutumnCallableValue>(
+                        std::make_shared<RandomFreePositions>()));
+    globals->define("randomDistinctPositions",
+                    std::make_shared<AutumnCallableValue>(
+                        std::make_shared<RandomDistinctPositions>()));
 
     globals->define("allPositions", std::make_shared<AutumnCallableValue>(
                                         std::make_shared<AllPositions>()));
@@ -123,50 +343,61 @@ void Interpreter::init(std::string stdlib) {
 
     globals->define("allObjs", std::make_shared<AutumnCallableValue>(
                                    std::make_shared<AllObjs>()));
+    globals->define("allObjsOf", std::make_shared<AutumnCallableValue>(
+                                     std::make_shared<AllObjsOf>()));
     globals->define("rotate", std::make_shared<AutumnCallableValue>(
                                   std::make_shared<Rotate>()));
+
+    globals->define("setOf", std::make_shared<AutumnCallableValue>(
+                                 std::make_shared<SetOf>()));
+    globals->define("mapOf", std::make_shared<AutumnCallableValue>(
+                                 std::make_shared<MapOf>()));
+    globals->define("insert", std::make_shared<AutumnCallableValue>(
+                                  std::make_shared<Insert>()));
+    globals->define("remove", std::make_shared<AutumnCallableValue>(
+                                  std::make_shared<Remove>()));
+    globals->define("contains", std::make_shared<AutumnCallableValue>(
+                                    std::make_shared<Contains>()));
+    globals->define("lookup", std::make_shared<AutumnCallableValue>(
+                                  std::make_shared<Lookup>()));
+    globals->define("keys", std::make_shared<AutumnCallableValue>(
+                                std::make_shared<Keys>()));
   } catch (const Error &e) {
     if (getVerbose()) {
       std::cerr << "Error in initializing interpreter: " << e.what() << std::endl;
     }
   }
-  // read AutumnStdLib
+  // read AutumnStdLib; start() runs it
   if (stdlib == "") {
     std::string autumnStdLib = readFile("autumnstdlib/stdlib.sexp");
     SExpParser parser(autumnStdLib);
-    std::vector<std::shared_ptr<Stmt>> stmts = parser.parseStmt();
-    for (const auto &stmt : stmts) {
-      stmt->accept(*this);
-    }
-  } else {
-    SExpParser parser(stdlib);
-    std::vector<std::shared_ptr<Stmt>> stmts = parser.parseStmt();
-    for (const auto &stmt : stmts) {
-      stmt->accept(*this);
-    }
+    return parser.parseStmt();
   }
+  SExpParser parser(stdlib);
+  return parser.parseStmt();
 }
 
 // If need to be evaluated, evaluate as normal
 std::any Interpreter::visitLiteralExpr(std::shared_ptr<Literal> expr) {
-  std::any value = expr->value;
-  // Check if value is a number, a boolean, or a string
-  try {
+  if (expr->constant != nullptr) {
+    return expr->constant;
+  }
+  // Literal built outside the parser: check if value is a number, a boolean,
+  // or a string
+  const std::any &value = expr->value;
+  if (value.type() == typeid(int)) {
     return std::shared_ptr<AutumnValue>(
-        std::make_shared<AutumnNumber>(std::any_cast<int>(value)));
-  } catch (const std::bad_any_cast &) {
-    try {
-      return std::shared_ptr<AutumnValue>(
-          std::make_shared<AutumnBool>(std::any_cast<bool>(value)));
-    } catch (const std::bad_any_cast &) {
-      try {
-        return std::shared_ptr<AutumnValue>(
-            std::make_shared<AutumnString>(std::any_cast<std::string>(value)));
-      } catch (const std::bad_any_cast &) {
-        throw Error("Unknown type of literal");
-      }
-    }
+        AutumnNumber::of(std::any_cast<int>(value)));
+  }
+  if (value.type() == typeid(bool)) {
+    return std::shared_ptr<AutumnValue>(
+        AutumnBool::of(std::any_cast<bool>(value)));
+  }
+  if (value.type() == typeid(std::string)) {
+    return std::shared_ptr<AutumnValue>(
+        std::make_shared<AutumnString>(std::any_cast<std::string>(value)));
   }
+  throw Error("Unknown type of literal");
 }
 
 std::any Interpreter::visitGroupingExpr(std::shared_ptr<Grouping> expr) {
@@ -190,7 +421,7 @@ std::any Interpreter::visitUnaryExpr(std::shared_ptr<Unary> expr) {
     }
     // std::cerr << "Unary -" << rightNumber->getNumber() << std::endl;
     return std::shared_ptr<AutumnValue>(
-        std::make_shared<AutumnNumber>(-rightNumber->getNumber()));
+        AutumnNumber::of(-rightNumber->getNumber()));
   }
   case TokenType::PLUS: {
     std::shared_ptr<AutumnNumber> rightNumber =
@@ -200,7 +431,7 @@ std::any Interpreter::visitUnaryExpr(std::shared_ptr<Unary> expr) {
     }
     // std::cerr << "Unary +" << rightNumber->getNumber() << std::endl;
     return std::shared_ptr<AutumnValue>(
-        std::make_shared<AutumnNumber>(rightNumber->getNumber()));
+        AutumnNumber::of(rightNumber->getNumber()));
   }
   case TokenType::BANG: {
     std::shared_ptr<AutumnBool> rightBool =
@@ -208,7 +439,7 @@ std::any Interpreter::visitUnaryExpr(std::shared_ptr<Unary> expr) {
     if (rightBool == nullptr) {
       throw Error("Unary ! must be applied to a boolean");
     }
-    auto res = std::make_shared<AutumnBool>(!rightBool->getBool());
+    auto res = AutumnBool::of(!rightBool->getBool());
     // std::cerr << "Unary !" << rightBool->getBool() << " = " << res->getBool()
     //          << std::endl;
     return std::dynamic_pointer_cast<AutumnValue>(res);
@@ -256,7 +487,7 @@ std::any Interpreter::visitBinaryExpr(std::shared_ptr<Binary> expr) {
     try{
       std::pair<std::shared_ptr<AutumnNumber>, std::shared_ptr<AutumnNumber>>
           numbers = getBinaryNumber(left, right);
-      res = std::make_shared<AutumnNumber>(numbers.first->getNumber() +
+      res = AutumnNumber::of(numbers.first->getNumber() +
                                           numbers.second->getNumber());
     } catch (const Error &e) {
       throw Error("Binary + must be applied to two numbers, instead got " +
@@ -268,7 +499,7 @@ std::any Interpreter::visitBinaryExpr(std::shared_ptr<Binary> expr) {
     try{
       std::pair<std::shared_ptr<AutumnNumber>, std::shared_ptr<AutumnNumber>>
           numbers = getBinaryNumber(left, right);
-      res = std::make_shared<AutumnNumber>(numbers.first->getNumber() -
+      res = AutumnNumber::of(numbers.first->getNumber() -
                                          numbers.second->getNumber());
     } catch (const Error &e) {
       throw Error("Binary - must be applied to two numbers, instead got " +
@@ -280,7 +511,7 @@ std::any Interpreter::visitBinaryExpr(std::shared_ptr<Binary> expr) {
     try{
       std::pair<std::shared_ptr<AutumnNumber>, std::shared_ptr<AutumnNumber>>
           numbers = getBinaryNumber(left, right);
-      res = std::make_shared<AutumnNumber>(numbers.first->getNumber() *
+      res = AutumnNumber::of(numbers.first->getNumber() *
                                          numbers.second->getNumber());
     } catch (const Error &e) {
       throw Error("Binary * must be applied to two numbers, instead got " +
@@ -292,7 +523,7 @@ std::any Interpreter::visitBinaryExpr(std::shared_ptr<Binary> expr) {
     try{
       std::pair<std::shared_ptr<AutumnNumber>, std::shared_ptr<AutumnNumber>>
           numbers = getBinaryNumber(left, right);
-      res = std::make_shared<AutumnNumber>(numbers.first->getNumber() /
+      res = AutumnNumber::of(numbers.first->getNumber() /
                                          numbers.second->getNumber());
     } catch (const Error &e) {
       throw Error("Binary / must be applied to two numbers, instead got " +
@@ -304,7 +535,7 @@ std::any Interpreter::visitBinaryExpr(std::shared_ptr<Binary> expr) {
     try{
       std::pair<std::shared_ptr<AutumnNumber>, std::shared_ptr<AutumnNumber>>
         numbers = getBinaryNumber(left, right);
-      res = std::make_shared<AutumnNumber>(numbers.first->getNumber() %
+      res = AutumnNumber::of(numbers.first->getNumber() %
                                          numbers.second->getNumber());
     } catch (const Error &e) {
       throw Error("Binary % must be applied to two numbers, instead got " +
@@ -316,7 +547,7 @@ std::any Interpreter::visitBinaryExpr(std::shared_ptr<Binary> expr) {
     try{
       std::pair<std::shared_ptr<AutumnNumber>, std::shared_ptr<AutumnNumber>>
         numbers = getBinaryNumber(left, right);
-      res = std::make_shared<AutumnBool>(numbers.first->getNumber() >
+      res = AutumnBool::of(numbers.first->getNumber() >
                                          numbers.second->getNumber());
     } catch (const Error &e) {
       throw Error("Binary > must be applied to two numbers, instead got " +
@@ -328,7 +559,7 @@ std::any Interpreter::visitBinaryExpr(std::shared_ptr<Binary> expr) {
     try{
       std::pair<std::shared_ptr<AutumnNumber>, std::shared_ptr<AutumnNumber>>
         numbers = getBinaryNumber(left, right);
-      res = std::make_shared<AutumnBool>(numbers.first->getNumber() >=
+      res = AutumnBool::of(numbers.first->getNumber() >=
                                          numbers.second->getNumber());
     } catch (const Error &e) {
       throw Error("Binary >= must be applied to two numbers, instead got " +
@@ -340,7 +571,7 @@ std::any Interpreter::visitBinaryExpr(std::shared_ptr<Binary> expr) {
     try{
       std::pair<std::shared_ptr<AutumnNumber>, std::shared_ptr<AutumnNumber>>
         numbers = getBinaryNumber(left, right);
-      res = std::make_shared<AutumnBool>(numbers.first->getNumber() <
+      res = AutumnBool::of(numbers.first->getNumber() <
                                        numbers.second->getNumber());
     } catch (const Error &e) {
       throw Error("Binary < must be applied to two numbers, instead got " +
@@ -352,7 +583,7 @@ std::any Interpreter::visitBinaryExpr(std::shared_ptr<Binary> expr) {
     try { 
       std::pair<std::shared_ptr<AutumnNumber>, std::shared_ptr<AutumnNumber>>
           numbers = getBinaryNumber(left, right);
-      res = std::make_shared<AutumnBool>(numbers.first->getNumber() <=
+      res = AutumnBool::of(numbers.first->getNumber() <=
                                          numbers.second->getNumber());
     } catch (const Error &e) {
       throw Error("Binary <= must be applied to two numbers, instead got " +
@@ -365,7 +596,7 @@ std::any Interpreter::visitBinaryExpr(std::shared_ptr<Binary> expr) {
       // std::cout << "Comparing " << left->toString() << " and "
       //          << right->toString() << std::endl;
       res = std::dynamic_pointer_cast<AutumnValue>(
-          std::make_shared<AutumnBool>(left->isEqual(right)));
+          AutumnBool::of(left->isEqual(right)));
       return res;
       // std::cout << "Result: " << res->toString() << std::endl;
       break;
@@ -376,7 +607,7 @@ std::any Interpreter::visitBinaryExpr(std::shared_ptr<Binary> expr) {
   case TokenType::BANG_EQUAL: {
     try {
       res = std::dynamic_pointer_cast<AutumnValue>(
-          std::make_shared<AutumnBool>(!left->isEqual(right)));
+          AutumnBool::of(!left->isEqual(right)));
       return res;
     } catch (const std::bad_any_cast &e) {
       throw Error("Cannot compare different types");
@@ -423,6 +654,7 @@ std::any Interpreter::visitAssignExpr(std::shared_ptr<Assign> expr) {
     initOrder.push_back(expr->name.lexeme);
     initMap[expr->name.lexeme] = initNext->initializer;
     nextMap[expr->name.lexeme] = initNext->nextExpr;
+    nextRuns.clear();
     return nullptr;
   }
 
@@ -434,16 +666,19 @@ std::any Interpreter::visitAssignExpr(std::shared_ptr<Assign> expr) {
     // Get type value
     std::shared_ptr<AutumnType> tv =
         environment->getAssignedType(expr->name.lexeme);
-    if (tv != nullptr &&
-        std::dynamic_pointer_cast<AutumnListType>(tv) == nullptr) {
-      if (tv->toString() != value->getType()->toString()) {
+    bool proven = isProven(expr.get());
+    if (!proven && tv != nullptr &&
+        std::dynamic_pointer_cast<AutumnListType>(tv) == nullptr &&
+        std::dynamic_pointer_cast<AutumnSetType>(tv) == nullptr &&
+        std::dynamic_pointer_cast<AutumnMapType>(tv) == nullptr) {
+      if (!AutumnType::sameType(tv.get(), value->getType().get())) {
         throw Error("Cannot assign value of type '" +
                     value->getType()->toString() + "' to variable of type '" +
                     tv->toString() + "' for variable '" + expr->name.lexeme +
                     "'.");
       }
     }
-    environment->assign(expr->name, value);
+    environment->assign(expr->name, value, proven);
     if (environment != globals && !isNameInGlobal) {
       if (globals->isDefined(expr->name.lexeme)) {
         throw Error("Variable assigned at local scope became defined at global "
@@ -474,7 +709,7 @@ std::any Interpreter::visitLogicalExpr(std::shared_ptr<Logical> expr) {
   if (expr->op.type == TokenType::OR) {
     if (isTruthy(left)) {
       ret = std::dynamic_pointer_cast<AutumnValue>(
-          std::make_shared<AutumnBool>(true));
+          AutumnBool::of(true));
       // std::cerr << "Returning from logical: " << ret->toString() <<
       // std::endl;
       return ret;
@@ -482,7 +717,7 @@ std::any Interpreter::visitLogicalExpr(std::shared_ptr<Logical> expr) {
   } else {
     if (!isTruthy(left)) {
       ret = std::dynamic_pointer_cast<AutumnValue>(
-          std::make_shared<AutumnBool>(false));
+          AutumnBool::of(false));
       // std::cerr << "Returning from logical: " << ret->toString() <<
       // std::endl;
       return ret;
@@ -497,7 +732,7 @@ std::any Interpreter::visitLogicalExpr(std::shared_ptr<Logical> expr) {
       rightValue = callableRight->call(*this, {});
     }
     return std::dynamic_pointer_cast<AutumnValue>(
-        std::make_shared<AutumnBool>(rightValue->isTruthy()));
+        AutumnBool::of(rightValue->isTruthy()));
   } catch (const std::bad_any_cast &e) {
     // std::cerr << "Logical operator must be applied to a value" << std::endl;
     throw Error("Logical operator must be applied to a value" +
@@ -505,33 +740,49 @@ std::any Interpreter::visitLogicalExpr(std::shared_ptr<Logical> expr) {
   }
 }
 
-static std::shared_ptr<std::vector<std::shared_ptr<AutumnValue>>>
-getAllArgs(std::shared_ptr<Call> expr, Interpreter &interpreter) {
+// Adds the context of a failing argument of expr
+static void wrapArgumentError(Error &e, const std::shared_ptr<Call> &expr) {
+  e.wrap([expr](const std::string &what) {
+    return "Call argument processing error while visiting: \n" +
+           AstPrinter().print(expr) + "\n Got: \n" + what;
+  });
+}
+
+static std::vector<std::shared_ptr<AutumnValue>>
+getAllArgs(const std::shared_ptr<Call> &expr, Interpreter &interpreter) {
   std::vector<std::shared_ptr<AutumnValue>> arguments;
-  int i = 0;
+  arguments.reserve(expr->arguments.size());
   for (const auto &argument : expr->arguments) {
     try {
       arguments.push_back(std::any_cast<std::shared_ptr<AutumnValue>>(
           argument->accept(interpreter)));
     } catch (const std::bad_any_cast &e) {
       throw Error("Call arguments must be values");
-    } catch (const Error &e) {
-      throw Error("Call argument processing error while visiting: \n" +
-                  AstPrinter().print(expr) + "\n Got: \n" + e.what());
+    } catch (Error &e) {
+      wrapArgumentError(e, expr);
+      throw;
     }
   }
-  return std::make_shared<std::vector<std::shared_ptr<AutumnValue>>>(arguments);
+  return arguments;
 }
 
 
 std::any Interpreter::visitCallExpr(std::shared_ptr<Call> expr) {
-  AstPrinter printer;
+  if (expr->stepMemoSlot >= 0 && stepMemo.isActive()) {
+    return stepMemo.evaluate(expr->stepMemoSlot,
+                             [&] { return evaluateCall(expr); });
+  }
+  return evaluateCall(expr);
+}
+
+std::any Interpreter::evaluateCall(const std::shared_ptr<Call> &expr) {
   std::any callee = expr->callee->accept(*this);
 
+  // Probe the callee's kind without throwing: most calls are not classes
+  auto ptv = std::any_cast<std::shared_ptr<AutumnType>>(&callee);
   try {
-    std::shared_ptr<AutumnType> tv =
-        std::any_cast<std::shared_ptr<AutumnType>>(callee);
-    if (tv != nullptr) {
+    if (ptv != nullptr && *ptv != nullptr) {
+      const std::shared_ptr<AutumnType> &tv = *ptv;
       // Check if this is a class
       std::shared_ptr<AutumnClass> cls =
           std::dynamic_pointer_cast<AutumnClass>(tv);
@@ -543,10 +794,6 @@ std::any Interpreter::visitCallExpr(std::shared_ptr<Call> expr) {
             auto subVarExprs = std::any_cast<std::shared_ptr<std::vector<std::string>>>(arg->accept(collector));
             varExprs->insert(varExprs->end(), subVarExprs->begin(), subVarExprs->end());
           }
-          for (const auto &arg : expr->arguments) {
-            auto subVarExprs = std::any_cast<std::shared_ptr<std::vector<std::string>>>(arg->accept(collector));
-            varExprs->insert(varExprs->end(), subVarExprs->begin(), subVarExprs->end());
-          }
           // std::cout << "VarExprs: " << varExprs->size() << std::endl;
           // for (const auto &varExpr : *varExprs) {
           //   std::cout << "VarExpr: " << varExpr << std::endl;
@@ -591,7 +838,7 @@ std::any Interpreter::visitCallExpr(std::shared_ptr<Call> expr) {
               auto pNumber = std::dynamic_pointer_cast<AutumnNumber>(pValue);
               if (pNumber != nullptr) {
                 cellArgs.push_back(std::make_shared<AutumnExprValue>(
-                    std::make_shared<Literal>(pNumber->getNumber()), subEnv));
+                    SExpParser::makeLiteral(pNumber->getNumber()), subEnv));
                 continue;
               }
               cellArgs.push_back(exprValue);
@@ -601,15 +848,30 @@ std::any Interpreter::visitCallExpr(std::shared_ptr<Call> expr) {
           }
           this->setEnvironment(currEnv);
           return std::dynamic_pointer_cast<AutumnValue>(
-              std::make_shared<AutumnInstance>(cls, cellArgs));
+              makeValue<AutumnInstance>(cls, cellArgs));
         }
         // First get all the argument
-        auto arguments = getAllArgs(expr, *this);
+        auto args = getAllArgs(expr, *this);
+        if (cls == PositionClass && args.size() == 2) {
+          auto x = dynamic_cast<AutumnNumber *>(args[0].get());
+          auto y = dynamic_cast<AutumnNumber *>(args[1].get());
+          if (x != nullptr && y != nullptr) {
+            return std::shared_ptr<AutumnValue>(
+                makePosition(x->getNumber(), y->getNumber()));
+          }
+        }
         try {
-          std::vector<std::shared_ptr<AutumnValue>> args = *arguments;
+          // A proven call has checked user fields and origin; elems comes
+          // from the cell expression and is still checked
+          size_t trustedFields = 0;
+          if (isProven(expr.get())) {
+            trustedFields = cls->getInitializer() != nullptr
+                                ? cls->getFieldNames().size() - 1
+                                : cls->getFieldNames().size();
+          }
           if (cls->getInitializer() != nullptr) {
             std::shared_ptr<AutumnValue> pValue =
-                cls->getInitializer()->call(*this, *arguments);
+                cls->getInitializer()->call(*this, args);
             std::shared_ptr<AutumnList> list =
                 std::dynamic_pointer_cast<AutumnList>(pValue);
             if (list != nullptr) {
@@ -618,13 +880,14 @@ std::any Interpreter::visitCallExpr(std::shared_ptr<Call> expr) {
             }
           }
           auto retVal = std::dynamic_pointer_cast<AutumnValue>(
-              std::make_shared<AutumnInstance>(cls, args));
+              makeValue<AutumnInstance>(cls, std::move(args), trustedFields));
           return retVal;
-        } catch (const Error &e) {
-          throw Error(
-              std::string(
-                  "DEBUG: Cannot instantiate class without initializer") +
-              e.what());
+        } catch (Error &e) {
+          e.wrap([](const std::string &what) {
+            return "DEBUG: Cannot instantiate class without initializer" +
+                   what;
+          });
+          throw;
         }
       }
     }
@@ -657,15 +920,18 @@ std::any Interpreter::visitCallExpr(std::shared_ptr<Call> expr) {
   } catch (Error &e) {
     std::shared_ptr<AutumnExprValue> exprValue =
         std::dynamic_pointer_cast<AutumnExprValue>(calleeVal);
-    throw Error(std::string("Error in visiting evaluation of expression: ") + AstPrinter().print(exprValue->getExpr()) + "\n" +
-                e.what());
+    e.wrap([exprValue](const std::string &what) {
+      return "Error in visiting evaluation of expression: " +
+             AstPrinter().print(exprValue->getExpr()) + "\n" + what;
+    });
+    throw;
   }
   std::shared_ptr<AutumnCallableValue> callable =
       std::dynamic_pointer_cast<AutumnCallableValue>(calleeVal);
   if (callable == nullptr) {
     throw Error("Can only call functions and classes");
   }
-  if (callable->toString() == "<native fn: Prev>" || callable->toString() == "<native fn: <native fn: Prev>>") {
+  if (dynamic_cast<Prev *>(callable->callable.get()) != nullptr) {
     // Do not evaluate the arguments
     if (expr->arguments.size() != 1) {
       throw Error("[Prev] Prev() takes 1 argument");
@@ -674,7 +940,7 @@ std::any Interpreter::visitCallExpr(std::shared_ptr<Call> expr) {
     if (varExpr == nullptr) { // This is already a string
       std::shared_ptr<AutumnValue> retVal =
         std::any_cast<std::shared_ptr<AutumnValue>>(
-            callable->call(*this, *getAllArgs(expr, *this)));
+            callable->call(*this, getAllArgs(expr, *this)));
       return retVal;
     }
     std::shared_ptr<AutumnValue> varName = std::make_shared<AutumnString>(varExpr->name.lexeme);
@@ -684,14 +950,424 @@ std::any Interpreter::visitCallExpr(std::shared_ptr<Call> expr) {
     return retVal;
   }
   else {
+    std::shared_ptr<AutumnValue> fused;
+    if (evaluateFused(expr, callable->callable.get(), fused)) {
+      return fused;
+    }
+    auto args = getAllArgs(expr, *this);
+    callSite = expr->site;
     std::shared_ptr<AutumnValue> retVal =
         std::any_cast<std::shared_ptr<AutumnValue>>(
-            callable->call(*this, *getAllArgs(expr, *this)));
+            callable->call(*this, args));
     return retVal;
   }
 }
 
+namespace {
+// The builtins a fused chain is made of
+enum class ChainBuiltin {
+  NONE,
+  RANGE,
+  MAP,
+  FILTER,
+  CONCAT,
+  LENGTH,
+  FOLDL,
+};
+
+ChainBuiltin chainBuiltin(const AutumnCallable *callable) {
+  if (dynamic_cast<const Range *>(callable) != nullptr) {
+    return ChainBuiltin::RANGE;
+  }
+  if (dynamic_cast<const Map *>(callable) != nullptr) {
+    return ChainBuiltin::MAP;
+  }
+  if (dynamic_cast<const Filter *>(callable) != nullptr) {
+    return ChainBuiltin::FILTER;
+  }
+  if (dynamic_cast<const Concat *>(callable) != nullptr) {
+    return ChainBuiltin::CONCAT;
+  }
+  if (dynamic_cast<const Length *>(callable) != nullptr) {
+    return ChainBuiltin::LENGTH;
+  }
+  if (dynamic_cast<const Foldl *>(callable) != nullptr) {
+    return ChainBuiltin::FOLDL;
+  }
+  return ChainBuiltin::NONE;
+}
+
+// Which argument of a call with count arguments is the list, or -1 when
+// such a call is not part of a chain
+int chainListIndex(ChainBuiltin builtin, size_t count) {
+  switch (builtin) {
+  case ChainBuiltin::MAP:
+  case ChainBuiltin::FILTER:
+    return count == 2 ? 1 : -1;
+  case ChainBuiltin::CONCAT:
+  case ChainBuiltin::LENGTH:
+    return count == 1 ? 0 : -1;
+  case ChainBuiltin::FOLDL:
+    return count == 3 ? 2 : -1;
+  default:
+    return -1;
+  }
+}
+
+// A map, filter or concat of a chain
+struct ChainStage {
+  ChainBuiltin kind;
+  std::shared_ptr<Call> call;
+  std::shared_ptr<AutumnCallableValue> builtin;
+  // What map and filter call
+  std::shared_ptr<AutumnCallableValue> function;
+  // Calls around this one in the chain
+  size_t depth = 0;
+};
+
+// The callable a variable names, looked up without the side effects of
+// evaluating it
+std::shared_ptr<AutumnCallableValue>
+namedCallable(const std::shared_ptr<Expr> &expr, Environment &environment) {
+  auto variable = std::dynamic_pointer_cast<Variable>(expr);
+  if (variable == nullptr ||
+      environment.getTypeValue(variable->name) != nullptr) {
+    return nullptr;
+  }
+  try {
+    return std::dynamic_pointer_cast<AutumnCallableValue>(
+        environment.get(variable->name));
+  } catch (const Error &) {
+    return nullptr;
+  }
+}
+
+// Whether calling what expr evaluates to has no effect, told without
+// evaluating it
+bool isEffectFreeFunction(const std::shared_ptr<Expr> &expr,
+                          Environment &environment) {
+  if (auto lambda = std::dynamic_pointer_cast<Lambda>(expr)) {
+    return lambda->effectFree;
+  }
+  auto callable = namedCallable(expr, environment);
+  if (callable == nullptr) {
+    return false;
+  }
+  if (auto lambda = dynamic_cast<AutumnLambda *>(callable->callable.get())) {
+    return lambda->getDeclaration()->effectFree;
+  }
+  BuiltinEffect effect = builtinEffect(callable->callable.get());
+  return effect != BuiltinEffect::IMPURE &&
+         effect != BuiltinEffect::HIGHER_ORDER;
+}
+} // namespace
+
+bool Interpreter::evaluateFused(const std::shared_ptr<Call> &expr,
+                                AutumnCallable *builtin,
+                                std::shared_ptr<AutumnValue> &result) {
+  ChainBuiltin consumer = chainBuiltin(builtin);
+  int listIndex = chainListIndex(consumer, expr->arguments.size());
+  if (listIndex < 0) {
+    return false;
+  }
+  bool callsFunction = consumer == ChainBuiltin::MAP ||
+                       consumer == ChainBuiltin::FILTER ||
+                       consumer == ChainBuiltin::FOLDL;
+  // Calls of the stages interleave, so none of them may have an effect
+  if (callsFunction &&
+      !isEffectFreeFunction(expr->arguments[0], *environment)) {
+    return false;
+  }
+
+  // Stages from the outermost in, down to a range call or any other list
+  std::vector<ChainStage> stages;
+  std::shared_ptr<Call> range;
+  std::shared_ptr<AutumnCallableValue> rangeBuiltin;
+  std::shared_ptr<Expr> source = expr->arguments[listIndex];
+  while (auto call = std::dynamic_pointer_cast<Call>(source)) {
+    // A list the step shares is cheaper to reuse than to redo
+    if (call->stepMemoSlot >= 0 && stepMemo.isActive()) {
+      break;
+    }
+    auto callee = namedCallable(call->callee, *environment);
+    if (callee == nullptr) {
+      break;
+    }
+    ChainBuiltin kind = chainBuiltin(callee->callable.get());
+    if (kind == ChainBuiltin::RANGE && call->arguments.size() == 2) {
+      range = call;
+      rangeBuiltin = callee;
+      break;
+    }
+    if (kind != ChainBuiltin::MAP && kind != ChainBuiltin::FILTER &&
+        kind != ChainBuiltin::CONCAT) {
+      break;
+    }
+    int index = chainListIndex(kind, call->arguments.size());
+    if (index < 0 || (kind != ChainBuiltin::CONCAT &&
+                      !isEffectFreeFunction(call->arguments[0],
+                                            *environment))) {
+      break;
+    }
+    stages.push_back({kind, call, callee, nullptr, stages.size() + 1});
+    source = call->arguments[index];
+  }
+  if (stages.empty() && range == nullptr) {
+    return false;
+  }
+
+  // The calls of the chain from expr in. An error inside one of them gets
+  // the context of every call around it, as getAllArgs adds one by one.
+  std::vector<std::shared_ptr<Call>> calls = {expr};
+  for (const auto &stage : stages) {
+    calls.push_back(stage.call);
+  }
+  if (range != nullptr) {
+    calls.push_back(range);
+  }
+  auto wrapWithin = [&calls](Error &e, size_t depth) {
+    while (depth > 0) {
+      wrapArgumentError(e, calls[--depth]);
+    }
+  };
+
+  // Evaluate every argument once, in the order the calls one by one would
+  auto evaluateValue = [this, &wrapWithin](const std::shared_ptr<Expr> &argument,
+                                           size_t owner) {
+    std::any value;
+    try {
+      value = argument->accept(*this);
+    } catch (Error &e) {
+      wrapWithin(e, owner + 1);
+      throw;
+    }
+    try {
+      return std::any_cast<std::shared_ptr<AutumnValue>>(value);
+    } catch (const std::bad_any_cast &) {
+      Error error("Call arguments must be values");
+      wrapWithin(error, owner);
+      throw error;
+    }
+  };
+  std::vector<std::shared_ptr<AutumnValue>> args(expr->arguments.size());
+  for (int i = 0; i < listIndex; i++) {
+    args[i] = evaluateValue(expr->arguments[i], 0);
+  }
+  for (auto &stage : stages) {
+    if (stage.kind != ChainBuiltin::CONCAT) {
+      stage.function = std::dynamic_pointer_cast<AutumnCallableValue>(
+          evaluateValue(stage.call->arguments[0], stage.depth));
+    }
+  }
+  std::vector<std::shared_ptr<AutumnValue>> rangeArgs;
+  std::shared_ptr<AutumnValue> sourceValue;
+  std::shared_ptr<AutumnList> list;
+  int start = 0;
+  int end = 0;
+  bool fusable;
+  size_t count;
+  if (range != nullptr) {
+    rangeArgs = {evaluateValue(range->arguments[0], stages.size() + 1),
+                 evaluateValue(range->arguments[1], stages.size() + 1)};
+    auto from = dynamic_cast<AutumnNumber *>(rangeArgs[0].get());
+    auto to = dynamic_cast<AutumnNumber *>(rangeArgs[1].get());
+    fusable = from != nullptr && to != nullptr;
+    if (fusable) {
+      start = from->getNumber();
+      end = to->getNumber();
+    }
+    count = end > start ? end - start : 0;
+  } else {
+    sourceValue = evaluateValue(source, stages.size());
+    list = std::dynamic_pointer_cast<AutumnList>(sourceValue);
+    fusable = list != nullptr;
+    count = fusable ? list->getValues()->size() : 0;
+  }
+
+  // Runs the builtins one by one on the arguments evaluated above
+  auto evaluateStaged = [&]() {
+    std::shared_ptr<AutumnValue> values = sourceValue;
+    if (range != nullptr) {
+      try {
+        values = rangeBuiltin->call(*this, rangeArgs);
+      } catch (Error &e) {
+        wrapWithin(e, stages.size() + 1);
+        throw;
+      }
+    }
+    for (auto stage = stages.rbegin(); stage != stages.rend(); ++stage) {
+      try {
+        if (stage->kind == ChainBuiltin::CONCAT) {
+          values = stage->builtin->call(*this, {values});
+        } else {
+          values = stage->builtin->call(*this, {stage->function, values});
+        }
+      } catch (Error &e) {
+        wrapWithin(e, stage->depth);
+        throw;
+      }
+    }
+    args[listIndex] = values;
+    return builtin->call(*this, args);
+  };
+
+  // Long chains go stage by stage so that each stage may split across
+  // threads, and so do bad arguments, which the builtins report
+  if (!fusable || (count >= kParallelMinSize && canRunParallel())) {
+    result = evaluateStaged();
+    return true;
+  }
+
+  // The consumer then takes each element the stages let through. Every
+  // consumer reads the whole list, so the pass ends where the calls one by
+  // one would have.
+  using Sink = std::function<void(const std::shared_ptr<AutumnValue> &)>;
+  Sink sink;
+  ValueList collected;
+  size_t length = 0;
+  std::shared_ptr<AutumnValue> acc;
+  std::vector<std::shared_ptr<AutumnValue>> callArgs(1);
+  auto function = std::dynamic_pointer_cast<AutumnCallableValue>(args[0]);
+  switch (consumer) {
+  case ChainBuiltin::LENGTH:
+    sink = [&](const std::shared_ptr<AutumnValue> &) { length++; };
+    break;
+  case ChainBuiltin::FOLDL:
+    acc = args[1];
+    callArgs.resize(2);
+    sink = [&](const std::shared_ptr<AutumnValue> &value) {
+      callArgs[0] = acc;
+      callArgs[1] = value;
+      acc = function->call(*this, callArgs);
+    };
+    break;
+  default:
+    sink = [&](const std::shared_ptr<AutumnValue> &value) {
+      collected.push_back(value);
+    };
+    break;
+  }
+  std::vector<ChainStage> pipeline = stages;
+  if (consumer != ChainBuiltin::LENGTH && consumer != ChainBuiltin::FOLDL) {
+    pipeline.insert(pipeline.begin(), {consumer, expr, nullptr, function, 0});
+  }
+  for (const auto &stage : pipeline) {
+    Sink next = std::move(sink);
+    auto stageFunction = stage.function;
+    size_t depth = stage.depth;
+    std::vector<std::shared_ptr<AutumnValue>> stageArgs(1);
+    // What the stage's builtin would have returned for value
+    auto apply = [this, stageFunction, stageArgs, depth, &wrapWithin](
+                     const std::shared_ptr<AutumnValue> &value) mutable {
+      stageArgs[0] = value;
+      try {
+        return stageFunction->call(*this, stageArgs);
+      } catch (Error &e) {
+        wrapWithin(e, depth);
+        throw;
+      }
+    };
+    switch (stage.kind) {
+    case ChainBuiltin::MAP:
+      sink = [next, apply](const std::shared_ptr<AutumnValue> &value) mutable {
+        next(apply(value));
+      };
+      break;
+    case ChainBuiltin::FILTER:
+      sink = [next, apply](const std::shared_ptr<AutumnValue> &value) mutable {
+        if (apply(value)->isTruthy()) {
+          next(value);
+        }
+      };
+      break;
+    default:
+      sink = [next, depth,
+              &wrapWithin](const std::shared_ptr<AutumnValue> &value) {
+        auto inner = std::dynamic_pointer_cast<AutumnList>(value);
+        if (inner == nullptr) {
+          Error error("Concat() arguments must be a list of lists");
+          wrapWithin(error, depth);
+          throw error;
+        }
+        for (const auto &element : *inner->getValues()) {
+          next(element);
+        }
+      };
+      break;
+    }
+  }
+
+  // The pass calls the stages element by element, while the builtins would
+  // finish each stage first. When a call fails, the stages run again one by
+  // one, none of them having an effect, to raise the error the builtins
+  // would have raised first.
+  try {
+    if (range != nullptr) {
+      for (int i = start; i < end; i++) {
+        sink(AutumnNumber::of(i));
+      }
+    } else {
+      for (const auto &value : *list->getValues()) {
+        sink(value);
+      }
+    }
+  } catch (const std::exception &) {
+    result = evaluateStaged();
+    return true;
+  }
+
+  switch (consumer) {
+  case ChainBuiltin::LENGTH:
+    result = AutumnNumber::of(length);
+    break;
+  case ChainBuiltin::FOLDL:
+    result = acc;
+    break;
+  default: {
+    // The element type each builtin would have given its list
+    std::shared_ptr<AutumnType> type =
+        range != nullptr
+            ? AutumnListType::getInstance(AutumnNumberType::getInstance())
+            : list->getKnownType();
+    for (auto stage = pipeline.rbegin(); stage != pipeline.rend(); ++stage) {
+      if (stage->kind == ChainBuiltin::MAP) {
+        type = nullptr;
+      } else if (stage->kind == ChainBuiltin::CONCAT) {
+        auto outer = std::dynamic_pointer_cast<AutumnListType>(type);
+        type = outer != nullptr && std::dynamic_pointer_cast<AutumnListType>(
+                                       outer->getElementType())
+                   ? outer->getElementType()
+                   : nullptr;
+      }
+    }
+    result = makeValue<AutumnList>(collected, type);
+    break;
+  }
+  }
+  return true;
+}
+
+int Interpreter::getGridSize() {
+  if (!root->gridSizeShadowable && globals->getGridSize() >= 0) {
+    return globals->getGridSize();
+  }
+  auto size =
+      std::dynamic_pointer_cast<AutumnNumber>(environment->get("GRID_SIZE"));
+  if (size == nullptr) {
+    throw Error("GRID_SIZE must be a number");
+  }
+  return size->getNumber();
+}
+
 std::any Interpreter::visitGetExpr(std::shared_ptr<Get> expr) {
+  if (expr->stepMemoSlot >= 0 && stepMemo.isActive()) {
+    return stepMemo.evaluate(expr->stepMemoSlot,
+                             [&] { return evaluateGet(expr); });
+  }
+  return evaluateGet(expr);
+}
+
+std::any Interpreter::evaluateGet(const std::shared_ptr<Get> &expr) {
   // std::cerr << "Visiting get: " << expr->name.lexeme << std::endl;
   std::shared_ptr<AutumnValue> object =
       std::any_cast<std::shared_ptr<AutumnValue>>(expr->object->accept(*this));
@@ -733,7 +1409,6 @@ std::any Interpreter::visitSetExpr(std::shared_ptr<Set> expr) {
 }
 
 std::any Interpreter::visitLambdaExpr(std::shared_ptr<Lambda> expr) {
-  AstPrinter printer;
   // std::cerr << "Visiting lambda: "
   //           << std::any_cast<std::string>(expr->accept(printer)) <<
   //           std::endl;
@@ -794,6 +1469,41 @@ Interpreter::visitListTypeExprExpr(std::shared_ptr<ListTypeExpr> expr) {
   }
 }
 
+std::any Interpreter::visitSetTypeExprExpr(std::shared_ptr<SetTypeExpr> expr) {
+  try {
+    std::shared_ptr<AutumnType> ntype =
+        std::any_cast<std::shared_ptr<AutumnType>>(
+            expr->typeexpr->accept(*this));
+    if (ntype == nullptr) {
+      throw Error("Set type must have a type, instead got" +
+                  AstPrinter().print(expr));
+    }
+    return std::shared_ptr<AutumnType>(AutumnSetType::getInstance(ntype));
+  } catch (const std::bad_any_cast &e) {
+    throw Error("Set type must have a type" + AstPrinter().print(expr));
+  }
+}
+
+std::any Interpreter::visitMapTypeExprExpr(std::shared_ptr<MapTypeExpr> expr) {
+  try {
+    std::shared_ptr<AutumnType> keyType =
+        std::any_cast<std::shared_ptr<AutumnType>>(
+            expr->keytypeexpr->accept(*this));
+    std::shared_ptr<AutumnType> valueType =
+        std::any_cast<std::shared_ptr<AutumnType>>(
+            expr->valuetypeexpr->accept(*this));
+    if (keyType == nullptr || valueType == nullptr) {
+      throw Error("Map type must have a key and a value type, instead got" +
+                  AstPrinter().print(expr));
+    }
+    return std::shared_ptr<AutumnType>(
+        AutumnMapType::getInstance(keyType, valueType));
+  } catch (const std::bad_any_cast &e) {
+    throw Error("Map type must have a key and a value type" +
+                AstPrinter().print(expr));
+  }
+}
+
 std::any Interpreter::visitListVarExprExpr(std::shared_ptr<ListVarExpr> expr) {
   try {
     auto pVarExprs =
@@ -803,13 +1513,19 @@ std::any Interpreter::visitListVarExprExpr(std::shared_ptr<ListVarExpr> expr) {
         auto valueAny = subexpr->accept(*this);
         auto autumnValue =
             std::any_cast<std::shared_ptr<AutumnValue>>(valueAny);
+        // An interned position has no identity of its own, so each element
+        // gets a private copy that removeObj can tell apart
+        auto instance = dynamic_cast<AutumnInstance *>(autumnValue.get());
+        if (instance != nullptr && instance->isInterned()) {
+          autumnValue = autumnValue->copy();
+        }
         pVarExprs->push_back(autumnValue);
       } catch (const std::bad_any_cast &e) {
         throw Error("visitListVarExprExpr Failed To Interpret " +
                     AstPrinter().print(subexpr));
       }
     }
-    auto plist = std::make_shared<AutumnList>(pVarExprs);
+    auto plist = makeValue<AutumnList>(pVarExprs);
     return std::dynamic_pointer_cast<AutumnValue>(plist);
   } catch (const std::bad_any_cast &e) {
     throw Error("List must have values,got " + AstPrinter().print(expr));
@@ -837,16 +1553,22 @@ std::any Interpreter::visitIfExprExpr(std::shared_ptr<IfExpr> expr) {
   if (isCondTruthy) {
     try {
       return expr->thenBranch->accept(*this);
-    } catch (const Error &e) {
-      throw Error("If then branch error: " + AstPrinter().print(expr->thenBranch) +
-      " - " + std::string(e.what()));
+    } catch (Error &e) {
+      e.wrap([expr](const std::string &what) {
+        return "If then branch error: " + AstPrinter().print(expr->thenBranch) +
+               " - " + what;
+      });
+      throw;
     }
   } else {
     try {
       return expr->elseBranch->accept(*this);
-    } catch (const Error &e) {
-      throw Error("If else branch error: " + AstPrinter().print(expr->elseBranch) +
-      " - " + std::string(e.what()));
+    } catch (Error &e) {
+      e.wrap([expr](const std::string &what) {
+        return "If else branch error: " + AstPrinter().print(expr->elseBranch) +
+               " - " + what;
+      });
+      throw;
     }
   }
 }
@@ -909,13 +1631,86 @@ std::any Interpreter::visitOnStmtStmt(std::shared_ptr<OnStmt> stmt) {
   return nullptr;
 }
 
+void Interpreter::attachFunctionMemos(
+    const std::vector<std::shared_ptr<Stmt>> &stmts) {
+  functionMemos.clear();
+  // Names bound to the same lambda share its memo
+  std::unordered_map<AutumnLambda *, std::shared_ptr<FunctionMemo>> memos;
+  for (const auto &name : findPureFunctions(stmts, globals)) {
+    auto value =
+        std::static_pointer_cast<AutumnCallableValue>(globals->get(name));
+    auto lambda = static_cast<AutumnLambda *>(value->callable.get());
+    auto &memo = memos[lambda];
+    if (memo == nullptr) {
+      memo = std::make_shared<FunctionMemo>();
+      lambda->setMemo(memo);
+    }
+    functionMemos[name] = memo;
+  }
+}
+
+std::map<std::string, FunctionMemo::Stats>
+Interpreter::getFunctionMemoStats() {
+  std::map<std::string, FunctionMemo::Stats> result;
+  for (const auto &[name, memo] : functionMemos) {
+    result[name] = memo->getStats();
+  }
+  return result;
+}
+
+// Numbers the calls in expr in the order they are written
+static void numberCallSites(const std::shared_ptr<Expr> &expr, int &next) {
+  if (expr == nullptr) {
+    return;
+  }
+  if (auto call = std::dynamic_pointer_cast<Call>(expr)) {
+    call->site = next++;
+  }
+  forEachChild(expr, [&](const std::shared_ptr<Expr> &child) {
+    numberCallSites(child, next);
+  });
+}
+
+static void numberCallSites(const std::vector<std::shared_ptr<Stmt>> &stmts,
+                            int &next) {
+  for (const auto &stmt : stmts) {
+    if (auto block = std::dynamic_pointer_cast<Block>(stmt)) {
+      numberCallSites(block->statements, next);
+    } else if (auto object = std::dynamic_pointer_cast<Object>(stmt)) {
+      for (const auto &field : object->fields) {
+        numberCallSites(field, next);
+      }
+      numberCallSites(object->Cell, next);
+    } else if (auto onStmt = std::dynamic_pointer_cast<OnStmt>(stmt)) {
+      numberCallSites(onStmt->condition, next);
+      numberCallSites(onStmt->expr, next);
+    } else if (auto exprStmt = std::dynamic_pointer_cast<Expression>(stmt)) {
+      numberCallSites(exprStmt->expression, next);
+    }
+  }
+}
+
 void Interpreter::start(const std::vector<std::shared_ptr<Stmt>> &stmts,
                         std::string stdlib, std::string triggeringCondition, 
                         uint64_t randomSeed) {
+  ValuePool::Scope poolScope(valuePool);
   setRandomSeed(randomSeed);
-  init(stdlib);
+  std::vector<std::shared_ptr<Stmt>> stdlibStmts = init(stdlib);
+  std::vector<std::shared_ptr<Stmt>> program = stmts;
+  // Random draws are keyed by these numbers, which the optimizer carries
+  // over, so they stay put across runs and optimization settings
+  int nextSite = 0;
+  numberCallSites(stdlibStmts, nextSite);
+  numberCallSites(program, nextSite);
+  if (optimizeAst) {
+    AstOptimizer optimizer(&positions);
+    optimizer.optimize(stdlibStmts, program);
+  }
+  for (const auto &stmt : stdlibStmts) {
+    stmt->accept(*this);
+  }
   environment->assign("SpecialConditionTriggered",
-                  std::make_shared<AutumnBool>(false));
+                  AutumnBool::of(false));
   if (triggeringCondition != "") {
     try {
       SExpParser parser(triggeringCondition);
@@ -927,9 +1722,32 @@ void Interpreter::start(const std::vector<std::shared_ptr<Stmt>> &stmts,
                   e.what());
     }
   }
-  for (const auto &stmt : stmts) {
+  if (checkedOnce) {
+    // The checker is conservative, so what it finds is reported rather than
+    // fatal: the sites it flags are never proven, and the runtime checks
+    // still raise the error if the program reaches one
+    typeWarnings = typeChecker.check(stmts);
+    for (const auto &typeWarning : typeWarnings) {
+      std::cerr << "Warning: " << typeWarning << std::endl;
+    }
+    // Errors are reported on the program as written, which may have code
+    // the optimizer dropped; the proofs must cover the nodes that run
+    if (optimizeAst) {
+      typeChecker.check(program);
+    }
+  }
+  for (const auto &stmt : program) {
     stmt->accept(*this);
   }
+  stepMemo.analyze(program, globals);
+  markPureLambdas(program, globals);
+  std::unordered_set<std::string> boundNames;
+  collectBoundNames(stdlibStmts, boundNames);
+  collectBoundNames(program, boundNames);
+  gridSizeShadowable = boundNames.count("GRID_SIZE") != 0;
+  if (memoizePureFunctions) {
+    attachFunctionMemos(program);
+  }
 
   // Then start visiting initExpr
   for (const auto &[k, v] : initMap) {
@@ -961,10 +1779,13 @@ void Interpreter::start(const std::vector<std::shared_ptr<Stmt>> &stmts,
       throw Error("Init failed: " + std::string(e.what()));
     }
   }
+  // The next expressions read the state, which only now is defined
+  planNextRuns(program);
   renderAll();
 }
 
 void Interpreter::tmpExecuteStmt(const std::shared_ptr<Stmt> &stmt) {
+  ValuePool::Scope poolScope(valuePool);
   try {
     cacheEnvironment(environment);
     std::shared_ptr<Expression> exprStmt = std::dynamic_pointer_cast<Expression>(stmt);
@@ -994,6 +1815,10 @@ void Interpreter::tmpExecuteStmt(const std::shared_ptr<Stmt> &stmt) {
 }
 
 void Interpreter::step() {
+  ValuePool::Scope poolScope(valuePool);
+  valuePool->beginStep();
+  randomGen->beginStep();
+  StepMemo::Scope memoScope(stepMemo);
   // Copy previous globals
   // Delete previous environment
   auto old_prev_environment = prev_environment;
@@ -1024,10 +1849,10 @@ void Interpreter::step() {
             this->triggeringConditionExpr->accept(*this));
     if (!condition->isTruthy()) {
       environment->assign("SpecialConditionTriggered",
-                      std::make_shared<AutumnBool>(false));
+                      AutumnBool::of(false));
     } else {
       environment->assign("SpecialConditionTriggered",
-                      std::make_shared<AutumnBool>(true));
+                      AutumnBool::of(true));
     }
   }
   // Execute onStmts
@@ -1065,6 +1890,13 @@ void Interpreter::step() {
               onStmt->expr->accept(*this));
     }
   }
+  if (canRunParallel() && !nextRuns.empty()) {
+    for (const auto &run : nextRuns) {
+      stepNextRun(run);
+    }
+    this->state->reset();
+    return;
+  }
   for (auto kvPairs : nextMap) {
     std::string key = kvPairs.first;
     std::shared_ptr<Expr> nextExpr = kvPairs.second;
@@ -1077,7 +1909,8 @@ void Interpreter::step() {
     }
     std::shared_ptr<AutumnValue> value =
         std::any_cast<std::shared_ptr<AutumnValue>>(nextExpr->accept(*this));
-    environment->assign(key, value);
+    environment->assign(key, value,
+                        checkedOnce && typeChecker.isProvenNext(key));
   }
   this->state->reset();
 }
@@ -1094,11 +1927,11 @@ renderValue(Interpreter &interpreter, std::shared_ptr<AutumnValue> value) {
       const auto& renderedValues = pRendered->getValues();
       values.insert(values.end(), renderedValues->begin(), renderedValues->end());
     }
-    return std::make_shared<AutumnList>(
+    return makeValue<AutumnList>(
         std::make_shared<std::vector<std::shared_ptr<AutumnValue>>>(values));
   } else if (pInstance != nullptr) {
     if (pInstance->getClass()->findMethod("render") == nullptr) {
-      return std::make_shared<AutumnList>(
+      return makeValue<AutumnList>(
           std::make_shared<std::vector<std::shared_ptr<AutumnValue>>>(
               std::vector<std::shared_ptr<AutumnValue>>()));
     }
@@ -1108,13 +1941,14 @@ renderValue(Interpreter &interpreter, std::shared_ptr<AutumnValue> value) {
     std::shared_ptr<AutumnValue> result = render->call(interpreter, {});
     return std::dynamic_pointer_cast<AutumnList>(result);
   } else {
-    return std::make_shared<AutumnList>(
+    return makeValue<AutumnList>(
         std::make_shared<std::vector<std::shared_ptr<AutumnValue>>>(
             std::vector<std::shared_ptr<AutumnValue>>({})));
   }
 }
 
 std::string Interpreter::renderAll() {
+  ValuePool::Scope poolScope(valuePool);
   environment->clearOccupied();
   std::string result = "{";
   result.reserve(10000);
@@ -1137,8 +1971,7 @@ std::string Interpreter::renderAll() {
       visited.insert(elem);
     }
   }
-  auto pAllElems = std::make_shared<AutumnList>();
-  pAllElems->getValues()->reserve(10000);
+  auto pAllElems = makeValue<AutumnList>();
   static constexpr const char* ELEMENTS_TEMPLATE = "\"%s\": [";
   static constexpr const char* POSITION_TEMPLATE = 
     "{\"position\": {\"x\": %d, \"y\": %d}, \"color\": %s}, ";
@@ -1200,6 +2033,7 @@ int Interpreter::getFrameRate() {
 
 
 std::string Interpreter::evaluateToString(std::string expr) {
+  ValuePool::Scope poolScope(valuePool);
   SExpParser parser(expr);
   auto parsedExpr = parser.parseExpr(sexpresso::parse(expr));
   auto result = std::any_cast<std::shared_ptr<AutumnValue>>(parsedExpr->accept(*this));
@@ -0,0 +1,539 @@
+#include "Purity.hpp"
+#include "AutumnCallableValue.hpp"
+#include "AutumnClass.hpp"
+#include "AutumnConstructor.hpp"
+#include "AutumnLambda.hpp"
+#include "AutumnStdLib.hpp"
+#include "Environment.hpp"
+#include <algorithm>
+#include <unordered_map>
+
+namespace Autumn {
+
+BuiltinEffect builtinEffect(const AutumnCallable *callable) {
+  if (dynamic_cast<const Range *>(callable) != nullptr ||
+      dynamic_cast<const IsList *>(callable) != nullptr ||
+      dynamic_cast<const Length *>(callable) != nullptr ||
+      dynamic_cast<const Head *>(callable) != nullptr ||
+      dynamic_cast<const At *>(callable) != nullptr ||
+      dynamic_cast<const Tail *>(callable) != nullptr ||
+      dynamic_cast<const Concat *>(callable) != nullptr ||
+      dynamic_cast<const ArrayEqual *>(callable) != nullptr ||
+      dynamic_cast<const Sqrt *>(callable) != nullptr ||
+      dynamic_cast<const SetOf *>(callable) != nullptr ||
+      dynamic_cast<const MapOf *>(callable) != nullptr ||
+      dynamic_cast<const Insert *>(callable) != nullptr ||
+      dynamic_cast<const Remove *>(callable) != nullptr ||
+      dynamic_cast<const Contains *>(callable) != nullptr ||
+      dynamic_cast<const Lookup *>(callable) != nullptr ||
+      dynamic_cast<const Keys *>(callable) != nullptr) {
+    return BuiltinEffect::PURE;
+  }
+  if (dynamic_cast<const Map *>(callable) != nullptr ||
+      dynamic_cast<const Filter *>(callable) != nullptr ||
+      dynamic_cast<const Foldl *>(callable) != nullptr ||
+      dynamic_cast<const Any *>(callable) != nullptr ||
+      dynamic_cast<const UpdateObj *>(callable) != nullptr) {
+    return BuiltinEffect::HIGHER_ORDER;
+  }
+  if (dynamic_cast<const AdjPositions *>(callable) != nullptr ||
+      dynamic_cast<const AllPositions *>(callable) != nullptr ||
+      dynamic_cast<const IsWithinBounds *>(callable) != nullptr ||
+      dynamic_cast<const IsOutSideBounds *>(callable) != nullptr) {
+    return BuiltinEffect::READS_GRID;
+  }
+  if (dynamic_cast<const Clicked *>(callable) != nullptr ||
+      dynamic_cast<const LeftPressed *>(callable) != nullptr ||
+      dynamic_cast<const RightPressed *>(callable) != nullptr ||
+      dynamic_cast<const UpPressed *>(callable) != nullptr ||
+      dynamic_cast<const DownPressed *>(callable) != nullptr) {
+    return BuiltinEffect::READS_INPUT;
+  }
+  if (dynamic_cast<const Prev *>(callable) != nullptr) {
+    return BuiltinEffect::READS_PREV;
+  }
+  return BuiltinEffect::IMPURE;
+}
+
+bool isCalledArgument(const AutumnCallable *callable, size_t index,
+                      size_t count) {
+  // updateObj(list, f) and updateObj(list, f, filter) call their functions;
+  // updateObj(obj, field, value) and updateObj(obj, f) call the second
+  if (dynamic_cast<const UpdateObj *>(callable) != nullptr) {
+    return index >= 1;
+  }
+  // any(list) only tests the list for emptiness
+  if (dynamic_cast<const Any *>(callable) != nullptr && count < 2) {
+    return false;
+  }
+  return index == 0 && builtinEffect(callable) == BuiltinEffect::HIGHER_ORDER;
+}
+
+// updateObj(obj, "field", value) stores value rather than calling it
+static bool isFieldUpdate(const AutumnCallable *callable,
+                          const std::shared_ptr<Call> &call) {
+  if (dynamic_cast<const UpdateObj *>(callable) == nullptr ||
+      call->arguments.size() != 3) {
+    return false;
+  }
+  auto field = std::dynamic_pointer_cast<Literal>(call->arguments[1]);
+  return field != nullptr &&
+         dynamic_cast<AutumnString *>(field->constant.get()) != nullptr;
+}
+
+static void collectAssignedNames(const std::shared_ptr<Expr> &expr,
+                                 std::unordered_set<std::string> &names) {
+  if (expr == nullptr) {
+    return;
+  }
+  if (auto assign = std::dynamic_pointer_cast<Assign>(expr)) {
+    names.insert(assign->name.lexeme);
+  }
+  forEachChild(expr, [&](const std::shared_ptr<Expr> &child) {
+    collectAssignedNames(child, names);
+  });
+}
+
+std::unordered_set<std::string>
+collectWrittenNames(const std::vector<std::shared_ptr<Stmt>> &stmts) {
+  std::unordered_set<std::string> names;
+  for (const auto &stmt : stmts) {
+    if (auto onStmt = std::dynamic_pointer_cast<OnStmt>(stmt)) {
+      collectAssignedNames(onStmt->condition, names);
+      collectAssignedNames(onStmt->expr, names);
+    } else if (auto exprStmt = std::dynamic_pointer_cast<Expression>(stmt)) {
+      auto assign = std::dynamic_pointer_cast<Assign>(exprStmt->expression);
+      if (assign != nullptr &&
+          std::dynamic_pointer_cast<InitNext>(assign->value) != nullptr) {
+        names.insert(assign->name.lexeme);
+        collectAssignedNames(assign->value, names);
+      }
+    }
+  }
+  return names;
+}
+
+void collectBoundNames(const std::shared_ptr<Expr> &expr,
+                       std::unordered_set<std::string> &names) {
+  if (expr == nullptr) {
+    return;
+  }
+  if (auto lambda = std::dynamic_pointer_cast<Lambda>(expr)) {
+    for (const auto &param : lambda->params) {
+      names.insert(param.lexeme);
+    }
+  } else if (auto let = std::dynamic_pointer_cast<Let>(expr)) {
+    for (const auto &subexpr : let->exprs) {
+      if (auto assign = std::dynamic_pointer_cast<Assign>(subexpr)) {
+        names.insert(assign->name.lexeme);
+      }
+    }
+  }
+  forEachChild(expr, [&](const std::shared_ptr<Expr> &child) {
+    collectBoundNames(child, names);
+  });
+}
+
+void collectBoundNames(const std::vector<std::shared_ptr<Stmt>> &stmts,
+                       std::unordered_set<std::string> &names) {
+  for (const auto &stmt : stmts) {
+    if (auto object = std::dynamic_pointer_cast<Object>(stmt)) {
+      for (const auto &field : object->fields) {
+        if (auto decl = std::dynamic_pointer_cast<TypeDecl>(field)) {
+          names.insert(decl->name.lexeme);
+        }
+        collectBoundNames(field, names);
+      }
+      collectBoundNames(object->Cell, names);
+    } else if (auto onStmt = std::dynamic_pointer_cast<OnStmt>(stmt)) {
+      collectBoundNames(onStmt->condition, names);
+      collectBoundNames(onStmt->expr, names);
+    } else if (auto exprStmt = std::dynamic_pointer_cast<Expression>(stmt)) {
+      collectBoundNames(exprStmt->expression, names);
+    }
+  }
+}
+
+namespace {
+
+class FunctionPurity {
+public:
+  // With readsState, checks for no effect rather than purity: the state,
+  // the previous state and the inputs may be read, and pure then holds the
+  // functions without effects. readsEnclosing further lets a lambda read
+  // the bindings of the code that calls it.
+  FunctionPurity(const std::shared_ptr<Environment> &globals,
+                 const std::unordered_set<std::string> &writtenNames,
+                 const std::unordered_set<std::string> &shadowable,
+                 const std::unordered_set<std::string> &pure,
+                 bool readsState = false, bool readsEnclosing = false)
+      : globals(globals), writtenNames(writtenNames), shadowable(shadowable),
+        pure(pure), readsState(readsState), readsEnclosing(readsEnclosing) {}
+
+  bool isPure(const std::shared_ptr<Expr> &expr) {
+    locals.clear();
+    return isPureExpr(expr);
+  }
+
+private:
+  const std::shared_ptr<Environment> &globals;
+  const std::unordered_set<std::string> &writtenNames;
+  const std::unordered_set<std::string> &shadowable;
+  const std::unordered_set<std::string> &pure;
+  const bool readsState;
+  const bool readsEnclosing;
+  std::vector<std::string> locals;
+  std::unordered_set<const AutumnClass *> checkingClasses;
+
+  bool isLocal(const std::string &name) const {
+    return std::find(locals.begin(), locals.end(), name) != locals.end();
+  }
+
+  // A binding of the caller, which readsEnclosing allows reading but not
+  // calling, as nothing is known of its value
+  bool isEnclosing(const std::string &name) const {
+    return readsEnclosing && !isLocal(name) && !globals->isDefined(name);
+  }
+
+  bool isStableGlobal(const std::string &name) const {
+    return shadowable.count(name) == 0 &&
+           (readsState || writtenNames.count(name) == 0) &&
+           globals->isDefined(name);
+  }
+
+  bool isPureBuiltin(BuiltinEffect effect) const {
+    if (readsState) {
+      return effect != BuiltinEffect::IMPURE;
+    }
+    return effect == BuiltinEffect::PURE ||
+           effect == BuiltinEffect::HIGHER_ORDER ||
+           (effect == BuiltinEffect::READS_GRID &&
+            writtenNames.count("GRID_SIZE") == 0);
+  }
+
+  // A global read as a value: a constant or a pure function
+  bool isPureGlobal(const std::string &name) const {
+    if (!isStableGlobal(name)) {
+      return false;
+    }
+    std::shared_ptr<AutumnValue> value = globals->get(name);
+    if (auto callable = std::dynamic_pointer_cast<AutumnCallableValue>(value)) {
+      if (dynamic_cast<AutumnLambda *>(callable->callable.get()) != nullptr) {
+        return pure.count(name) != 0;
+      }
+      return isPureBuiltin(builtinEffect(callable->callable.get()));
+    }
+    if (readsState) {
+      return true;
+    }
+    return dynamic_cast<AutumnNumber *>(value.get()) != nullptr ||
+           dynamic_cast<AutumnBool *>(value.get()) != nullptr ||
+           dynamic_cast<AutumnString *>(value.get()) != nullptr;
+  }
+
+  // Whether making an object of cls only evaluates expressions without
+  // effects: its fields and its cell expression
+  bool isPureClass(const std::shared_ptr<AutumnClass> &cls) {
+    auto constructor =
+        dynamic_cast<AutumnConstructor *>(cls->getInitializer().get());
+    if (constructor == nullptr) {
+      return cls->getInitializer() == nullptr;
+    }
+    // A cell expression making the same kind of object adds no effect
+    if (!checkingClasses.insert(cls.get()).second) {
+      return true;
+    }
+    std::vector<std::string> outer;
+    outer.swap(locals);
+    bool result = isPureExpr(constructor->getDeclaration());
+    locals.swap(outer);
+    checkingClasses.erase(cls.get());
+    return result;
+  }
+
+  bool isPureCall(const std::shared_ptr<Call> &call) {
+    for (const auto &argument : call->arguments) {
+      if (!isPureExpr(argument)) {
+        return false;
+      }
+    }
+    auto callee = std::dynamic_pointer_cast<Variable>(call->callee);
+    if (callee == nullptr || isLocal(callee->name.lexeme) ||
+        shadowable.count(callee->name.lexeme) != 0) {
+      return false;
+    }
+    auto cls = std::dynamic_pointer_cast<AutumnClass>(
+        globals->getTypeValue(callee->name));
+    if (cls != nullptr) {
+      // Other objects get fresh ids, which a pure function may not hand out
+      return cls->name == "Position" || (readsState && isPureClass(cls));
+    }
+    if (!isPureGlobal(callee->name.lexeme)) {
+      return false;
+    }
+    auto value = std::dynamic_pointer_cast<AutumnCallableValue>(
+        globals->get(callee->name.lexeme));
+    if (value == nullptr) {
+      return false;
+    }
+    // Whatever a higher-order builtin calls must be known: a lambda written
+    // here or a pure global, never a parameter or a method
+    for (size_t i = 0; i < call->arguments.size(); i++) {
+      if (isFieldUpdate(value->callable.get(), call) ||
+          !isCalledArgument(value->callable.get(), i,
+                            call->arguments.size())) {
+        continue;
+      }
+      const auto &argument = call->arguments[i];
+      auto variable = std::dynamic_pointer_cast<Variable>(argument);
+      if ((variable != nullptr && (isLocal(variable->name.lexeme) ||
+                                   isEnclosing(variable->name.lexeme))) ||
+          std::dynamic_pointer_cast<Get>(argument) != nullptr ||
+          std::dynamic_pointer_cast<Call>(argument) != nullptr) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool isPureExpr(const std::shared_ptr<Expr> &expr) {
+    if (std::dynamic_pointer_cast<Literal>(expr) != nullptr) {
+      return true;
+    }
+    if (auto variable = std::dynamic_pointer_cast<Variable>(expr)) {
+      return isLocal(variable->name.lexeme) ||
+             isPureGlobal(variable->name.lexeme) ||
+             isEnclosing(variable->name.lexeme);
+    }
+    if (auto call = std::dynamic_pointer_cast<Call>(expr)) {
+      return isPureCall(call);
+    }
+    if (auto lambda = std::dynamic_pointer_cast<Lambda>(expr)) {
+      size_t depth = locals.size();
+      for (const auto &param : lambda->params) {
+        locals.push_back(param.lexeme);
+      }
+      bool result = isPureExpr(lambda->right);
+      locals.resize(depth);
+      return result;
+    }
+    if (auto let = std::dynamic_pointer_cast<Let>(expr)) {
+      size_t depth = locals.size();
+      bool result = true;
+      for (const auto &subexpr : let->exprs) {
+        auto assign = std::dynamic_pointer_cast<Assign>(subexpr);
+        result = isPureExpr(assign != nullptr ? assign->value : subexpr);
+        if (!result) {
+          break;
+        }
+        if (assign != nullptr) {
+          locals.push_back(assign->name.lexeme);
+        }
+      }
+      locals.resize(depth);
+      return result;
+    }
+    // Writes outside a let change the environment
+    if (std::dynamic_pointer_cast<Assign>(expr) != nullptr ||
+        std::dynamic_pointer_cast<Set>(expr) != nullptr ||
+        std::dynamic_pointer_cast<InitNext>(expr) != nullptr) {
+      return false;
+    }
+    if (std::dynamic_pointer_cast<Get>(expr) != nullptr ||
+        std::dynamic_pointer_cast<Binary>(expr) != nullptr ||
+        std::dynamic_pointer_cast<Logical>(expr) != nullptr ||
+        std::dynamic_pointer_cast<Unary>(expr) != nullptr ||
+        std::dynamic_pointer_cast<IfExpr>(expr) != nullptr ||
+        std::dynamic_pointer_cast<ListVarExpr>(expr) != nullptr ||
+        std::dynamic_pointer_cast<Grouping>(expr) != nullptr) {
+      bool result = true;
+      forEachChild(expr, [&](const std::shared_ptr<Expr> &child) {
+        result = result && isPureExpr(child);
+      });
+      return result;
+    }
+    return false;
+  }
+};
+
+} // namespace
+
+// Fills in the names that keep a global from being stable and the global
+// lambdas the program may call, and returns the pure ones among those, or
+// with readsState the ones without effects
+static std::unordered_set<std::string> analyzeFunctions(
+    const std::vector<std::shared_ptr<Stmt>> &stmts,
+    const std::shared_ptr<Environment> &globals,
+    std::unordered_set<std::string> &writtenNames,
+    std::unordered_set<std::string> &shadowable,
+    std::unordered_map<std::string, std::shared_ptr<Lambda>> &functions,
+    bool readsState = false) {
+  writtenNames = collectWrittenNames(stmts);
+  collectBoundNames(stmts, shadowable);
+
+  for (const auto &[name, value] : globals->getDefinedVariables()) {
+    auto callable = std::dynamic_pointer_cast<AutumnCallableValue>(value);
+    auto lambda = callable == nullptr
+                      ? nullptr
+                      : dynamic_cast<AutumnLambda *>(callable->callable.get());
+    if (lambda == nullptr) {
+      continue;
+    }
+    collectBoundNames(lambda->getDeclaration(), shadowable);
+    if (writtenNames.count(name) == 0) {
+      functions[name] = lambda->getDeclaration();
+    }
+  }
+
+  // Start from every function and drop the impure ones until nothing changes
+  std::unordered_set<std::string> pure;
+  for (const auto &[name, declaration] : functions) {
+    pure.insert(name);
+  }
+  FunctionPurity analysis(globals, writtenNames, shadowable, pure, readsState);
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (const auto &[name, declaration] : functions) {
+      if (pure.count(name) != 0 && !analysis.isPure(declaration)) {
+        pure.erase(name);
+        changed = true;
+      }
+    }
+  }
+  return pure;
+}
+
+std::vector<std::string>
+findPureFunctions(const std::vector<std::shared_ptr<Stmt>> &stmts,
+                  const std::shared_ptr<Environment> &globals) {
+  std::unordered_set<std::string> writtenNames;
+  std::unordered_set<std::string> shadowable;
+  std::unordered_map<std::string, std::shared_ptr<Lambda>> functions;
+  std::unordered_set<std::string> pure =
+      analyzeFunctions(stmts, globals, writtenNames, shadowable, functions);
+  return std::vector<std::string>(pure.begin(), pure.end());
+}
+
+static void markLambdas(const std::shared_ptr<Expr> &expr,
+                        FunctionPurity &analysis, FunctionPurity &effects) {
+  if (expr == nullptr) {
+    return;
+  }
+  if (auto lambda = std::dynamic_pointer_cast<Lambda>(expr)) {
+    lambda->pure = analysis.isPure(lambda);
+    lambda->effectFree = lambda->pure || effects.isPure(lambda);
+  }
+  forEachChild(expr, [&](const std::shared_ptr<Expr> &child) {
+    markLambdas(child, analysis, effects);
+  });
+}
+
+void markPureLambdas(const std::vector<std::shared_ptr<Stmt>> &stmts,
+                     const std::shared_ptr<Environment> &globals) {
+  std::unordered_set<std::string> writtenNames;
+  std::unordered_set<std::string> shadowable;
+  std::unordered_map<std::string, std::shared_ptr<Lambda>> functions;
+  std::unordered_set<std::string> pure =
+      analyzeFunctions(stmts, globals, writtenNames, shadowable, functions);
+  std::unordered_set<std::string> withoutEffects = analyzeFunctions(
+      stmts, globals, writtenNames, shadowable, functions, true);
+  FunctionPurity analysis(globals, writtenNames, shadowable, pure);
+  FunctionPurity effects(globals, writtenNames, shadowable, withoutEffects,
+                         true, true);
+  for (const auto &[name, declaration] : functions) {
+    markLambdas(declaration, analysis, effects);
+  }
+  for (const auto &stmt : stmts) {
+    if (auto object = std::dynamic_pointer_cast<Object>(stmt)) {
+      for (const auto &field : object->fields) {
+        markLambdas(field, analysis, effects);
+      }
+      markLambdas(object->Cell, analysis, effects);
+    } else if (auto onStmt = std::dynamic_pointer_cast<OnStmt>(stmt)) {
+      markLambdas(onStmt->condition, analysis, effects);
+      markLambdas(onStmt->expr, analysis, effects);
+    } else if (auto exprStmt = std::dynamic_pointer_cast<Expression>(stmt)) {
+      markLambdas(exprStmt->expression, analysis, effects);
+    }
+  }
+}
+
+// Adds the names expr reads, and those read by the global lambdas it names,
+// to reads; string arguments count too, as prev takes names as strings
+static void collectReads(
+    const std::shared_ptr<Expr> &expr,
+    const std::unordered_map<std::string, std::shared_ptr<Lambda>> &functions,
+    std::unordered_set<std::string> &reads) {
+  if (expr == nullptr) {
+    return;
+  }
+  if (auto variable = std::dynamic_pointer_cast<Variable>(expr)) {
+    auto function = functions.find(variable->name.lexeme);
+    if (reads.insert(variable->name.lexeme).second &&
+        function != functions.end()) {
+      collectReads(function->second, functions, reads);
+    }
+  } else if (auto literal = std::dynamic_pointer_cast<Literal>(expr)) {
+    if (auto name = dynamic_cast<AutumnString *>(literal->constant.get())) {
+      reads.insert(name->getString());
+    }
+  }
+  forEachChild(expr, [&](const std::shared_ptr<Expr> &child) {
+    collectReads(child, functions, reads);
+  });
+}
+
+// Whether expr calls a higher-order builtin or a global lambda
+static bool hasLoop(
+    const std::shared_ptr<Expr> &expr,
+    const std::shared_ptr<Environment> &globals,
+    const std::unordered_map<std::string, std::shared_ptr<Lambda>> &functions) {
+  if (expr == nullptr) {
+    return false;
+  }
+  if (auto call = std::dynamic_pointer_cast<Call>(expr)) {
+    auto callee = std::dynamic_pointer_cast<Variable>(call->callee);
+    if (callee != nullptr) {
+      const std::string &name = callee->name.lexeme;
+      if (functions.count(name) != 0) {
+        return true;
+      }
+      auto value = globals->isDefined(name)
+                       ? std::dynamic_pointer_cast<AutumnCallableValue>(
+                             globals->get(name))
+                       : nullptr;
+      if (value != nullptr && builtinEffect(value->callable.get()) ==
+                                  BuiltinEffect::HIGHER_ORDER) {
+        return true;
+      }
+    }
+  }
+  bool found = false;
+  forEachChild(expr, [&](const std::shared_ptr<Expr> &child) {
+    found = found || hasLoop(child, globals, functions);
+  });
+  return found;
+}
+
+std::vector<NextExprEffects>
+analyzeNextExprs(const std::vector<std::shared_ptr<Expr>> &exprs,
+                 const std::vector<std::shared_ptr<Stmt>> &stmts,
+                 const std::shared_ptr<Environment> &globals) {
+  std::unordered_set<std::string> writtenNames;
+  std::unordered_set<std::string> shadowable;
+  std::unordered_map<std::string, std::shared_ptr<Lambda>> functions;
+  std::unordered_set<std::string> effectFree = analyzeFunctions(
+      stmts, globals, writtenNames, shadowable, functions, true);
+  FunctionPurity analysis(globals, writtenNames, shadowable, effectFree,
+                          true);
+  std::vector<NextExprEffects> effects(exprs.size());
+  for (size_t i = 0; i < exprs.size(); i++) {
+    effects[i].effectFree = analysis.isPure(exprs[i]);
+    effects[i].loops = hasLoop(exprs[i], globals, functions);
+    collectReads(exprs[i], functions, effects[i].reads);
+  }
+  return effects;
+}
+
+} // namespace Autumn
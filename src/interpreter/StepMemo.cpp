@@ -0,0 +1,325 @@
+#include "StepMemo.hpp"
+#include "AstPrinter.hpp"
+#include "AutumnCallableValue.hpp"
+#include "AutumnClass.hpp"
+#include "AutumnValue.hpp"
+#include "Environment.hpp"
+#include "Purity.hpp"
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace Autumn {
+
+namespace {
+
+enum class Stability {
+  UNSTABLE, // may change within a step
+  DERIVED,  // stable, computed from stable values
+  PREVIOUS, // stable, read out of the previous state
+};
+
+Stability weakest(Stability a, Stability b) {
+  if (a == Stability::UNSTABLE || b == Stability::UNSTABLE) {
+    return Stability::UNSTABLE;
+  }
+  return Stability::DERIVED;
+}
+
+/// Classifies expressions by whether their value is fixed for a step and
+/// collects the calls and field reads worth memoizing
+class StabilityAnalysis : public Expr::Visitor {
+public:
+  struct Candidate {
+    std::shared_ptr<Expr> expr;
+    int *slot;
+    std::string key;
+    StepMemo::SlotKind kind;
+    bool underLambda;
+  };
+
+  StabilityAnalysis(const std::shared_ptr<Environment> &globals,
+                    const std::unordered_set<std::string> &writtenNames)
+      : globals(globals), writtenNames(writtenNames) {}
+
+  std::vector<Candidate> candidates;
+
+  Stability classify(const std::shared_ptr<Expr> &expr) {
+    return std::any_cast<Stability>(expr->accept(*this));
+  }
+
+  std::any visitLiteralExpr(std::shared_ptr<Literal> expr) override {
+    return Stability::DERIVED;
+  }
+  std::any visitGroupingExpr(std::shared_ptr<Grouping> expr) override {
+    return classify(expr->expression);
+  }
+  std::any visitUnaryExpr(std::shared_ptr<Unary> expr) override {
+    return weakest(classify(expr->right), Stability::DERIVED);
+  }
+  std::any visitBinaryExpr(std::shared_ptr<Binary> expr) override {
+    Stability left = classify(expr->left);
+    return weakest(left, classify(expr->right));
+  }
+  std::any visitLogicalExpr(std::shared_ptr<Logical> expr) override {
+    Stability left = classify(expr->left);
+    return weakest(left, classify(expr->right));
+  }
+  std::any visitIfExprExpr(std::shared_ptr<IfExpr> expr) override {
+    Stability result = classify(expr->condition);
+    result = weakest(result, classify(expr->thenBranch));
+    return weakest(result, classify(expr->elseBranch));
+  }
+  std::any visitListVarExprExpr(std::shared_ptr<ListVarExpr> expr) override {
+    Stability result = Stability::DERIVED;
+    for (const auto &element : expr->varExprs) {
+      result = weakest(result, classify(element));
+    }
+    return result;
+  }
+  std::any visitVariableExpr(std::shared_ptr<Variable> expr) override {
+    return Stability::UNSTABLE;
+  }
+  std::any visitAssignExpr(std::shared_ptr<Assign> expr) override {
+    classify(expr->value);
+    return Stability::UNSTABLE;
+  }
+  std::any visitSetExpr(std::shared_ptr<Set> expr) override {
+    classify(expr->object);
+    classify(expr->value);
+    return Stability::UNSTABLE;
+  }
+  std::any visitInitNextExpr(std::shared_ptr<InitNext> expr) override {
+    classify(expr->initializer);
+    classify(expr->nextExpr);
+    return Stability::UNSTABLE;
+  }
+  std::any visitTypeVariableExpr(std::shared_ptr<TypeVariable> expr) override {
+    return Stability::UNSTABLE;
+  }
+  std::any visitTypeDeclExpr(std::shared_ptr<TypeDecl> expr) override {
+    return Stability::UNSTABLE;
+  }
+  std::any visitListTypeExprExpr(std::shared_ptr<ListTypeExpr> expr) override {
+    return Stability::UNSTABLE;
+  }
+  std::any visitSetTypeExprExpr(std::shared_ptr<SetTypeExpr> expr) override {
+    return Stability::UNSTABLE;
+  }
+  std::any visitMapTypeExprExpr(std::shared_ptr<MapTypeExpr> expr) override {
+    return Stability::UNSTABLE;
+  }
+
+  std::any visitLambdaExpr(std::shared_ptr<Lambda> expr) override {
+    std::vector<std::string> params;
+    for (const auto &param : expr->params) {
+      params.push_back(param.lexeme);
+    }
+    bound.push_back(params);
+    ++lambdaDepth;
+    classify(expr->right);
+    --lambdaDepth;
+    bound.pop_back();
+    return Stability::UNSTABLE;
+  }
+
+  std::any visitLetExpr(std::shared_ptr<Let> expr) override {
+    bound.emplace_back();
+    for (const auto &subexpr : expr->exprs) {
+      classify(subexpr);
+      auto assign = std::dynamic_pointer_cast<Assign>(subexpr);
+      if (assign != nullptr) {
+        bound.back().push_back(assign->name.lexeme);
+      }
+    }
+    bound.pop_back();
+    return Stability::UNSTABLE;
+  }
+
+  std::any visitGetExpr(std::shared_ptr<Get> expr) override {
+    Stability object = classify(expr->object);
+    if (object == Stability::UNSTABLE) {
+      return Stability::UNSTABLE;
+    }
+    addCandidate(expr, &expr->stepMemoSlot, object);
+    return object;
+  }
+
+  std::any visitCallExpr(std::shared_ptr<Call> expr) override {
+    Stability arguments = Stability::DERIVED;
+    for (const auto &argument : expr->arguments) {
+      arguments = weakest(arguments, classify(argument));
+    }
+    auto callee = std::dynamic_pointer_cast<Variable>(expr->callee);
+    if (callee == nullptr) {
+      classify(expr->callee);
+      return Stability::UNSTABLE;
+    }
+    Stability result = classifyCall(callee->name, expr, arguments);
+    if (result != Stability::UNSTABLE) {
+      addCandidate(expr, &expr->stepMemoSlot, result);
+    }
+    return result;
+  }
+
+private:
+  const std::shared_ptr<Environment> &globals;
+  const std::unordered_set<std::string> &writtenNames;
+  // Names bound by enclosing lambdas and lets, which hide the builtins
+  std::vector<std::vector<std::string>> bound;
+  int lambdaDepth = 0;
+
+  bool isBound(const std::string &name) const {
+    for (const auto &scope : bound) {
+      for (const auto &boundName : scope) {
+        if (boundName == name) {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  Stability classifyCall(const Token &name, const std::shared_ptr<Call> &expr,
+                         Stability arguments) {
+    if (isBound(name.lexeme) || writtenNames.count(name.lexeme) != 0) {
+      return Stability::UNSTABLE;
+    }
+    // Position values are interned, so equal arguments give the same object
+    auto cls =
+        std::dynamic_pointer_cast<AutumnClass>(globals->getTypeValue(name));
+    if (cls != nullptr) {
+      return cls->name == "Position" ? arguments : Stability::UNSTABLE;
+    }
+    if (!globals->isDefined(name.lexeme)) {
+      return Stability::UNSTABLE;
+    }
+    auto value = std::dynamic_pointer_cast<AutumnCallableValue>(
+        globals->get(name.lexeme));
+    if (value == nullptr) {
+      return Stability::UNSTABLE;
+    }
+    BuiltinEffect effect = builtinEffect(value->callable.get());
+    if (effect == BuiltinEffect::READS_PREV) {
+      // A variable argument is looked up by name, never evaluated
+      if (expr->arguments.size() == 1 &&
+          std::dynamic_pointer_cast<Variable>(expr->arguments[0]) != nullptr) {
+        return Stability::PREVIOUS;
+      }
+      return arguments == Stability::UNSTABLE ? Stability::UNSTABLE
+                                              : Stability::PREVIOUS;
+    }
+    // The grid builtins read GRID_SIZE, stable unless the program writes it
+    if (effect == BuiltinEffect::READS_GRID &&
+        writtenNames.count("GRID_SIZE") != 0) {
+      return Stability::UNSTABLE;
+    }
+    // Inputs are fixed until the step ends
+    if (effect == BuiltinEffect::PURE || effect == BuiltinEffect::READS_GRID ||
+        effect == BuiltinEffect::READS_INPUT) {
+      return arguments;
+    }
+    return Stability::UNSTABLE;
+  }
+
+  void addCandidate(const std::shared_ptr<Expr> &expr, int *slot,
+                    Stability stability) {
+    candidates.push_back({expr, slot, AstPrinter().print(expr),
+                          stability == Stability::PREVIOUS
+                              ? StepMemo::SlotKind::PREVIOUS
+                              : StepMemo::SlotKind::DERIVED,
+                          lambdaDepth > 0});
+  }
+};
+
+} // namespace
+
+StepMemo::Scope::Scope(StepMemo &memo) : memo(memo) {
+  memo.stepStats = Stats();
+  memo.active = true;
+}
+
+StepMemo::Scope::~Scope() {
+  memo.active = false;
+  std::fill(memo.values.begin(), memo.values.end(), nullptr);
+}
+
+void StepMemo::analyze(const std::vector<std::shared_ptr<Stmt>> &stmts,
+                       const std::shared_ptr<Environment> &globals) {
+  for (const auto &expr : slotted) {
+    if (auto call = std::dynamic_pointer_cast<Call>(expr)) {
+      call->stepMemoSlot = -1;
+    } else if (auto get = std::dynamic_pointer_cast<Get>(expr)) {
+      get->stepMemoSlot = -1;
+    }
+  }
+  slotted.clear();
+  kinds.clear();
+  values.clear();
+  stepStats = Stats();
+  totalStats = Stats();
+
+  // The expressions run by every step
+  std::vector<std::shared_ptr<Expr>> roots;
+  for (const auto &stmt : stmts) {
+    if (auto onStmt = std::dynamic_pointer_cast<OnStmt>(stmt)) {
+      roots.push_back(onStmt->condition);
+      roots.push_back(onStmt->expr);
+    } else if (auto exprStmt = std::dynamic_pointer_cast<Expression>(stmt)) {
+      auto assign = std::dynamic_pointer_cast<Assign>(exprStmt->expression);
+      auto initNext = assign == nullptr
+                          ? nullptr
+                          : std::dynamic_pointer_cast<InitNext>(assign->value);
+      if (initNext != nullptr) {
+        roots.push_back(initNext->nextExpr);
+      }
+    }
+  }
+
+  std::unordered_set<std::string> writtenNames = collectWrittenNames(stmts);
+  StabilityAnalysis analysis(globals, writtenNames);
+  for (const auto &root : roots) {
+    analysis.classify(root);
+  }
+
+  // Only expressions that run more than once per step are worth a slot
+  std::unordered_map<std::string, int> occurrences;
+  for (const auto &candidate : analysis.candidates) {
+    ++occurrences[candidate.key];
+  }
+  std::unordered_map<std::string, int> slots;
+  for (const auto &candidate : analysis.candidates) {
+    if (occurrences[candidate.key] < 2 && !candidate.underLambda) {
+      continue;
+    }
+    auto found = slots.find(candidate.key);
+    if (found == slots.end()) {
+      found = slots.emplace(candidate.key, static_cast<int>(kinds.size()))
+                  .first;
+      kinds.push_back(candidate.kind);
+    }
+    *candidate.slot = found->second;
+    slotted.push_back(candidate.expr);
+  }
+  values.assign(kinds.size(), nullptr);
+}
+
+void StepMemo::store(int slot, const std::shared_ptr<AutumnValue> &value) {
+  // Methods are bound to the instance they were last read from
+  bool keep = value != nullptr &&
+              dynamic_cast<AutumnCallableValue *>(value.get()) == nullptr;
+  if (keep && kinds[slot] == SlotKind::DERIVED) {
+    keep = value->isInterned();
+  }
+  if (keep) {
+    values[slot] = value;
+    ++stepStats.misses;
+    ++totalStats.misses;
+  } else {
+    ++stepStats.uncached;
+    ++totalStats.uncached;
+  }
+}
+
+} // namespace Autumn
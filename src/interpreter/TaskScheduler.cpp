@@ -0,0 +1,196 @@
+#include "TaskScheduler.hpp"
+#include <algorithm>
+#include <chrono>
+
+namespace Autumn {
+
+// Index of the scheduler worker running on this thread, -1 on other threads
+static thread_local int workerIndex = -1;
+
+TaskScheduler::TaskGroup::TaskGroup(const char *label) : label(label) {}
+
+TaskScheduler::TaskGroup::~TaskGroup() { wait(); }
+
+void TaskScheduler::TaskGroup::run(std::function<void()> task) {
+  pending.fetch_add(1);
+  TaskScheduler::instance().submit({std::move(task), this});
+}
+
+void TaskScheduler::TaskGroup::wait() {
+  TaskScheduler &scheduler = TaskScheduler::instance();
+  while (pending.load() > 0) {
+    Task task;
+    bool stolen;
+    if (scheduler.take(task, stolen)) {
+      scheduler.execute(task, stolen);
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(scheduler.sleepMutex);
+    scheduler.wakeup.wait(lock, [&] {
+      return pending.load() == 0 || scheduler.queued.load() > 0;
+    });
+  }
+}
+
+TaskScheduler &TaskScheduler::instance() {
+  static TaskScheduler scheduler;
+  return scheduler;
+}
+
+TaskScheduler::TaskScheduler()
+    : workerCount(std::max(std::thread::hardware_concurrency(), 1u) - 1) {}
+
+TaskScheduler::~TaskScheduler() { stop(); }
+
+void TaskScheduler::setWorkerCount(size_t count) {
+  std::lock_guard<std::mutex> lock(configMutex);
+  stop();
+  workerCount = count;
+}
+
+size_t TaskScheduler::getWorkerCount() {
+  std::lock_guard<std::mutex> lock(configMutex);
+  return workerCount;
+}
+
+std::map<std::string, TaskScheduler::Stats> TaskScheduler::getStats() {
+  std::lock_guard<std::mutex> lock(statsMutex);
+  return stats;
+}
+
+void TaskScheduler::resetStats() {
+  std::lock_guard<std::mutex> lock(statsMutex);
+  stats.clear();
+}
+
+void TaskScheduler::start(size_t count) {
+  workers.clear();
+  for (size_t i = 0; i < count; i++) {
+    workers.push_back(std::make_unique<Worker>());
+  }
+  // Every deque exists before any worker looks for one to steal from
+  for (size_t i = 0; i < count; i++) {
+    workers[i]->thread = std::thread([this, i] { workerLoop(i); });
+  }
+  started = true;
+}
+
+void TaskScheduler::stop() {
+  if (!started) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(sleepMutex);
+    stopping = true;
+  }
+  wakeup.notify_all();
+  for (auto &worker : workers) {
+    worker->thread.join();
+  }
+  workers.clear();
+  stopping = false;
+  started = false;
+}
+
+void TaskScheduler::submit(Task task) {
+  {
+    std::lock_guard<std::mutex> lock(configMutex);
+    if (!started) {
+      start(workerCount);
+    }
+  }
+  queued.fetch_add(1);
+  if (workerIndex >= 0) {
+    Worker &worker = *workers[workerIndex];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    worker.tasks.push_back(std::move(task));
+  } else {
+    std::lock_guard<std::mutex> lock(sharedMutex);
+    shared.push_back(std::move(task));
+  }
+  // Taking the lock orders the push before any sleeper's next check
+  { std::lock_guard<std::mutex> lock(sleepMutex); }
+  wakeup.notify_one();
+}
+
+bool TaskScheduler::take(Task &task, bool &stolen) {
+  if (queued.load() == 0) {
+    return false;
+  }
+  if (workerIndex >= 0) {
+    Worker &self = *workers[workerIndex];
+    std::lock_guard<std::mutex> lock(self.mutex);
+    if (!self.tasks.empty()) {
+      task = std::move(self.tasks.back());
+      self.tasks.pop_back();
+      queued.fetch_sub(1);
+      stolen = false;
+      return true;
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lock(sharedMutex);
+    if (!shared.empty()) {
+      task = std::move(shared.front());
+      shared.pop_front();
+      queued.fetch_sub(1);
+      stolen = false;
+      return true;
+    }
+  }
+  size_t count = workers.size();
+  size_t first = workerIndex >= 0 ? workerIndex + 1 : 0;
+  for (size_t i = 0; i < count; i++) {
+    Worker &victim = *workers[(first + i) % count];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.tasks.empty()) {
+      task = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+      queued.fetch_sub(1);
+      stolen = true;
+      return true;
+    }
+  }
+  return false;
+}
+
+void TaskScheduler::execute(Task &task, bool stolen) {
+  auto begin = std::chrono::steady_clock::now();
+  task.run();
+  auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now() - begin)
+                   .count();
+  TaskGroup *group = task.group;
+  {
+    std::lock_guard<std::mutex> lock(statsMutex);
+    Stats &counters = stats[group->label];
+    counters.tasks++;
+    counters.stolen += stolen ? 1 : 0;
+    counters.busyNanos += nanos;
+  }
+  task.run = nullptr;
+  // The group may be gone as soon as its last task is counted
+  if (group->pending.fetch_sub(1) == 1) {
+    std::lock_guard<std::mutex> lock(sleepMutex);
+    wakeup.notify_all();
+  }
+}
+
+void TaskScheduler::workerLoop(size_t index) {
+  workerIndex = static_cast<int>(index);
+  while (true) {
+    Task task;
+    bool stolen;
+    if (take(task, stolen)) {
+      execute(task, stolen);
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(sleepMutex);
+    wakeup.wait(lock, [&] { return stopping || queued.load() > 0; });
+    if (stopping) {
+      return;
+    }
+  }
+}
+
+} // namespace Autumn
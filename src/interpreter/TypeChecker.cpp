@@ -0,0 +1,590 @@
+#include "TypeChecker.hpp"
+#include "AstPrinter.hpp"
+#include "AutumnInstance.hpp"
+#include "TokenType.hpp"
+#include <string>
+#include <unordered_set>
+#include <utility>
+
+namespace Autumn {
+
+namespace {
+
+// Stands for a class (or Cell) before the program runs and defines it. There
+// is one object per name and check, so it compares by identity like the
+// runtime's class types.
+class NamedType : public AutumnType {
+  std::string name;
+
+public:
+  explicit NamedType(std::string name) : name(std::move(name)) {}
+  std::string toString() const override { return name; }
+};
+
+std::shared_ptr<AutumnType> unknownType() {
+  return AutumnUnknownType::getInstance();
+}
+
+std::shared_ptr<AutumnType> numberType() {
+  return AutumnNumberType::getInstance();
+}
+
+std::shared_ptr<AutumnType> boolType() { return AutumnBoolType::getInstance(); }
+
+std::shared_ptr<AutumnType> stringType() {
+  return AutumnStringType::getInstance();
+}
+
+} // namespace
+
+bool TypeChecker::isKnown(const TypePtr &type) {
+  return type.get() != AutumnUnknownType::getInstance().get();
+}
+
+// Lists, sets and maps, whose element types may change at runtime
+bool TypeChecker::isCollection(const TypePtr &type) {
+  return dynamic_cast<const AutumnListType *>(type.get()) != nullptr ||
+         dynamic_cast<const AutumnSetType *>(type.get()) != nullptr ||
+         dynamic_cast<const AutumnMapType *>(type.get()) != nullptr;
+}
+
+// Builtins whose result type does not depend on their arguments
+TypeChecker::TypePtr TypeChecker::builtinResultType(const std::string &name) {
+  static const std::unordered_set<std::string> boolBuiltins = {
+      "isFreePos", "isWithinBounds", "isOutsideBounds", "clicked",
+      "left",      "right",          "up",              "down",
+      "isList",    "defined",        "contains"};
+  const TypePtr &position = classes.at("Position").type;
+  if (name == "range") {
+    return AutumnListType::getInstance(numberType());
+  }
+  if (name == "allPositions" || name == "adjPositions" ||
+      name == "randomFreePositions" || name == "randomDistinctPositions") {
+    return AutumnListType::getInstance(position);
+  }
+  if (name == "length") {
+    return numberType();
+  }
+  if (name == "randomFreePos") {
+    return position;
+  }
+  if (boolBuiltins.find(name) != boolBuiltins.end()) {
+    return boolType();
+  }
+  return nullptr;
+}
+
+void TypeChecker::defineClass(const std::string &name,
+                              std::vector<std::string> fieldNames,
+                              std::vector<TypePtr> fieldTypes,
+                              bool hasInitializer) {
+  classes[name] = {std::make_shared<NamedType>(name), std::move(fieldNames),
+                   std::move(fieldTypes), hasInitializer};
+}
+
+std::vector<std::string>
+TypeChecker::check(const std::vector<std::shared_ptr<Stmt>> &stmts) {
+  program = stmts;
+  classes.clear();
+  declaredTypes.clear();
+  cellType = std::make_shared<NamedType>("Cell");
+  defineClass("Position", {"x", "y"}, {numberType(), numberType()}, false);
+  defineClass("RenderedElem", {"position", "color"},
+              {classes.at("Position").type, stringType()}, false);
+
+  // Classes first, so declarations can refer to objects defined later
+  for (const auto &stmt : stmts) {
+    auto object = std::dynamic_pointer_cast<Object>(stmt);
+    if (object != nullptr) {
+      defineClass(object->name.lexeme, {}, {}, true);
+    }
+  }
+  errors.clear();
+  for (const auto &stmt : stmts) {
+    auto object = std::dynamic_pointer_cast<Object>(stmt);
+    if (object != nullptr) {
+      ClassInfo &info = classes[object->name.lexeme];
+      for (const auto &field : object->fields) {
+        auto decl = std::dynamic_pointer_cast<TypeDecl>(field);
+        if (decl == nullptr) {
+          continue;
+        }
+        info.fieldNames.push_back(decl->name.lexeme);
+        info.fieldTypes.push_back(resolveTypeExpr(decl->typeexpr));
+      }
+      info.fieldNames.push_back("origin");
+      info.fieldTypes.push_back(classes.at("Position").type);
+      continue;
+    }
+    auto exprStmt = std::dynamic_pointer_cast<Expression>(stmt);
+    if (exprStmt == nullptr) {
+      continue;
+    }
+    auto decl = std::dynamic_pointer_cast<TypeDecl>(exprStmt->expression);
+    if (decl != nullptr) {
+      declaredTypes[decl->name.lexeme] = resolveTypeExpr(decl->typeexpr);
+    }
+  }
+  std::vector<std::string> declarationErrors = errors;
+
+  // A declared variable is only trusted to hold its declared type when every
+  // write to it is proven; iterate until the trusted set stops shrinking.
+  trustedVars.clear();
+  for (const auto &[name, type] : declaredTypes) {
+    trustedVars.insert(name);
+  }
+  rewrittenFields.clear();
+  anyFieldRewritten = false;
+  while (true) {
+    errors = declarationErrors;
+    provenExprs.clear();
+    provenNexts.clear();
+    unprovenWrites.clear();
+    scopes.clear();
+    size_t fieldsBefore = rewrittenFields.size();
+    bool anyBefore = anyFieldRewritten;
+    for (const auto &stmt : stmts) {
+      stmt->accept(*this);
+    }
+    size_t varsBefore = trustedVars.size();
+    for (const auto &name : unprovenWrites) {
+      trustedVars.erase(name);
+    }
+    if (trustedVars.size() == varsBefore &&
+        rewrittenFields.size() == fieldsBefore &&
+        anyFieldRewritten == anyBefore) {
+      break;
+    }
+  }
+  return errors;
+}
+
+TypeChecker::TypePtr TypeChecker::typeOf(const std::shared_ptr<Expr> &expr) {
+  std::any result = expr->accept(*this);
+  if (auto type = std::any_cast<TypePtr>(&result)) {
+    return *type;
+  }
+  return unknownType();
+}
+
+TypeChecker::TypePtr TypeChecker::lookup(const std::string &name) {
+  for (auto scope = scopes.rbegin(); scope != scopes.rend(); ++scope) {
+    auto it = scope->find(name);
+    if (it != scope->end()) {
+      return it->second;
+    }
+  }
+  if (trustedVars.find(name) != trustedVars.end()) {
+    return declaredTypes[name];
+  }
+  return unknownType();
+}
+
+// updateObj can replace fields without a type check, so a field read is only
+// trusted when nothing rewrites that field
+TypeChecker::TypePtr TypeChecker::fieldType(const ClassInfo &info,
+                                            size_t index) const {
+  const TypePtr &type = info.fieldTypes[index];
+  if (isCollection(type) || anyFieldRewritten ||
+      rewrittenFields.find(info.fieldNames[index]) != rewrittenFields.end()) {
+    return unknownType();
+  }
+  return type;
+}
+
+bool TypeChecker::isShadowed(const std::string &name) const {
+  for (const auto &scope : scopes) {
+    if (scope.find(name) != scope.end()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+TypeChecker::TypePtr
+TypeChecker::resolveTypeExpr(const std::shared_ptr<Expr> &expr) {
+  if (auto list = std::dynamic_pointer_cast<ListTypeExpr>(expr)) {
+    return AutumnListType::getInstance(resolveTypeExpr(list->typeexpr));
+  }
+  if (auto set = std::dynamic_pointer_cast<SetTypeExpr>(expr)) {
+    return AutumnSetType::getInstance(resolveTypeExpr(set->typeexpr));
+  }
+  if (auto map = std::dynamic_pointer_cast<MapTypeExpr>(expr)) {
+    TypePtr keyType = resolveTypeExpr(map->keytypeexpr);
+    return AutumnMapType::getInstance(keyType,
+                                      resolveTypeExpr(map->valuetypeexpr));
+  }
+  auto var = std::dynamic_pointer_cast<TypeVariable>(expr);
+  if (var == nullptr) {
+    errors.push_back("Invalid type expression " + AstPrinter().print(expr));
+    return unknownType();
+  }
+  const std::string &name = var->name.lexeme;
+  if (name == "Int" || name == "Number") {
+    return numberType();
+  }
+  if (name == "Bool") {
+    return boolType();
+  }
+  if (name == "String") {
+    return stringType();
+  }
+  if (name == "Cell") {
+    return cellType;
+  }
+  auto cls = classes.find(name);
+  if (cls != classes.end()) {
+    return cls->second.type;
+  }
+  errors.push_back("Unknown type '" + name + "'");
+  return unknownType();
+}
+
+bool TypeChecker::checkValue(const std::string &name,
+                             const TypePtr &valueType) {
+  if (isShadowed(name)) {
+    return false;
+  }
+  auto declared = declaredTypes.find(name);
+  if (declared == declaredTypes.end()) {
+    return false;
+  }
+  // Collections are not checked on assignment at runtime either
+  if (isKnown(valueType) && !isCollection(declared->second) &&
+      !AutumnType::isAssignable(declared->second.get(), valueType.get())) {
+    errors.push_back("Cannot assign value of type '" + valueType->toString() +
+                     "' to variable of type '" +
+                     declared->second->toString() + "' for variable '" +
+                     name + "'.");
+  }
+  if (!AutumnType::sameType(valueType.get(), declared->second.get())) {
+    unprovenWrites.insert(name);
+    return false;
+  }
+  // The runtime also compares against the previous value, which is only
+  // known to be well-typed when every write to the variable is proven
+  return trustedVars.find(name) != trustedVars.end();
+}
+
+std::any TypeChecker::visitAssignExpr(std::shared_ptr<Assign> expr) {
+  const std::string &name = expr->name.lexeme;
+  if (auto initNext = std::dynamic_pointer_cast<InitNext>(expr->value)) {
+    bool initProven = checkValue(name, typeOf(initNext->initializer));
+    bool nextProven = checkValue(name, typeOf(initNext->nextExpr));
+    if (initProven && nextProven) {
+      provenNexts.insert(name);
+    }
+    return unknownType();
+  }
+  TypePtr valueType = typeOf(expr->value);
+  if (checkValue(name, valueType)) {
+    provenExprs.insert(expr.get());
+  }
+  if (!scopes.empty() && !isShadowed(name) &&
+      declaredTypes.find(name) == declaredTypes.end()) {
+    // A new local; make sure later reads do not see a global's type
+    scopes.back()[name] = unknownType();
+  }
+  return valueType;
+}
+
+std::any TypeChecker::visitBinaryExpr(std::shared_ptr<Binary> expr) {
+  TypePtr left = typeOf(expr->left);
+  TypePtr right = typeOf(expr->right);
+  TypePtr number = numberType();
+  switch (expr->op.type) {
+  case TokenType::PLUS:
+  case TokenType::MINUS:
+  case TokenType::STAR:
+  case TokenType::SLASH:
+  case TokenType::MODULO:
+  case TokenType::GREATER:
+  case TokenType::GREATER_EQUAL:
+  case TokenType::LESS:
+  case TokenType::LESS_EQUAL:
+    if ((isKnown(left) && !AutumnType::sameType(left.get(), number.get())) ||
+        (isKnown(right) && !AutumnType::sameType(right.get(), number.get()))) {
+      errors.push_back("Binary " + expr->op.lexeme +
+                       " must be applied to two numbers, instead got " +
+                       left->toString() + " and " + right->toString() +
+                       " in " + AstPrinter().print(expr));
+    }
+    break;
+  default:
+    break;
+  }
+  switch (expr->op.type) {
+  case TokenType::PLUS:
+  case TokenType::MINUS:
+  case TokenType::STAR:
+  case TokenType::SLASH:
+  case TokenType::MODULO:
+    return number;
+  case TokenType::GREATER:
+  case TokenType::GREATER_EQUAL:
+  case TokenType::LESS:
+  case TokenType::LESS_EQUAL:
+  case TokenType::EQUAL_EQUAL:
+  case TokenType::BANG_EQUAL:
+    return boolType();
+  default:
+    return unknownType();
+  }
+}
+
+std::any TypeChecker::visitCallExpr(std::shared_ptr<Call> expr) {
+  std::vector<TypePtr> argTypes;
+  argTypes.reserve(expr->arguments.size());
+  for (const auto &argument : expr->arguments) {
+    argTypes.push_back(typeOf(argument));
+  }
+  auto callee = std::dynamic_pointer_cast<Variable>(expr->callee);
+  if (callee == nullptr) {
+    typeOf(expr->callee);
+    return unknownType();
+  }
+  const std::string &name = callee->name.lexeme;
+  if (isShadowed(name)) {
+    return unknownType();
+  }
+  if (name == "Cell") {
+    return cellType;
+  }
+  auto cls = classes.find(name);
+  if (cls != classes.end()) {
+    const ClassInfo &info = cls->second;
+    if (argTypes.size() != info.fieldNames.size()) {
+      errors.push_back("Class " + name + " expects " +
+                       std::to_string(info.fieldNames.size()) +
+                       " arguments, got " + std::to_string(argTypes.size()) +
+                       " in " + AstPrinter().print(expr));
+      return info.type;
+    }
+    bool proven = true;
+    for (size_t i = 0; i < argTypes.size(); i++) {
+      if (!isKnown(argTypes[i]) || !isKnown(info.fieldTypes[i])) {
+        proven = false;
+        continue;
+      }
+      if (!AutumnType::isAssignable(info.fieldTypes[i].get(),
+                                    argTypes[i].get())) {
+        errors.push_back("Field type mismatch: " + info.fieldNames[i] +
+                         " with type " + argTypes[i]->toString() + " vs " +
+                         info.fieldTypes[i]->toString() + " in " +
+                         AstPrinter().print(expr));
+        proven = false;
+      }
+    }
+    if (proven) {
+      provenExprs.insert(expr.get());
+    }
+    return info.type;
+  }
+  if (name == "updateObj" && expr->arguments.size() == 3) {
+    auto field = std::dynamic_pointer_cast<Literal>(expr->arguments[1]);
+    if (field != nullptr && field->value.type() == typeid(std::string)) {
+      rewrittenFields.insert(AutumnInstance::normalizeName(
+          std::any_cast<std::string>(field->value)));
+    } else {
+      anyFieldRewritten = true;
+    }
+    return unknownType();
+  }
+  if (name == "prev" && expr->arguments.size() == 1) {
+    // prev accepts the variable itself or its name as a string
+    if (std::dynamic_pointer_cast<Variable>(expr->arguments[0]) != nullptr) {
+      return argTypes[0];
+    }
+    auto var = std::dynamic_pointer_cast<Literal>(expr->arguments[0]);
+    if (var != nullptr && var->value.type() == typeid(std::string)) {
+      return lookup(AutumnInstance::normalizeName(
+          std::any_cast<std::string>(var->value)));
+    }
+    return unknownType();
+  }
+  if (declaredTypes.find(name) == declaredTypes.end()) {
+    if (TypePtr builtin = builtinResultType(name)) {
+      return builtin;
+    }
+  }
+  return unknownType();
+}
+
+std::any TypeChecker::visitGetExpr(std::shared_ptr<Get> expr) {
+  TypePtr objectType = typeOf(expr->object);
+  auto cls = classes.find(objectType->toString());
+  if (cls == classes.end() || cls->second.type != objectType) {
+    return unknownType();
+  }
+  const ClassInfo &info = cls->second;
+  for (size_t i = 0; i < info.fieldNames.size(); i++) {
+    if (info.fieldNames[i] == expr->name.lexeme) {
+      return fieldType(info, i);
+    }
+  }
+  return unknownType();
+}
+
+std::any TypeChecker::visitGroupingExpr(std::shared_ptr<Grouping> expr) {
+  return typeOf(expr->expression);
+}
+
+std::any TypeChecker::visitLiteralExpr(std::shared_ptr<Literal> expr) {
+  if (expr->value.type() == typeid(int)) {
+    return numberType();
+  }
+  if (expr->value.type() == typeid(bool)) {
+    return boolType();
+  }
+  if (expr->value.type() == typeid(std::string)) {
+    return stringType();
+  }
+  // Instances folded by the optimizer
+  if (auto instance = std::dynamic_pointer_cast<AutumnInstance>(expr->constant)) {
+    auto cls = classes.find(instance->getClassName());
+    if (cls != classes.end()) {
+      return cls->second.type;
+    }
+  }
+  return unknownType();
+}
+
+std::any TypeChecker::visitLogicalExpr(std::shared_ptr<Logical> expr) {
+  TypePtr left = typeOf(expr->left);
+  TypePtr right = typeOf(expr->right);
+  TypePtr boolean = boolType();
+  if (left == boolean && right == boolean) {
+    return boolean;
+  }
+  return unknownType();
+}
+
+std::any TypeChecker::visitSetExpr(std::shared_ptr<Set> expr) {
+  typeOf(expr->object);
+  typeOf(expr->value);
+  anyFieldRewritten = true;
+  return unknownType();
+}
+
+std::any TypeChecker::visitUnaryExpr(std::shared_ptr<Unary> expr) {
+  typeOf(expr->right);
+  switch (expr->op.type) {
+  case TokenType::MINUS:
+  case TokenType::PLUS:
+    return numberType();
+  case TokenType::BANG:
+    return boolType();
+  default:
+    return unknownType();
+  }
+}
+
+std::any TypeChecker::visitLambdaExpr(std::shared_ptr<Lambda> expr) {
+  scopes.emplace_back();
+  for (const auto &param : expr->params) {
+    scopes.back()[param.lexeme] = unknownType();
+  }
+  typeOf(expr->right);
+  scopes.pop_back();
+  return unknownType();
+}
+
+std::any TypeChecker::visitVariableExpr(std::shared_ptr<Variable> expr) {
+  return lookup(expr->name.lexeme);
+}
+
+std::any TypeChecker::visitTypeVariableExpr(std::shared_ptr<TypeVariable> expr) {
+  return unknownType();
+}
+
+std::any TypeChecker::visitTypeDeclExpr(std::shared_ptr<TypeDecl> expr) {
+  return unknownType();
+}
+
+std::any TypeChecker::visitListTypeExprExpr(std::shared_ptr<ListTypeExpr> expr) {
+  return unknownType();
+}
+
+std::any TypeChecker::visitSetTypeExprExpr(std::shared_ptr<SetTypeExpr> expr) {
+  return unknownType();
+}
+
+std::any TypeChecker::visitMapTypeExprExpr(std::shared_ptr<MapTypeExpr> expr) {
+  return unknownType();
+}
+
+std::any TypeChecker::visitListVarExprExpr(std::shared_ptr<ListVarExpr> expr) {
+  TypePtr elementType;
+  bool uniform = true;
+  for (const auto &element : expr->varExprs) {
+    TypePtr type = typeOf(element);
+    if (elementType == nullptr) {
+      elementType = type;
+    } else if (!AutumnType::sameType(elementType.get(), type.get())) {
+      uniform = false;
+    }
+  }
+  if (elementType == nullptr) {
+    return TypePtr(AutumnListType::getInstance());
+  }
+  if (!uniform || !isKnown(elementType)) {
+    return unknownType();
+  }
+  return TypePtr(AutumnListType::getInstance(elementType));
+}
+
+std::any TypeChecker::visitIfExprExpr(std::shared_ptr<IfExpr> expr) {
+  typeOf(expr->condition);
+  TypePtr thenType = typeOf(expr->thenBranch);
+  TypePtr elseType = typeOf(expr->elseBranch);
+  if (AutumnType::sameType(thenType.get(), elseType.get())) {
+    return thenType;
+  }
+  return unknownType();
+}
+
+std::any TypeChecker::visitLetExpr(std::shared_ptr<Let> expr) {
+  TypePtr type = unknownType();
+  for (const auto &subexpr : expr->exprs) {
+    type = typeOf(subexpr);
+  }
+  return type;
+}
+
+std::any TypeChecker::visitInitNextExpr(std::shared_ptr<InitNext> expr) {
+  typeOf(expr->initializer);
+  typeOf(expr->nextExpr);
+  return unknownType();
+}
+
+std::any TypeChecker::visitBlockStmt(std::shared_ptr<Block> stmt) {
+  for (const auto &sub : stmt->statements) {
+    sub->accept(*this);
+  }
+  return nullptr;
+}
+
+std::any TypeChecker::visitObjectStmt(std::shared_ptr<Object> stmt) {
+  // The cell expression sees the object's fields
+  const ClassInfo &info = classes[stmt->name.lexeme];
+  scopes.emplace_back();
+  for (size_t i = 0; i < info.fieldNames.size(); i++) {
+    scopes.back()[info.fieldNames[i]] = fieldType(info, i);
+  }
+  typeOf(stmt->Cell);
+  scopes.pop_back();
+  return nullptr;
+}
+
+std::any TypeChecker::visitExpressionStmt(std::shared_ptr<Expression> stmt) {
+  typeOf(stmt->expression);
+  return nullptr;
+}
+
+std::any TypeChecker::visitOnStmtStmt(std::shared_ptr<OnStmt> stmt) {
+  typeOf(stmt->condition);
+  typeOf(stmt->expr);
+  return nullptr;
+}
+
+} // namespace Autumn
@@ -19,8 +19,9 @@ AddObj::call(Interpreter &interpreter,
   if (list == nullptr) {
     throw Error("AddObj() first argument must be a list");
   }
+  // Share the existing elements; only the appended path is copied.
   std::shared_ptr<AutumnList> newList =
-      std::dynamic_pointer_cast<AutumnList>(list->copy());
+      makeValue<AutumnList>(*list->getValues(), list->getType());
   std::shared_ptr<AutumnInstance> obj =
       std::dynamic_pointer_cast<AutumnInstance>(arguments[1]);
   std::shared_ptr<AutumnList> newListObj =
@@ -30,15 +31,17 @@ AddObj::call(Interpreter &interpreter,
                 arguments[1]->toString());
   }
   if (obj != nullptr) {
+    // Like a list literal, the list keeps its own copy of an interned
+    // position so removeObj can find this element by identity
+    if (obj->isInterned()) {
+      obj = std::static_pointer_cast<AutumnInstance>(obj->copy());
+    }
     newList->add(obj);
     return newList;
   } else {
-    newList->getValues()->reserve(newListObj->getValues()->size());
     // FIXME: check the type of two lists first.
     // Trust that all elements in newListObj are instances due to add checking in the former list.
-    newList->getValues()->insert(newList->getValues()->end(),
-                                 newListObj->getValues()->begin(),
-                                 newListObj->getValues()->end());
+    newList->getValues()->append(*newListObj->getValues());
     return newList;
   }
 }
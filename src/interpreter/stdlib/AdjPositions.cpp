@@ -28,21 +28,9 @@ AdjPositions::call(Interpreter &interpreter,
 
   int x = std::dynamic_pointer_cast<AutumnNumber>(pos->get("x"))->getNumber();
   int y = std::dynamic_pointer_cast<AutumnNumber>(pos->get("y"))->getNumber();
-  std::vector<std::pair<int, int>> adjPos = {
-      {x - 1, y}, {x + 1, y}, {x, y - 1}, {x, y + 1}};
-  std::vector<std::shared_ptr<AutumnValue>> adjPosValues;
-  int grid_size = std::dynamic_pointer_cast<AutumnNumber>(interpreter.getEnvironment()->get("GRID_SIZE"))->getNumber();
-  for (size_t i = 0; i < adjPos.size(); i++) {
-    if (adjPos[i].first < 0 || adjPos[i].first >= grid_size ||
-        adjPos[i].second < 0 || adjPos[i].second >= grid_size) {
-      continue;
-    }
-    std::vector<std::shared_ptr<AutumnValue>> xy;
-    xy.push_back(std::make_shared<AutumnNumber>(adjPos[i].first));
-    xy.push_back(std::make_shared<AutumnNumber>(adjPos[i].second));
-    adjPosValues.push_back(std::make_shared<AutumnInstance>(PositionClass, xy));
-  }
-  return std::make_shared<AutumnList>(std::make_shared<std::vector<std::shared_ptr<AutumnValue>>>(adjPosValues));
+  return makeValue<AutumnList>(
+      interpreter.getPositions().neighbors(x, y, interpreter.getGridSize()),
+      AutumnListType::getInstance(PositionClass));
 }
 
 int AdjPositions::arity() { return 1; }
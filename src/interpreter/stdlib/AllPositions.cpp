@@ -27,16 +27,9 @@ AllPositions::call(Interpreter &interpreter,
     if (num->getNumber() < 0) {
       throw Error("AllPositions() argument 1 must be a positive number");
     }
-    std::shared_ptr<AutumnList> newList = std::make_shared<AutumnList>();
-    for (int i = 0; i < num->getNumber(); i++) {
-      for (int j = 0; j < num->getNumber(); j++) {
-        newList->add(std::make_shared<AutumnInstance>(
-            PositionClass, std::vector<std::shared_ptr<AutumnValue>>(
-                               {std::make_shared<AutumnNumber>(i),
-                                std::make_shared<AutumnNumber>(j)})));
-      }
-    }
-    return newList;
+    return makeValue<AutumnList>(
+        interpreter.getPositions().grid(num->getNumber(), num->getNumber()),
+        AutumnListType::getInstance(PositionClass));
   } else {
     std::shared_ptr<AutumnNumber> num1 =
         std::dynamic_pointer_cast<AutumnNumber>(arguments[0]);
@@ -60,16 +53,9 @@ AllPositions::call(Interpreter &interpreter,
       //           << std::endl;
       throw Error("AllPositions() argument 2 must be a positive number");
     }
-    std::shared_ptr<AutumnList> newList = std::make_shared<AutumnList>();
-    for (int i = 0; i < num1->getNumber(); i++) {
-      for (int j = 0; j < num2->getNumber(); j++) {
-        newList->add(std::make_shared<AutumnInstance>(
-            PositionClass, std::vector<std::shared_ptr<AutumnValue>>(
-                               {std::make_shared<AutumnNumber>(i),
-                                std::make_shared<AutumnNumber>(j)})));
-      }
-    }
-    return newList;
+    return makeValue<AutumnList>(
+        interpreter.getPositions().grid(num1->getNumber(), num2->getNumber()),
+        AutumnListType::getInstance(PositionClass));
   }
 }
 
@@ -5,8 +5,12 @@
 #include "Environment.hpp"
 #include "Interpreter.hpp"
 #include <Error.hpp>
+#include <atomic>
 #include <cassert>
+#include <exception>
+#include <limits>
 #include <memory>
+#include <mutex>
 
 namespace Autumn {
 
@@ -65,14 +69,59 @@ Any::call(Interpreter &interpreter,
     throw Error("Any() list argument must be a list");
   }
 
-  for (auto &value : *list->getValues()) {
-    std::vector<std::shared_ptr<AutumnValue>> args = {value};
-    std::shared_ptr<AutumnValue> result = callable->call(interpreter, args);
-    if (result->isTruthy()) {
-      return std::make_shared<AutumnBool>(true);
+  const auto &values = *list->getValues();
+  if (values.size() >= kParallelMinSize && interpreter.canRunParallel() &&
+      isPureLambda(*callable)) {
+    list->settleTypes();
+    return AutumnBool::of(anyParallel(interpreter, callable, values));
+  }
+  std::vector<std::shared_ptr<AutumnValue>> args(1);
+  for (auto &value : values) {
+    args[0] = value;
+    if (callable->call(interpreter, args)->isTruthy()) {
+      return AutumnBool::of(true);
     }
   }
-  return std::make_shared<AutumnBool>(false);
+  return AutumnBool::of(false);
+}
+
+bool Any::anyParallel(Interpreter &interpreter,
+                      std::shared_ptr<AutumnCallableValue> callable,
+                      const ValueList &values) {
+  constexpr size_t kNone = std::numeric_limits<size_t>::max();
+  std::atomic<size_t> firstMatch{kNone};
+  // The sequential loop only reports an error met before the first match,
+  // so keep the earliest one and decide once every slice is done
+  std::mutex errorMutex;
+  size_t errorIndex = kNone;
+  std::exception_ptr error;
+  interpreter.parallelFor(
+      "any", values.size(), [&](Interpreter &worker, size_t begin, size_t end) {
+        std::vector<std::shared_ptr<AutumnValue>> args(1);
+        for (size_t i = begin; i < end && i < firstMatch.load(); ++i) {
+          args[0] = values[i];
+          try {
+            if (!callable->call(worker, args)->isTruthy()) {
+              continue;
+            }
+          } catch (...) {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (i < errorIndex) {
+              errorIndex = i;
+              error = std::current_exception();
+            }
+            return;
+          }
+          size_t seen = firstMatch.load();
+          while (i < seen && !firstMatch.compare_exchange_weak(seen, i)) {
+          }
+          return;
+        }
+      });
+  if (error != nullptr && errorIndex < firstMatch.load()) {
+    std::rethrow_exception(error);
+  }
+  return firstMatch.load() != kNone;
 }
 
 } // namespace Autumn
@@ -31,11 +31,11 @@ ArrayEqual::call(Interpreter &interpreter,
     throw Error("ArrayEqual() lists must have the same length");
   }
 
-  std::shared_ptr<AutumnList> result = std::make_shared<AutumnList>();
+  std::shared_ptr<AutumnList> result = makeValue<AutumnList>();
   
   for (size_t i = 0; i < values1->size(); i++) {
     bool isEqual = (*values1)[i]->isEqual((*values2)[i]);
-    result->add(std::make_shared<AutumnBool>(isEqual));
+    result->add(AutumnBool::of(isEqual));
   }
 
   return result;
@@ -27,14 +27,14 @@ renderValue(Interpreter &interpreter, std::shared_ptr<AutumnValue> value) {
       values.insert(values.end(), pRendered->getValues()->begin(),
                     pRendered->getValues()->end());
     }
-    return std::make_shared<AutumnList>(
+    return makeValue<AutumnList>(
         std::make_shared<std::vector<std::shared_ptr<AutumnValue>>>(values));
   } else if (pInstance != nullptr) {
     if (pInstance->getClass()->findMethod("render") == nullptr) {
       if (interpreter.getVerbose()) {
         std::cerr << "Warning: Instance does not have render method" << std::endl;
       }
-      return std::make_shared<AutumnList>(
+      return makeValue<AutumnList>(
           std::make_shared<std::vector<std::shared_ptr<AutumnValue>>>(
               std::vector<std::shared_ptr<AutumnValue>>()));
     }
@@ -44,7 +44,7 @@ renderValue(Interpreter &interpreter, std::shared_ptr<AutumnValue> value) {
     std::shared_ptr<AutumnValue> result = render->call(interpreter, {});
     return std::dynamic_pointer_cast<AutumnList>(result);
   } else {
-    return std::make_shared<AutumnList>(
+    return makeValue<AutumnList>(
         std::make_shared<std::vector<std::shared_ptr<AutumnValue>>>(
             std::vector<std::shared_ptr<AutumnValue>>({})));
   }
@@ -54,18 +54,13 @@ std::shared_ptr<AutumnValue>
 Clicked::call(Interpreter &interpreter,
               const std::vector<std::shared_ptr<AutumnValue>> &arguments) {
   if (interpreter.getState()->getClicked() == false) {
-    return std::make_shared<AutumnBool>(false);
+    return AutumnBool::of(false);
   }
   interpreter.getGlobals()->define(
-      "click",
-      std::make_shared<AutumnInstance>(
-          PositionClass,
-          std::vector<std::shared_ptr<AutumnValue>>(
-              {std::make_shared<AutumnNumber>(interpreter.getState()->getX()),
-               std::make_shared<AutumnNumber>(
-                   interpreter.getState()->getY())})));
+      "click", interpreter.makePosition(interpreter.getState()->getX(),
+                                        interpreter.getState()->getY()));
   if (arguments.size() == 0) {
-    return std::make_shared<AutumnBool>(true);
+    return AutumnBool::of(true);
   }
   if (arguments.size() == 1) {
     // First, render the obj
@@ -100,10 +95,10 @@ Clicked::call(Interpreter &interpreter,
                    ->getNumber();
       if (x == interpreter.getState()->getX() &&
           y == interpreter.getState()->getY()) {
-        return std::make_shared<AutumnBool>(true);
+        return AutumnBool::of(true);
       }
     }
-    return std::make_shared<AutumnBool>(false);
+    return AutumnBool::of(false);
   } else {
     throw Error("Clicked() takes 0..1 argument(s), got " +
                 std::to_string(arguments.size()));
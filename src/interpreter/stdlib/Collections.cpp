@@ -0,0 +1,216 @@
+#include "AutumnStdComponents.hpp"
+#include "AutumnStdLib.hpp"
+#include "AutumnValue.hpp"
+#include "Environment.hpp"
+#include "Interpreter.hpp"
+#include <Error.hpp>
+#include <memory>
+
+namespace Autumn {
+
+// Element type of a collection holding values of type known after one of
+// type added joins them; an empty collection takes the new type
+static std::shared_ptr<AutumnType>
+joinType(const std::shared_ptr<AutumnType> &known, bool empty,
+         const std::shared_ptr<AutumnType> &added) {
+  if (empty) {
+    return added;
+  }
+  if (AutumnType::sameType(known.get(), added.get())) {
+    return known;
+  }
+  return AutumnUnknownType::getInstance();
+}
+
+static void checkKey(const char *name, const char *role,
+                     const std::shared_ptr<AutumnValue> &key) {
+  if (!isValueKey(key)) {
+    throw Error(std::string(name) + "() " + role +
+                " must be a number, string or position, instead got " +
+                key->toString());
+  }
+}
+
+static std::shared_ptr<AutumnSet>
+insertElement(const std::shared_ptr<AutumnSet> &set,
+              const std::shared_ptr<AutumnValue> &element) {
+  ValueSet values = *set->getValues();
+  auto setType = std::static_pointer_cast<AutumnSetType>(set->getType());
+  auto elementType = joinType(setType->getElementType(), values.empty(),
+                              element->getType());
+  values.insert(element, nullptr);
+  return makeValue<AutumnSet>(values, AutumnSetType::getInstance(elementType));
+}
+
+static std::shared_ptr<AutumnMap>
+insertEntry(const std::shared_ptr<AutumnMap> &map,
+            const std::shared_ptr<AutumnValue> &key,
+            const std::shared_ptr<AutumnValue> &value) {
+  ValueMap values = *map->getValues();
+  auto mapType = std::static_pointer_cast<AutumnMapType>(map->getType());
+  auto keyType =
+      joinType(mapType->getKeyType(), values.empty(), key->getType());
+  auto valueType =
+      joinType(mapType->getValueType(), values.empty(), value->getType());
+  values.insert(key, value);
+  return makeValue<AutumnMap>(values,
+                              AutumnMapType::getInstance(keyType, valueType));
+}
+
+std::shared_ptr<AutumnValue>
+SetOf::call(Interpreter &interpreter,
+            const std::vector<std::shared_ptr<AutumnValue>> &arguments) {
+  if (arguments.size() != 1) {
+    throw Error("SetOf() takes 1 argument");
+  }
+  auto list = std::dynamic_pointer_cast<AutumnList>(arguments[0]);
+  if (list == nullptr) {
+    throw Error("SetOf() argument must be a list");
+  }
+  ValueSet values;
+  std::shared_ptr<AutumnType> elementType = AutumnUnknownType::getInstance();
+  for (const auto &element : *list->getValues()) {
+    checkKey("SetOf", "element", element);
+    elementType = joinType(elementType, values.empty(), element->getType());
+    values.insert(element, nullptr);
+  }
+  return makeValue<AutumnSet>(values, AutumnSetType::getInstance(elementType));
+}
+
+std::shared_ptr<AutumnValue>
+MapOf::call(Interpreter &interpreter,
+            const std::vector<std::shared_ptr<AutumnValue>> &arguments) {
+  if (arguments.size() != 2) {
+    throw Error("MapOf() takes 2 arguments");
+  }
+  auto keys = std::dynamic_pointer_cast<AutumnList>(arguments[0]);
+  auto values = std::dynamic_pointer_cast<AutumnList>(arguments[1]);
+  if (keys == nullptr || values == nullptr) {
+    throw Error("MapOf() arguments must be lists");
+  }
+  if (keys->getValues()->size() != values->getValues()->size()) {
+    throw Error("MapOf() arguments must have the same length");
+  }
+  ValueMap entries;
+  std::shared_ptr<AutumnType> keyType = AutumnUnknownType::getInstance();
+  std::shared_ptr<AutumnType> valueType = AutumnUnknownType::getInstance();
+  auto value = values->getValues()->begin();
+  for (const auto &key : *keys->getValues()) {
+    checkKey("MapOf", "key", key);
+    keyType = joinType(keyType, entries.empty(), key->getType());
+    valueType = joinType(valueType, entries.empty(), (*value)->getType());
+    entries.insert(key, *value);
+    ++value;
+  }
+  return makeValue<AutumnMap>(entries,
+                              AutumnMapType::getInstance(keyType, valueType));
+}
+
+std::shared_ptr<AutumnValue>
+Insert::call(Interpreter &interpreter,
+             const std::vector<std::shared_ptr<AutumnValue>> &arguments) {
+  if (arguments.size() == 2) {
+    auto set = std::dynamic_pointer_cast<AutumnSet>(arguments[0]);
+    if (set == nullptr) {
+      throw Error("Insert() with 2 arguments takes a set");
+    }
+    checkKey("Insert", "element", arguments[1]);
+    return insertElement(set, arguments[1]);
+  }
+  if (arguments.size() == 3) {
+    auto map = std::dynamic_pointer_cast<AutumnMap>(arguments[0]);
+    if (map == nullptr) {
+      throw Error("Insert() with 3 arguments takes a map");
+    }
+    checkKey("Insert", "key", arguments[1]);
+    return insertEntry(map, arguments[1], arguments[2]);
+  }
+  throw Error("Insert() takes 2 or 3 arguments");
+}
+
+std::shared_ptr<AutumnValue>
+Remove::call(Interpreter &interpreter,
+             const std::vector<std::shared_ptr<AutumnValue>> &arguments) {
+  if (arguments.size() != 2) {
+    throw Error("Remove() takes 2 arguments");
+  }
+  // A value that cannot be a key is in neither, so nothing is removed
+  bool key = isValueKey(arguments[1]);
+  if (auto set = std::dynamic_pointer_cast<AutumnSet>(arguments[0])) {
+    ValueSet values = *set->getValues();
+    if (key) {
+      values.erase(arguments[1]);
+    }
+    return makeValue<AutumnSet>(values, set->getType());
+  }
+  if (auto map = std::dynamic_pointer_cast<AutumnMap>(arguments[0])) {
+    ValueMap values = *map->getValues();
+    if (key) {
+      values.erase(arguments[1]);
+    }
+    return makeValue<AutumnMap>(values, map->getType());
+  }
+  throw Error("Remove() first argument must be a set or a map");
+}
+
+std::shared_ptr<AutumnValue>
+Contains::call(Interpreter &interpreter,
+               const std::vector<std::shared_ptr<AutumnValue>> &arguments) {
+  if (arguments.size() != 2) {
+    throw Error("Contains() takes 2 arguments");
+  }
+  bool key = isValueKey(arguments[1]);
+  if (auto set = std::dynamic_pointer_cast<AutumnSet>(arguments[0])) {
+    return AutumnBool::of(key && set->getValues()->contains(arguments[1]));
+  }
+  if (auto map = std::dynamic_pointer_cast<AutumnMap>(arguments[0])) {
+    return AutumnBool::of(key && map->getValues()->contains(arguments[1]));
+  }
+  throw Error("Contains() first argument must be a set or a map");
+}
+
+std::shared_ptr<AutumnValue>
+Lookup::call(Interpreter &interpreter,
+             const std::vector<std::shared_ptr<AutumnValue>> &arguments) {
+  if (arguments.size() != 2 && arguments.size() != 3) {
+    throw Error("Lookup() takes 2 or 3 arguments");
+  }
+  auto map = std::dynamic_pointer_cast<AutumnMap>(arguments[0]);
+  if (map == nullptr) {
+    throw Error("Lookup() first argument must be a map");
+  }
+  const std::shared_ptr<AutumnValue> *value =
+      isValueKey(arguments[1]) ? map->getValues()->find(arguments[1])
+                               : nullptr;
+  if (value != nullptr) {
+    return *value;
+  }
+  if (arguments.size() == 3) {
+    return arguments[2];
+  }
+  throw Error("Lookup() key " + arguments[1]->toString() + " is not in the map");
+}
+
+std::shared_ptr<AutumnValue>
+Keys::call(Interpreter &interpreter,
+           const std::vector<std::shared_ptr<AutumnValue>> &arguments) {
+  if (arguments.size() != 1) {
+    throw Error("Keys() takes 1 argument");
+  }
+  if (auto set = std::dynamic_pointer_cast<AutumnSet>(arguments[0])) {
+    return makeValue<AutumnList>(
+        set->toList(), AutumnListType::getInstance(
+                           std::static_pointer_cast<AutumnSetType>(
+                               set->getType())
+                               ->getElementType()));
+  }
+  if (auto map = std::dynamic_pointer_cast<AutumnMap>(arguments[0])) {
+    return makeValue<AutumnList>(
+        map->keys(), AutumnListType::getInstance(
+                         std::static_pointer_cast<AutumnMapType>(
+                             map->getType())
+                             ->getKeyType()));
+  }
+  throw Error("Keys() argument must be a set or a map");
+}
+} // namespace Autumn
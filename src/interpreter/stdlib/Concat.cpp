@@ -21,17 +21,23 @@ Concat::call(Interpreter &interpreter,
                 arguments[0]->toString());
   }
 
-  std::shared_ptr<AutumnList> pNewList = std::make_shared<AutumnList>();
-  pNewList->getValues()->reserve(list->getValues()->size());
+  // Flattening List<List<T>> gives List<T>; otherwise infer on demand
+  std::shared_ptr<AutumnType> elemType = nullptr;
+  auto outerType =
+      std::dynamic_pointer_cast<AutumnListType>(list->getKnownType());
+  if (outerType != nullptr &&
+      std::dynamic_pointer_cast<AutumnListType>(outerType->getElementType())) {
+    elemType = outerType->getElementType();
+  }
+  std::shared_ptr<AutumnList> pNewList =
+      makeValue<AutumnList>(ValueList(), elemType);
   for (auto &elem : *(list->getValues())) {
     std::shared_ptr<AutumnList> pElemList =
         std::dynamic_pointer_cast<AutumnList>(elem);
     if (pElemList == nullptr) {
       throw Error("Concat() arguments must be a list of lists");
     }
-    pNewList->getValues()->insert(pNewList->getValues()->end(),
-                                  pElemList->getValues()->begin(),
-                                  pElemList->getValues()->end());
+    pNewList->getValues()->append(*pElemList->getValues());
   }
   return pNewList;
 }
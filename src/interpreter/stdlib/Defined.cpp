@@ -25,9 +25,9 @@ Defined::call(Interpreter &Interpreter,
     }
     auto defineds = Interpreter.getGlobals()->getDefinedVariables();
     if (defineds.find(varName) != defineds.end()) {
-      return std::make_shared<AutumnBool>(true);
+      return AutumnBool::of(true);
     }
-    return std::make_shared<AutumnBool>(false);
+    return AutumnBool::of(false);
   }
   throw Error("Defined() argument must be a string");
 }
@@ -17,7 +17,7 @@ namespace Autumn {
 std::shared_ptr<AutumnValue>
 DownPressed::call(Interpreter &interpreter,
                   const std::vector<std::shared_ptr<AutumnValue>> &arguments) {
-  return std::make_shared<AutumnBool>(interpreter.getState()->getDown());
+  return AutumnBool::of(interpreter.getState()->getDown());
 };
 
 int DownPressed::arity() { return 2; }
@@ -39,18 +39,45 @@ Filter::call(Interpreter &interpreter,
         std::string("Filter() second argument must be a list, instead got " +
                     arguments[1]->toString()));
   }
-  std::shared_ptr<AutumnList> newList = std::make_shared<AutumnList>();
-  for (auto &value : *list->getValues()) {
-    std::vector<std::shared_ptr<AutumnValue>> args = {value};
-    std::shared_ptr<AutumnValue> result = callable->call(interpreter, args);
-    std::shared_ptr<AutumnBool> resultBool =
-        std::dynamic_pointer_cast<AutumnBool>(result);
-    if (result->isTruthy()) {
-      newList->add(value);
+  // A filtered list keeps the element type of its input
+  std::shared_ptr<AutumnList> newList =
+      makeValue<AutumnList>(ValueList(), list->getKnownType());
+  const auto &values = *list->getValues();
+  if (values.size() >= kParallelMinSize && interpreter.canRunParallel() &&
+      isPureLambda(*callable)) {
+    list->settleTypes();
+    filterParallel(interpreter, callable, values, *newList->getValues());
+    return newList;
+  }
+  std::vector<std::shared_ptr<AutumnValue>> args(1);
+  for (auto &value : values) {
+    args[0] = value;
+    if (callable->call(interpreter, args)->isTruthy()) {
+      newList->getValues()->push_back(value);
     }
   }
   return newList;
 }
 
+void Filter::filterParallel(Interpreter &interpreter,
+                            std::shared_ptr<AutumnCallableValue> callable,
+                            const ValueList &values, ValueList &kept) {
+  std::vector<char> passed(values.size(), 0);
+  interpreter.parallelFor(
+      "filter", values.size(),
+      [&](Interpreter &worker, size_t begin, size_t end) {
+        std::vector<std::shared_ptr<AutumnValue>> args(1);
+        for (size_t i = begin; i < end; ++i) {
+          args[0] = values[i];
+          passed[i] = callable->call(worker, args)->isTruthy();
+        }
+      });
+  for (size_t i = 0; i < values.size(); ++i) {
+    if (passed[i]) {
+      kept.push_back(values[i]);
+    }
+  }
+}
+
 int Filter::arity() { return 2; }
 } // namespace Autumn
@@ -1,7 +1,9 @@
+#include "AutumnLambda.hpp"
 #include "AutumnStdComponents.hpp"
 #include "AutumnStdLib.hpp"
 #include "AutumnValue.hpp"
 #include "Environment.hpp"
+#include "Expr.hpp"
 #include "Interpreter.hpp"
 #include "Parser.hpp"
 #include <Error.hpp>
@@ -26,11 +28,145 @@ Foldl::call(Interpreter &interpreter,
   if (list == nullptr) {
     throw Error("Foldl() third argument must be a list");
   }
-  for (auto &value : *list->getValues()) {
-    std::vector<std::shared_ptr<AutumnValue>> args = {acc, value};
-    acc = callable->call(interpreter, args);
+  const auto &values = *list->getValues();
+  if (values.size() >= kParallelMinSize && interpreter.canRunParallel() &&
+      isPureLambda(*callable) && isAssociative(interpreter, *callable)) {
+    list->settleTypes();
+    return foldParallel(interpreter, callable, std::move(acc), values);
   }
-  return acc;
+  return foldSequential(interpreter, *callable, std::move(acc), values);
+}
+
+std::shared_ptr<AutumnValue>
+Foldl::foldSequential(Interpreter &interpreter,
+                      AutumnCallableValue &callable,
+                      std::shared_ptr<AutumnValue> acc,
+                      const ValueList &values) {
+  std::vector<std::shared_ptr<AutumnValue>> args = {std::move(acc), nullptr};
+  for (auto &value : values) {
+    args[1] = value;
+    args[0] = callable.call(interpreter, args);
+  }
+  return args[0];
+}
+
+// Whether expr names the parameter a or b, and which
+static int paramIndex(const std::shared_ptr<Expr> &expr, const Token &a,
+                      const Token &b) {
+  auto variable = std::dynamic_pointer_cast<Variable>(expr);
+  if (variable == nullptr) {
+    return -1;
+  }
+  if (variable->name.lexeme == a.lexeme) {
+    return 0;
+  }
+  return variable->name.lexeme == b.lexeme ? 1 : -1;
+}
+
+// Whether the two expressions are the two parameters, in either order
+static bool areBothParams(const std::shared_ptr<Expr> &first,
+                          const std::shared_ptr<Expr> &second, const Token &a,
+                          const Token &b) {
+  int firstIndex = paramIndex(first, a, b);
+  int secondIndex = paramIndex(second, a, b);
+  return firstIndex >= 0 && secondIndex >= 0 && firstIndex != secondIndex;
+}
+
+bool Foldl::isAssociative(Interpreter &interpreter,
+                          const AutumnCallableValue &callable) {
+  auto lambda = dynamic_cast<AutumnLambda *>(callable.callable.get());
+  if (lambda == nullptr) {
+    return false;
+  }
+  const auto &declaration = lambda->getDeclaration();
+  if (declaration->params.size() != 2 ||
+      declaration->params[0].lexeme == declaration->params[1].lexeme) {
+    return false;
+  }
+  const Token &a = declaration->params[0];
+  const Token &b = declaration->params[1];
+  std::shared_ptr<Expr> body = declaration->right;
+  while (auto grouping = std::dynamic_pointer_cast<Grouping>(body)) {
+    body = grouping->expression;
+  }
+
+  // (+ a b) and (* a b), as in sum
+  if (auto binary = std::dynamic_pointer_cast<Binary>(body)) {
+    return (binary->op.type == TokenType::PLUS ||
+            binary->op.type == TokenType::STAR) &&
+           areBothParams(binary->left, binary->right, a, b);
+  }
+  // (if (< a b) then b else a) and the other ways to write max and min
+  if (auto ifExpr = std::dynamic_pointer_cast<IfExpr>(body)) {
+    auto condition = std::dynamic_pointer_cast<Binary>(ifExpr->condition);
+    if (condition == nullptr) {
+      return false;
+    }
+    TokenType op = condition->op.type;
+    return (op == TokenType::LESS || op == TokenType::LESS_EQUAL ||
+            op == TokenType::GREATER || op == TokenType::GREATER_EQUAL) &&
+           areBothParams(condition->left, condition->right, a, b) &&
+           areBothParams(ifExpr->thenBranch, ifExpr->elseBranch, a, b);
+  }
+  // (concat (list a b)); a pure lambda sees the global concat
+  if (auto call = std::dynamic_pointer_cast<Call>(body)) {
+    auto callee = std::dynamic_pointer_cast<Variable>(call->callee);
+    if (callee == nullptr || call->arguments.size() != 1) {
+      return false;
+    }
+    auto pair = std::dynamic_pointer_cast<ListVarExpr>(call->arguments[0]);
+    if (pair == nullptr || pair->varExprs.size() != 2 ||
+        !areBothParams(pair->varExprs[0], pair->varExprs[1], a, b)) {
+      return false;
+    }
+    auto concat = std::dynamic_pointer_cast<AutumnCallableValue>(
+        interpreter.getGlobals()->get(callee->name.lexeme));
+    return concat != nullptr &&
+           dynamic_cast<Concat *>(concat->callable.get()) != nullptr;
+  }
+  return false;
+}
+
+std::shared_ptr<AutumnValue>
+Foldl::foldParallel(Interpreter &interpreter,
+                    std::shared_ptr<AutumnCallableValue> callable,
+                    std::shared_ptr<AutumnValue> acc,
+                    const ValueList &values) {
+  int firstId = AutumnValue::peekInstId();
+  // The fold of each slice, stored at the slice's first index
+  std::vector<std::shared_ptr<AutumnValue>> partials(values.size());
+  std::vector<std::shared_ptr<AutumnValue>> args = {acc, nullptr};
+  try {
+    interpreter.parallelFor(
+        "foldl", values.size(),
+        [&](Interpreter &worker, size_t begin, size_t end) {
+          std::vector<std::shared_ptr<AutumnValue>> args = {values[begin],
+                                                            nullptr};
+          for (size_t i = begin + 1; i < end; ++i) {
+            args[1] = values[i];
+            args[0] = callable->call(worker, args);
+          }
+          partials[begin] = std::move(args[0]);
+        });
+
+    for (auto &partial : partials) {
+      if (partial != nullptr) {
+        args[1] = std::move(partial);
+        args[0] = callable->call(interpreter, args);
+      }
+    }
+  } catch (const std::exception &) {
+    // The slices pair up other elements than the fold does, so an error here
+    // need not be the one the fold would meet first; a pure lambda can
+    // simply be run again in order to raise that one
+    return foldSequential(interpreter, *callable, std::move(acc), values);
+  }
+  // Workers draw ids in whatever order they run; give a new result the same
+  // id on every run
+  if (!args[0]->isInterned() && args[0]->getInstId() >= firstId) {
+    args[0]->renewInstId();
+  }
+  return args[0];
 }
 
 } // namespace Autumn
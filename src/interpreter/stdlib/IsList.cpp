@@ -24,9 +24,9 @@ IsList::call(Interpreter &interpreter,
   std::shared_ptr<AutumnList> list =
       std::dynamic_pointer_cast<AutumnList>(value);
   if (list == nullptr) {
-    return std::make_shared<AutumnBool>(false);
+    return AutumnBool::of(false);
   }
-  return std::make_shared<AutumnBool>(true);
+  return AutumnBool::of(true);
 }
 
 } // namespace Autumn
@@ -23,7 +23,7 @@ std::shared_ptr<AutumnValue> IsOutSideBounds::call(
       std::dynamic_pointer_cast<AutumnBool>(
           callable->call(interpreter, arguments));
   // Invert the result
-  return std::make_shared<AutumnBool>(
+  return AutumnBool::of(
       !std::any_cast<bool>(isWithinBoundRet->getValue()));
 }
 
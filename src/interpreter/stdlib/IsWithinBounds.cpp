@@ -22,14 +22,14 @@ renderValue(Interpreter &interpreter, std::shared_ptr<AutumnValue> value) {
       values.insert(values.end(), pRendered->getValues()->begin(),
                     pRendered->getValues()->end());
     }
-    return std::make_shared<AutumnList>(
+    return makeValue<AutumnList>(
         std::make_shared<std::vector<std::shared_ptr<AutumnValue>>>(values));
   } else if (pInstance != nullptr) {
     if (pInstance->getClass()->findMethod("render") == nullptr) {
       if (interpreter.getVerbose()) {
         std::cerr << "Warning: Instance does not have render method" << std::endl;
       }
-      return std::make_shared<AutumnList>(
+      return makeValue<AutumnList>(
           std::make_shared<std::vector<std::shared_ptr<AutumnValue>>>(
               std::vector<std::shared_ptr<AutumnValue>>()));
     }
@@ -39,7 +39,7 @@ renderValue(Interpreter &interpreter, std::shared_ptr<AutumnValue> value) {
     std::shared_ptr<AutumnValue> result = render->call(interpreter, {});
     return std::dynamic_pointer_cast<AutumnList>(result);
   } else {
-    return std::make_shared<AutumnList>(
+    return makeValue<AutumnList>(
         std::make_shared<std::vector<std::shared_ptr<AutumnValue>>>(
             std::vector<std::shared_ptr<AutumnValue>>({})));
   }
@@ -54,9 +54,7 @@ std::shared_ptr<AutumnValue> IsWithinBounds::call(
     throw Error("IsWithinBounds() takes 1 argument");
   }
   auto renderedElems = renderValue(interpreter, arguments[0]);
-  auto GRID_SIZE = std::dynamic_pointer_cast<AutumnNumber>(
-                       interpreter.getEnvironment()->get("GRID_SIZE"))
-                       ->getNumber();
+  int GRID_SIZE = interpreter.getGridSize();
   for (auto &elem : *(renderedElems->getValues())) {
     auto instance = std::dynamic_pointer_cast<AutumnInstance>(elem);
     if (instance == nullptr) {
@@ -72,10 +70,10 @@ std::shared_ptr<AutumnValue> IsWithinBounds::call(
     auto y = std::dynamic_pointer_cast<AutumnNumber>(position->get("y"))
                  ->getNumber();
     if (x < 0 || x >= GRID_SIZE || y < 0 || y >= GRID_SIZE) {
-      return std::make_shared<AutumnBool>(false);
+      return AutumnBool::of(false);
     }
   }
-  return std::make_shared<AutumnBool>(true);
+  return AutumnBool::of(true);
 }
 
 int IsWithinBounds::arity() { return 1; }
@@ -17,7 +17,7 @@ namespace Autumn {
 std::shared_ptr<AutumnValue>
 LeftPressed::call(Interpreter &interpreter,
                   const std::vector<std::shared_ptr<AutumnValue>> &arguments) {
-  return std::make_shared<AutumnBool>(interpreter.getState()->getLeft());
+  return AutumnBool::of(interpreter.getState()->getLeft());
 };
 
 int LeftPressed::arity() { return 2; }
@@ -21,14 +21,20 @@ Length::call(Interpreter &interpreter,
   }
   std::shared_ptr<AutumnList> list =
       std::dynamic_pointer_cast<AutumnList>(arguments[0]);
-  if (list == nullptr) {
-    if (interpreter.getVerbose()) {
-      std::cerr << "Length() argument must be a list, instead got "
-                << arguments[0]->toString() << std::endl;
-    }
-    throw Error("Length() argument must be a list");
+  if (list != nullptr) {
+    return AutumnNumber::of(list->getValues()->size());
+  }
+  if (auto set = std::dynamic_pointer_cast<AutumnSet>(arguments[0])) {
+    return AutumnNumber::of(set->getValues()->size());
+  }
+  if (auto map = std::dynamic_pointer_cast<AutumnMap>(arguments[0])) {
+    return AutumnNumber::of(map->getValues()->size());
+  }
+  if (interpreter.getVerbose()) {
+    std::cerr << "Length() argument must be a list, instead got "
+              << arguments[0]->toString() << std::endl;
   }
-  return std::make_shared<AutumnNumber>(list->getValues()->size());
+  throw Error("Length() argument must be a list, set or map");
 }
 
 } // namespace Autumn
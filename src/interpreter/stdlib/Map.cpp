@@ -1,4 +1,5 @@
 #include "AutumnCallableValue.hpp"
+#include "AutumnLambda.hpp"
 #include "AutumnStdComponents.hpp"
 #include "AutumnStdLib.hpp"
 #include "AutumnValue.hpp"
@@ -7,10 +8,6 @@
 #include <Error.hpp>
 #include <cassert>
 #include <memory>
-#include <execution>
-#include <future>
-#include <thread>
-#include <mutex>
 
 namespace Autumn {
 std::shared_ptr<AutumnValue>
@@ -34,25 +31,30 @@ Map::call(Interpreter &interpreter,
     }
 
     const auto& input_values = *list->getValues();
-    const size_t size = input_values.size();
+    if (input_values.size() >= kParallelMinSize &&
+        interpreter.canRunParallel() && isPureLambda(*callable)) {
+        list->settleTypes();
+        return mapParallel(interpreter, callable, input_values);
+    }
+    return mapSequential(interpreter, callable, input_values);
+}
 
-    // Choose parallelization strategy based on size
-    if (size < 10000) { // 100 x 100. Disabling parallelization for now.
-        return mapSequential(interpreter, callable, input_values);
-    } else {
-        return mapParallelSTL(interpreter, callable, input_values);
-    }  // Disabling task-based parallelization for now due to unstability and inability to copy interpreter state
+bool isPureLambda(const AutumnCallableValue &callable) {
+    auto lambda = dynamic_cast<AutumnLambda *>(callable.callable.get());
+    return lambda != nullptr && lambda->getDeclaration()->pure;
 }
 
 std::shared_ptr<AutumnValue> 
 Map::mapSequential(Interpreter &interpreter,
                   std::shared_ptr<AutumnCallableValue> callable,
-                  const std::vector<std::shared_ptr<AutumnValue>> &values) {
-    auto newList = std::make_shared<AutumnList>();
-    newList->getValues()->reserve(values.size());
+                  const ValueList &values) {
+    // Element type is inferred from the results if anyone asks for it
+    auto newList = makeValue<AutumnList>(ValueList());
     
+    // One argument slot reused across elements
+    std::vector<std::shared_ptr<AutumnValue>> args(1);
     for (const auto& value : values) {
-        std::vector<std::shared_ptr<AutumnValue>> args = {value};
+        args[0] = value;
         newList->getValues()->push_back(callable->call(interpreter, args));
     }
     
@@ -60,74 +62,30 @@ Map::mapSequential(Interpreter &interpreter,
 }
 
 std::shared_ptr<AutumnValue> 
-Map::mapParallelSTL(Interpreter &interpreter,
-                   std::shared_ptr<AutumnCallableValue> callable,
-                   const std::vector<std::shared_ptr<AutumnValue>> &values) {
-    // For very small lists, just use sequential processing
-    if (values.size() < 32) {
-        return mapSequential(interpreter, callable, values);
-    }
-    
-    auto newList = std::make_shared<AutumnList>();
-    newList->getValues()->reserve(values.size());
-    
-    // Get a pointer to the interpreter
-    Interpreter* interpreter_ptr = &interpreter;
-    
-    // Make a copy of the callable
-    auto callable_copy = callable;
-    
-    // Determine hardware concurrency, with sensible defaults
-    unsigned int num_threads = std::thread::hardware_concurrency();
-    if (num_threads == 0) num_threads = 4;  // Default if detection fails
-    
-    // Calculate chunk size - ensure reasonable chunk sizes for efficiency
-    size_t chunk_size = std::max(size_t(32), values.size() / num_threads);
-    
-    // Store futures for async operations
-    std::vector<std::future<std::vector<std::shared_ptr<AutumnValue>>>> futures;
-    futures.reserve(values.size() / chunk_size + 1);
-    
-    // Process data in chunks
-    for (size_t i = 0; i < values.size(); i += chunk_size) {
-        size_t end = std::min(i + chunk_size, values.size());
-        
-        // Create a copy of the values in this chunk to avoid reference issues
-        std::vector<std::shared_ptr<AutumnValue>> chunk_values;
-        chunk_values.reserve(end - i);
-        for (size_t j = i; j < end; ++j) {
-            chunk_values.push_back(values[j]);
-        }
-        
-        // Launch a task for each chunk with proper captures
-        futures.push_back(std::async(
-            std::launch::async,
-            [interpreter_ptr, callable_copy, chunk_values = std::move(chunk_values)]() {
-                std::vector<std::shared_ptr<AutumnValue>> results;
-                results.reserve(chunk_values.size());
-                
-                // Process each item in this chunk
-                for (const auto& value : chunk_values) {
-                    std::vector<std::shared_ptr<AutumnValue>> args = {value};
-                    results.push_back(callable_copy->call(*interpreter_ptr, args));
-                }
-                
-                return results;
+Map::mapParallel(Interpreter &interpreter,
+                 std::shared_ptr<AutumnCallableValue> callable,
+                 const ValueList &values) {
+    int firstId = AutumnValue::peekInstId();
+    std::vector<std::shared_ptr<AutumnValue>> results(values.size());
+    interpreter.parallelFor(
+        "map", values.size(), [&](Interpreter &worker, size_t begin, size_t end) {
+            std::vector<std::shared_ptr<AutumnValue>> args(1);
+            for (size_t i = begin; i < end; ++i) {
+                args[0] = values[i];
+                results[i] = callable->call(worker, args);
             }
-        ));
-    }
-    
-    // Collect results
-    for (auto& future : futures) {
-        auto chunk_results = future.get();
-        newList->getValues()->insert(
-            newList->getValues()->end(),
-            chunk_results.begin(),
-            chunk_results.end()
-        );
+        });
+
+    // Workers draw ids in whatever order they run; give the new elements
+    // the same ids on every run
+    ValueList resultList;
+    for (auto &result : results) {
+        if (!result->isInterned() && result->getInstId() >= firstId) {
+            result->renewInstId();
+        }
+        resultList.push_back(std::move(result));
     }
-    
-    return newList;
+    return makeValue<AutumnList>(resultList);
 }
 
 int Map::arity() { return 2; }
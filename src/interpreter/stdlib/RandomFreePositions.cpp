@@ -0,0 +1,138 @@
+#include "AutumnStdComponents.hpp"
+#include "AutumnStdLib.hpp"
+#include "AutumnValue.hpp"
+#include "Environment.hpp"
+#include "Interpreter.hpp"
+#include <Error.hpp>
+#include <algorithm>
+#include <memory>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace Autumn {
+
+// Cells drawn per position wanted before the grid is walked instead
+static constexpr uint64_t kRejectionAttempts = 32;
+
+static int gridSizeArgument(const char *name,
+                            const std::shared_ptr<AutumnValue> &argument) {
+  auto num = std::dynamic_pointer_cast<AutumnNumber>(argument);
+  if (num == nullptr) {
+    throw Error(std::string(name) + "() argument 1 must be a number");
+  }
+  if (num->getNumber() < 0) {
+    throw Error(std::string(name) + "() argument 1 must be a positive number");
+  }
+  return num->getNumber();
+}
+
+static int countArgument(const char *name,
+                         const std::shared_ptr<AutumnValue> &argument) {
+  auto num = std::dynamic_pointer_cast<AutumnNumber>(argument);
+  if (num == nullptr) {
+    throw Error(std::string(name) + "() argument 2 must be a number");
+  }
+  return std::max(num->getNumber(), 0);
+}
+
+// Up to count distinct cells of the size x size grid, uniformly at random
+// and in the order drawn, skipping the occupied ones when freeOnly is set.
+// Cells are drawn whole and redrawn when taken, which stays cheap while most
+// of the grid is available; once the draws keep missing, the rest are picked
+// from the cells left, so a full grid costs one walk and not an endless loop.
+static std::vector<std::pair<int, int>>
+sampleCells(Interpreter &interpreter, int size, int count, bool freeOnly) {
+  std::vector<std::pair<int, int>> cells;
+  if (size <= 0 || count <= 0) {
+    return cells;
+  }
+  auto globals = interpreter.getGlobals();
+  uint64_t total = static_cast<uint64_t>(size) * size;
+  uint64_t occupied = freeOnly ? globals->countOccupied(size, size) : 0;
+  uint64_t wanted = std::min<uint64_t>(count, total - occupied);
+  cells.reserve(wanted);
+
+  RandomGenerator::Stream random = interpreter.randomStream();
+  std::unordered_set<std::pair<int, int>, pair_hash> taken;
+  auto available = [&](int x, int y) {
+    return (!freeOnly || globals->isFreePos(x, y)) &&
+           taken.find({x, y}) == taken.end();
+  };
+
+  uint64_t attempts = kRejectionAttempts * wanted;
+  while (cells.size() < wanted && attempts-- > 0) {
+    uint64_t cell = random.next(total);
+    int x = cell % size;
+    int y = cell / size;
+    if (available(x, y)) {
+      taken.insert({x, y});
+      cells.push_back({x, y});
+    }
+  }
+  if (cells.size() < wanted) {
+    std::vector<std::pair<int, int>> rest;
+    for (int y = 0; y < size; y++) {
+      for (int x = 0; x < size; x++) {
+        if (available(x, y)) {
+          rest.push_back({x, y});
+        }
+      }
+    }
+    // The first picks of a Fisher-Yates shuffle of what is left
+    for (size_t i = 0; i < rest.size() && cells.size() < wanted; i++) {
+      std::swap(rest[i], rest[i + random.next(rest.size() - i)]);
+      cells.push_back(rest[i]);
+    }
+  }
+  return cells;
+}
+
+static std::shared_ptr<AutumnList>
+positionList(Interpreter &interpreter,
+             const std::vector<std::pair<int, int>> &cells) {
+  std::shared_ptr<AutumnList> list = makeValue<AutumnList>(
+      ValueList(), AutumnListType::getInstance(PositionClass));
+  for (const auto &[x, y] : cells) {
+    list->getValues()->push_back(interpreter.makePosition(x, y));
+  }
+  return list;
+}
+
+std::shared_ptr<AutumnValue>
+RandomFreePos::call(Interpreter &interpreter,
+                    const std::vector<std::shared_ptr<AutumnValue>> &arguments) {
+  if (arguments.size() != 1) {
+    throw Error("randomFreePos() takes 1 argument");
+  }
+  int size = gridSizeArgument("randomFreePos", arguments[0]);
+  auto cells = sampleCells(interpreter, size, 1, true);
+  if (cells.empty()) {
+    throw Error("randomFreePos() found no free position");
+  }
+  return interpreter.makePosition(cells[0].first, cells[0].second);
+}
+
+std::shared_ptr<AutumnValue> RandomFreePositions::call(
+    Interpreter &interpreter,
+    const std::vector<std::shared_ptr<AutumnValue>> &arguments) {
+  if (arguments.size() != 2) {
+    throw Error("randomFreePositions() takes 2 arguments");
+  }
+  int size = gridSizeArgument("randomFreePositions", arguments[0]);
+  int count = countArgument("randomFreePositions", arguments[1]);
+  return positionList(interpreter, sampleCells(interpreter, size, count, true));
+}
+
+std::shared_ptr<AutumnValue> RandomDistinctPositions::call(
+    Interpreter &interpreter,
+    const std::vector<std::shared_ptr<AutumnValue>> &arguments) {
+  if (arguments.size() != 2) {
+    throw Error("randomDistinctPositions() takes 2 arguments");
+  }
+  int size = gridSizeArgument("randomDistinctPositions", arguments[0]);
+  int count = countArgument("randomDistinctPositions", arguments[1]);
+  return positionList(interpreter,
+                      sampleCells(interpreter, size, count, false));
+}
+} // namespace Autumn
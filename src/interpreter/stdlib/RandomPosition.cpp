@@ -23,22 +23,20 @@ std::shared_ptr<AutumnValue> RandomPositions::call(
     throw Error("RandomPositions() argument 1 must be a positive number");
   }
 
-  std::shared_ptr<RandomGenerator> randomGen = interpreter.getRandomGenerator();
+  RandomGenerator::Stream random = interpreter.randomStream();
 
   std::shared_ptr<AutumnNumber> arg2 =
       std::dynamic_pointer_cast<AutumnNumber>(arguments[1]);
   if (arg2 == nullptr) {
     throw Error("RandomPositions() argument 2 must be a number");
   }
-  std::shared_ptr<AutumnList> newList = std::make_shared<AutumnList>();
+  std::shared_ptr<AutumnList> newList = makeValue<AutumnList>();
   if (list == nullptr) {
     for (int i = 0; i < arg2->getNumber(); i++) {
-      newList->add(std::make_shared<AutumnInstance>(
-          PositionClass,
-          std::vector<std::shared_ptr<AutumnValue>>(
-              {std::make_shared<AutumnNumber>(randomGen->next(num->getNumber())),
-               std::make_shared<AutumnNumber>(randomGen->next(num->getNumber()))
-               })));
+      // Draw x before y, as the arguments' evaluation order is unspecified
+      int x = random.next(num->getNumber());
+      int y = random.next(num->getNumber());
+      newList->add(interpreter.makePosition(x, y));
     }
   }
   return newList;
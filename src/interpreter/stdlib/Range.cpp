@@ -24,9 +24,10 @@ Range::call(Interpreter &interpreter,
   if (end == nullptr) {
     throw Error("Range() second argument must be an integer");
   }
-  std::shared_ptr<AutumnList> list = std::make_shared<AutumnList>();
+  std::shared_ptr<AutumnList> list = makeValue<AutumnList>(
+      ValueList(), AutumnListType::getInstance(AutumnNumberType::getInstance()));
   for (int i = start->getNumber(); i < end->getNumber(); i++) {
-    list->add(std::make_shared<AutumnNumber>(i));
+    list->getValues()->push_back(AutumnNumber::of(i));
   }
   return list;
 }
@@ -40,50 +40,54 @@ RemoveObj::call(Interpreter &interpreter,
     if (list == nullptr) {
       throw Error("RemoveObj() first argument must be a list");
     }
-    std::shared_ptr<std::vector<std::shared_ptr<AutumnValue>>> pList =
-        list->getValues();
+    std::shared_ptr<ValueList> pList = list->getValues();
 
-    std::shared_ptr<std::vector<std::shared_ptr<AutumnValue>>> valueList =
-        std::make_shared<std::vector<std::shared_ptr<AutumnValue>>>();
-    valueList->reserve(pList->size());
+    // Collect the indices to drop, then erase them from a shared copy so the
+    // untouched parts of the list are not copied.
+    std::vector<size_t> removed;
+    size_t index = 0;
     if (callable != nullptr) {
       for (const auto &value : *pList) {
         if (callable->call(interpreter, {value})->isTruthy()) {
-          continue;
+          removed.push_back(index);
         }
-        valueList->push_back(value);
+        index++;
       }
-      std::shared_ptr<AutumnList> newList =
-          std::make_shared<AutumnList>(valueList);
-      return newList;
+    } else if (instance != nullptr && instance->isInterned()) {
+      // An interned position is shared by every list that holds it, so it
+      // carries no identity and matches nothing
     } else if (instance != nullptr) {
       for (const auto &value : *pList) {
         if (value->getInstId() == instance->getInstId()) {
-          continue;
+          removed.push_back(index);
         }
-        valueList->push_back(value);
+        index++;
       }
-      std::shared_ptr<AutumnList> newList =
-          std::make_shared<AutumnList>(valueList);
-      return newList;
     } else if (rmList != nullptr) {
+      // Cached numbers and bools and interned positions are shared, so
+      // they carry no identity and never match
       auto rmLists = std::unordered_set<int>();
       for (const auto &value : *rmList->getValues()) {
-        rmLists.insert(value->getInstId());
+        if (!value->isInterned()) {
+          rmLists.insert(value->getInstId());
+        }
       }
       for (const auto &value : *pList) {
-        if (rmLists.find(value->getInstId()) != rmLists.end()) {
-          continue;
+        if (!value->isInterned() &&
+            rmLists.find(value->getInstId()) != rmLists.end()) {
+          removed.push_back(index);
         }
-        valueList->push_back(value);
+        index++;
       }
-      std::shared_ptr<AutumnList> newList =
-          std::make_shared<AutumnList>(valueList);
-      return newList;
     } else {
       throw Error("RemoveObj() second argument must be a callable, instance, "
                   "or list");
     }
+    ValueList valueList = *pList;
+    for (auto it = removed.rbegin(); it != removed.rend(); ++it) {
+      valueList.erase(*it);
+    }
+    return makeValue<AutumnList>(valueList, list->getKnownType());
   } else {
     throw Error("RemoveObj() takes 1 or 2 arguments");
   }
@@ -23,13 +23,13 @@ renderValue(Interpreter &interpreter, std::shared_ptr<AutumnValue> value) {
       values.insert(values.end(), pRendered->getValues()->begin(),
                     pRendered->getValues()->end());
     }
-    return std::make_shared<AutumnList>(
+    return makeValue<AutumnList>(
         std::make_shared<std::vector<std::shared_ptr<AutumnValue>>>(values));
   } else if (pInstance != nullptr) {
     if (pInstance->getClass()->findMethod("render") == nullptr) {
       // std::cerr << "Warning: Instance does not have render method" <<
       // std::endl;
-      return std::make_shared<AutumnList>(
+      return makeValue<AutumnList>(
           std::make_shared<std::vector<std::shared_ptr<AutumnValue>>>(
               std::vector<std::shared_ptr<AutumnValue>>()));
     }
@@ -39,7 +39,7 @@ renderValue(Interpreter &interpreter, std::shared_ptr<AutumnValue> value) {
     std::shared_ptr<AutumnValue> result = render->call(interpreter, {});
     return std::dynamic_pointer_cast<AutumnList>(result);
   } else {
-    return std::make_shared<AutumnList>(
+    return makeValue<AutumnList>(
         std::make_shared<std::vector<std::shared_ptr<AutumnValue>>>(
             std::vector<std::shared_ptr<AutumnValue>>({})));
   }
@@ -48,15 +48,12 @@ renderValue(Interpreter &interpreter, std::shared_ptr<AutumnValue> value) {
 std::shared_ptr<AutumnValue>
 RenderAll::call(Interpreter &interpreter,
                 const std::vector<std::shared_ptr<AutumnValue>> &arguments) {
-  auto pList = std::make_shared<AutumnList>();
+  auto pList = makeValue<AutumnList>();
   auto mapVal = interpreter.getGlobals()->getDefinedVariables();
   auto keys = interpreter.getGlobals()->getDefinitionOrder();
-  pList->getValues()->reserve(keys.size() * 3);
   for (auto &key : keys) {
     auto renderedElems = renderValue(interpreter, mapVal[key]);
-    pList->getValues()->insert(pList->getValues()->end(),
-                               renderedElems->getValues()->begin(),
-                               renderedElems->getValues()->end());
+    pList->getValues()->append(*renderedElems->getValues());
   }
   interpreter.getGlobals()->assign("cacheRendered", pList);
   return pList;
@@ -17,7 +17,7 @@ namespace Autumn {
 std::shared_ptr<AutumnValue>
 RightPressed::call(Interpreter &interpreter,
                    const std::vector<std::shared_ptr<AutumnValue>> &arguments) {
-  return std::make_shared<AutumnBool>(interpreter.getState()->getRight());
+  return AutumnBool::of(interpreter.getState()->getRight());
 };
 
 int RightPressed::arity() { return 2; }
@@ -26,6 +26,6 @@ Sqrt::call(Interpreter &interpreter,
     throw Error("Sqrt() argument must be non-negative");
   }
 
-  return std::make_shared<AutumnNumber>(static_cast<int>(std::sqrt(value)));
+  return AutumnNumber::of(static_cast<int>(std::sqrt(value)));
 }
 } // namespace Autumn 
\ No newline at end of file
@@ -23,8 +23,7 @@ Tail::call(Interpreter &interpreter,
   if (list->getValues()->size() == 0) {
     throw Error("Tail() argument must not be an empty list");
   }
-  std::shared_ptr<AutumnValue> tail =
-      list->getValues()->at(list->getValues()->size() - 1);
+  std::shared_ptr<AutumnValue> tail = list->getValues()->back();
   return tail;
 }
 } // namespace Autumn
@@ -23,9 +23,8 @@ std::shared_ptr<AutumnValue> UniformChoice::call(
   if (!freeValueList) {
     throw Error("uniformChoice() argument 1 must be a list of values.");
   }
-  std::shared_ptr<std::vector<std::shared_ptr<AutumnValue>>> pValueList =
-      freeValueList->getValues();
-  std::vector<std::shared_ptr<AutumnValue>> &valueList = *pValueList;
+  std::shared_ptr<ValueList> pValueList = freeValueList->getValues();
+  const ValueList &valueList = *pValueList;
 
   size_t freeSize = valueList.size();
   if (freeSize == 0) {
@@ -34,8 +33,8 @@ std::shared_ptr<AutumnValue> UniformChoice::call(
 
   if (arguments.size() == 1) {
     // Return a single random element
-    std::shared_ptr<RandomGenerator> randomGen = interpreter.getRandomGenerator();
-    size_t randomIndex = randomGen->next(freeSize);
+    RandomGenerator::Stream random = interpreter.randomStream();
+    size_t randomIndex = random.next(freeSize);
     return valueList[randomIndex];
   } else {
     // Expecting the second argument to be an integer specifying the number of
@@ -51,11 +50,11 @@ std::shared_ptr<AutumnValue> UniformChoice::call(
       throw Error("uniformChoice() argument 2 must be a positive integer.");
     }
     // Create a list to hold the selected values
-    auto selectedList = std::make_shared<AutumnList>();
+    auto selectedList = makeValue<AutumnList>();
 
-    std::shared_ptr<RandomGenerator> randomGen = interpreter.getRandomGenerator();
+    RandomGenerator::Stream random = interpreter.randomStream();
     for (int i = 0; i < n; ++i) {
-      size_t randomIndex = randomGen->next(freeSize);
+      size_t randomIndex = random.next(freeSize);
       selectedList->add(valueList[randomIndex]); // Assuming add method exists
     }
 
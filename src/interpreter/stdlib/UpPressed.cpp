@@ -17,7 +17,7 @@ namespace Autumn {
 std::shared_ptr<AutumnValue>
 UpPressed::call(Interpreter &interpreter,
                 const std::vector<std::shared_ptr<AutumnValue>> &arguments) {
-  return std::make_shared<AutumnBool>(interpreter.getState()->getUp());
+  return AutumnBool::of(interpreter.getState()->getUp());
 };
 
 int UpPressed::arity() { return 2; }
@@ -29,9 +29,11 @@ UpdateObj::call(Interpreter &interpreter,
       try {
         std::shared_ptr<AutumnValue> retVal = map.call(interpreter, args);
         return retVal;
-      } catch (const Error &e) {
-        throw Error(std::string("Error interpreting UpdateObj - Got\n") +
-                    e.what());
+      } catch (Error &e) {
+        e.wrap([](const std::string &what) {
+          return "Error interpreting UpdateObj - Got\n" + what;
+        });
+        throw;
       }
     } else if (arguments.size() == 3) {
       auto apply_func =
@@ -39,19 +41,17 @@ UpdateObj::call(Interpreter &interpreter,
       auto filter_func =
           std::dynamic_pointer_cast<AutumnCallableValue>(arguments[2]);
       if (apply_func != nullptr && filter_func != nullptr) {
-        std::shared_ptr<AutumnList> retVal = std::make_shared<AutumnList>();
+        // Elements the filter rejects stay shared with the input list.
+        std::shared_ptr<AutumnList> retVal =
+            makeValue<AutumnList>(*list->getValues(), list->getType());
+        size_t index = 0;
+        std::vector<std::shared_ptr<AutumnValue>> args(1);
         for (auto &val : *list->getValues()) {
-          std::vector<std::shared_ptr<AutumnValue>> args = {val};
-          std::vector<std::shared_ptr<AutumnValue>> filter_args = args;
-          std::shared_ptr<AutumnValue> filter_ret =
-              filter_func->call(interpreter, filter_args);
-          if (filter_ret->isTruthy()) {
-            std::shared_ptr<AutumnValue> apply_ret =
-                apply_func->call(interpreter, args);
-            retVal->add(apply_ret);
-          } else {
-            retVal->add(val);
+          args[0] = val;
+          if (filter_func->call(interpreter, args)->isTruthy()) {
+            retVal->set(index, apply_func->call(interpreter, args));
           }
+          index++;
         }
         return retVal;
       } else {
@@ -29,7 +29,7 @@ IsFreePos::call(Interpreter &interpreter,
   }
   int x = std::any_cast<int>(pInstance->get("x")->getValue());
   int y = std::any_cast<int>(pInstance->get("y")->getValue());
-  return std::make_shared<AutumnBool>(
+  return AutumnBool::of(
       interpreter.getGlobals()->isFreePos(x, y));
 }
 } // namespace Autumn
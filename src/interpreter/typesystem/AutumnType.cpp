@@ -1,8 +1,122 @@
 #include "AutumnType.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <utility>
 
 namespace Autumn {
+std::atomic<int> AutumnType::nextTypeId{0};
 std::shared_ptr<AutumnNumberType> AutumnNumberType::instance = nullptr;
 std::shared_ptr<AutumnStringType> AutumnStringType::instance = nullptr;
 std::shared_ptr<AutumnBoolType> AutumnBoolType::instance = nullptr;
 std::shared_ptr<AutumnUnknownType> AutumnUnknownType::instance = nullptr;
+
+bool AutumnType::sameType(const AutumnType *lhs, const AutumnType *rhs) {
+  if (lhs->typeId == rhs->typeId) {
+    return true;
+  }
+  // Distinct type objects only compare equal when they print the same (e.g. a
+  // class redefined with identical fields). Each thread memoizes the answer
+  // per pair of type objects. A freed type's address may come back as
+  // another type, so an entry also records the ids it was made for; ids are
+  // never reused.
+  struct Answer {
+    int lhsId;
+    int rhsId;
+    bool same;
+  };
+  struct PairHash {
+    size_t operator()(
+        const std::pair<const AutumnType *, const AutumnType *> &key) const {
+      return std::hash<const void *>()(key.first) * 31 +
+             std::hash<const void *>()(key.second);
+    }
+  };
+  thread_local std::unordered_map<
+      std::pair<const AutumnType *, const AutumnType *>, Answer, PairHash>
+      memo;
+  if (std::less<const AutumnType *>()(rhs, lhs)) {
+    std::swap(lhs, rhs);
+  }
+  auto key = std::make_pair(lhs, rhs);
+  auto it = memo.find(key);
+  if (it != memo.end() && it->second.lhsId == lhs->typeId &&
+      it->second.rhsId == rhs->typeId) {
+    return it->second.same;
+  }
+  bool result = lhs->toString() == rhs->toString();
+  if (memo.size() > 65536) {
+    memo.clear();
+  }
+  memo[key] = {lhs->typeId, rhs->typeId, result};
+  return result;
+}
+std::shared_ptr<AutumnListType>
+AutumnListType::getInstance(std::shared_ptr<AutumnType> elementType) {
+  // A live list type holds its element type, so while an entry can be locked
+  // its key still names that element type
+  thread_local std::unordered_map<const AutumnType *,
+                                  std::weak_ptr<AutumnListType>>
+      seen;
+  auto &slot = seen[elementType.get()];
+  if (auto instance = slot.lock()) {
+    return instance;
+  }
+  static std::mutex internLock;
+  std::lock_guard<std::mutex> guard(internLock);
+  auto instance = elementType->listOf.lock();
+  if (instance == nullptr) {
+    instance = std::make_shared<AutumnListType>(elementType);
+    elementType->listOf = instance;
+  }
+  slot = instance;
+  if (seen.size() > 4096) {
+    seen.clear();
+  }
+  return instance;
+}
+
+std::shared_ptr<AutumnSetType> AutumnSetType::getInstance() {
+  static std::shared_ptr<AutumnSetType> instance =
+      getInstance(AutumnUnknownType::getInstance());
+  return instance;
+}
+
+std::shared_ptr<AutumnSetType>
+AutumnSetType::getInstance(std::shared_ptr<AutumnType> elementType) {
+  static std::mutex internLock;
+  static std::unordered_map<int, std::weak_ptr<AutumnSetType>> interned;
+  std::lock_guard<std::mutex> guard(internLock);
+  auto &slot = interned[elementType->getTypeId()];
+  auto instance = slot.lock();
+  if (instance == nullptr) {
+    instance = std::make_shared<AutumnSetType>(elementType);
+    slot = instance;
+  }
+  return instance;
+}
+
+std::shared_ptr<AutumnMapType> AutumnMapType::getInstance() {
+  static std::shared_ptr<AutumnMapType> instance = getInstance(
+      AutumnUnknownType::getInstance(), AutumnUnknownType::getInstance());
+  return instance;
+}
+
+std::shared_ptr<AutumnMapType>
+AutumnMapType::getInstance(std::shared_ptr<AutumnType> keyType,
+                           std::shared_ptr<AutumnType> valueType) {
+  static std::mutex internLock;
+  static std::unordered_map<uint64_t, std::weak_ptr<AutumnMapType>> interned;
+  uint64_t key = (static_cast<uint64_t>(keyType->getTypeId()) << 32) |
+                 static_cast<uint32_t>(valueType->getTypeId());
+  std::lock_guard<std::mutex> guard(internLock);
+  auto &slot = interned[key];
+  auto instance = slot.lock();
+  if (instance == nullptr) {
+    instance = std::make_shared<AutumnMapType>(keyType, valueType);
+    slot = instance;
+  }
+  return instance;
+}
 } // namespace Autumn
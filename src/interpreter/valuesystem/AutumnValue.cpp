@@ -1,10 +1,52 @@
 #include "AutumnValue.hpp"
 #include "AutumnInstance.hpp"
+#include "AutumnStdComponents.hpp"
+#include <cstdint>
+#include <functional>
 
 namespace Autumn {
-int AutumnValue::instCount = 0;
+std::atomic<int> AutumnValue::instCount{0};
+
+// Covers [-GRID_SIZE, 2 * GRID_SIZE] for any grid a program is likely to use.
+// The shared values are created outside any interpreter's pool since every
+// interpreter in the process uses them.
+static constexpr int kSmallNumberMin = -256;
+static constexpr int kSmallNumberMax = 512;
+
+std::shared_ptr<AutumnNumber> AutumnNumber::of(int value) {
+  static const std::vector<std::shared_ptr<AutumnNumber>> smallNumbers = [] {
+    std::vector<std::shared_ptr<AutumnNumber>> numbers;
+    numbers.reserve(kSmallNumberMax - kSmallNumberMin + 1);
+    for (int i = kSmallNumberMin; i <= kSmallNumberMax; i++) {
+      numbers.push_back(std::make_shared<AutumnNumber>(i));
+      numbers.back()->markInterned(&smallNumbers);
+    }
+    return numbers;
+  }();
+  if (value < kSmallNumberMin || value > kSmallNumberMax) {
+    return makeValue<AutumnNumber>(value);
+  }
+  return smallNumbers[value - kSmallNumberMin];
+}
+
+std::shared_ptr<AutumnBool> AutumnBool::of(bool value) {
+  static const std::shared_ptr<AutumnBool> trueValue = [] {
+    auto result = std::make_shared<AutumnBool>(true);
+    result->markInterned(&trueValue);
+    return result;
+  }();
+  static const std::shared_ptr<AutumnBool> falseValue = [] {
+    auto result = std::make_shared<AutumnBool>(false);
+    result->markInterned(&falseValue);
+    return result;
+  }();
+  return value ? trueValue : falseValue;
+}
 
 bool AutumnNumber::isEqual(std::shared_ptr<AutumnValue> other) {
+  if (other.get() == this) {
+    return true;
+  }
   if (other == nullptr) {
     return false;
   }
@@ -61,31 +103,45 @@ bool AutumnNull::isEqual(std::shared_ptr<AutumnValue> other) {
   return true;
 }
 
+void AutumnList::checkElementType(const std::shared_ptr<AutumnValue> &elem) {
+  if (elem == nullptr) {
+    throw Error("AutumnList::add Error: Element is null");
+  }
+  auto elemType = std::static_pointer_cast<AutumnListType>(getListType())
+                      ->getElementType();
+  if (!AutumnType::sameType(elem->getType().get(), elemType.get()) &&
+      elemType != AutumnUnknownType::getInstance() &&
+      std::dynamic_pointer_cast<AutumnInstance>(elem) == nullptr) {
+    throw Error("List element type mismatch: got " +
+                elem->getType()->toString() + " expected " +
+                elemType->toString());
+  }
+}
+
+static void settleValueTypes(const std::shared_ptr<AutumnValue> &value) {
+  if (auto list = std::dynamic_pointer_cast<AutumnList>(value)) {
+    list->settleTypes();
+  } else if (auto instance = std::dynamic_pointer_cast<AutumnInstance>(value)) {
+    for (const auto &name : instance->getClass()->getFieldNames()) {
+      settleValueTypes(instance->get(name));
+    }
+  }
+}
+
+void AutumnList::settleTypes() {
+  getListType();
+  for (const auto &elem : *getValues()) {
+    settleValueTypes(elem);
+  }
+}
+
 void AutumnList::add(std::shared_ptr<AutumnValue> elem) {
   try {
-    auto plist = std::any_cast<
-        std::shared_ptr<std::vector<std::shared_ptr<AutumnValue>>>>(value);
+    auto plist = std::any_cast<std::shared_ptr<ValueList>>(value);
     if (plist == nullptr) {
       throw Error("AutumnList::add Error: List is null");
     }
-    if (elem == nullptr) {
-      throw Error("AutumnList::add Error: Element is null");
-    }
-    auto instElem = std::dynamic_pointer_cast<AutumnInstance>(elem);
-    if (elem->getType()->toString() !=
-            std::dynamic_pointer_cast<AutumnListType>(type)
-                ->getElementType()
-                ->toString() &&
-        std::dynamic_pointer_cast<AutumnUnknownType>(
-            std::dynamic_pointer_cast<AutumnListType>(type)
-                ->getElementType()) == nullptr &&
-        instElem == nullptr) {
-      throw Error("List element type mismatch: got " +
-                  elem->getType()->toString() + " expected " +
-                  std::dynamic_pointer_cast<AutumnListType>(type)
-                      ->getElementType()
-                      ->toString());
-    }
+    checkElementType(elem);
     this->type = AutumnListType::getInstance(elem->getType());
     plist->push_back(elem);
   } catch (std::bad_any_cast &e) {
@@ -93,4 +149,166 @@ void AutumnList::add(std::shared_ptr<AutumnValue> elem) {
   }
 }
 
+void AutumnList::set(size_t index, std::shared_ptr<AutumnValue> elem) {
+  try {
+    auto plist = std::any_cast<std::shared_ptr<ValueList>>(value);
+    if (plist == nullptr) {
+      throw Error("AutumnList::set Error: List is null");
+    }
+    checkElementType(elem);
+    plist->set(index, elem);
+  } catch (std::bad_any_cast &e) {
+    throw Error("AutumnList::set Error: " + std::string(e.what()));
+  }
+}
+
+// Coordinates of a key that is a position
+static bool positionKey(AutumnValue *value, int &x, int &y) {
+  auto instance = dynamic_cast<AutumnInstance *>(value);
+  if (instance == nullptr || instance->getClass() != PositionClass) {
+    return false;
+  }
+  auto px = dynamic_cast<AutumnNumber *>(instance->get("x").get());
+  auto py = dynamic_cast<AutumnNumber *>(instance->get("y").get());
+  if (px == nullptr || py == nullptr) {
+    return false;
+  }
+  x = px->getNumber();
+  y = py->getNumber();
+  return true;
+}
+
+// SplitMix64 finalizer
+static uint64_t mixKey(uint64_t z) {
+  z += 0x9e3779b97f4a7c15ULL;
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+bool isValueKey(const std::shared_ptr<AutumnValue> &value) {
+  int x, y;
+  return dynamic_cast<AutumnNumber *>(value.get()) != nullptr ||
+         dynamic_cast<AutumnString *>(value.get()) != nullptr ||
+         positionKey(value.get(), x, y);
+}
+
+size_t ValueKeyHash::operator()(const std::shared_ptr<AutumnValue> &key) const {
+  // Kinds are salted apart so 3, "3" and a position rarely collide
+  int x, y;
+  if (auto number = dynamic_cast<AutumnNumber *>(key.get())) {
+    return mixKey(static_cast<uint32_t>(number->getNumber()));
+  }
+  if (auto string = dynamic_cast<AutumnString *>(key.get())) {
+    return mixKey(std::hash<std::string>()(string->getString()) ^ 1);
+  }
+  if (positionKey(key.get(), x, y)) {
+    return mixKey(((static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) |
+                   static_cast<uint32_t>(y)) ^
+                  2);
+  }
+  throw Error("Set elements and map keys must be numbers, strings or "
+              "positions, instead got " +
+              key->toString());
+}
+
+bool ValueKeyEqual::operator()(const std::shared_ptr<AutumnValue> &lhs,
+                               const std::shared_ptr<AutumnValue> &rhs) const {
+  if (lhs == rhs) {
+    return true;
+  }
+  if (auto number = dynamic_cast<AutumnNumber *>(lhs.get())) {
+    auto other = dynamic_cast<AutumnNumber *>(rhs.get());
+    return other != nullptr && number->getNumber() == other->getNumber();
+  }
+  if (auto string = dynamic_cast<AutumnString *>(lhs.get())) {
+    auto other = dynamic_cast<AutumnString *>(rhs.get());
+    return other != nullptr && string->getString() == other->getString();
+  }
+  int x1, y1, x2, y2;
+  return positionKey(lhs.get(), x1, y1) && positionKey(rhs.get(), x2, y2) &&
+         x1 == x2 && y1 == y2;
+}
+
+std::string AutumnSet::toString() const {
+  std::string result = "({";
+  bool first = true;
+  getValues()->forEach(
+      [&](const std::shared_ptr<AutumnValue> &element, std::nullptr_t) {
+        result += first ? "" : ", ";
+        result += element->toString();
+        first = false;
+      });
+  return result + "} :" + type->toString() + ")";
+}
+
+bool AutumnSet::isEqual(std::shared_ptr<AutumnValue> other) {
+  auto otherSet = std::dynamic_pointer_cast<AutumnSet>(other);
+  if (otherSet == nullptr) {
+    return false;
+  }
+  auto values = getValues();
+  auto otherValues = otherSet->getValues();
+  if (values->size() != otherValues->size()) {
+    return false;
+  }
+  bool equal = true;
+  values->forEach(
+      [&](const std::shared_ptr<AutumnValue> &element, std::nullptr_t) {
+        equal = equal && otherValues->contains(element);
+      });
+  return equal;
+}
+
+ValueList AutumnSet::toList() const {
+  ValueList elements;
+  getValues()->forEach(
+      [&](const std::shared_ptr<AutumnValue> &element, std::nullptr_t) {
+        elements.push_back(element);
+      });
+  return elements;
+}
+
+std::string AutumnMap::toString() const {
+  std::string result = "({";
+  bool first = true;
+  getValues()->forEach([&](const std::shared_ptr<AutumnValue> &key,
+                           const std::shared_ptr<AutumnValue> &value) {
+    result += first ? "" : ", ";
+    result += key->toString() + " -> " + value->toString();
+    first = false;
+  });
+  return result + "} :" + type->toString() + ")";
+}
+
+bool AutumnMap::isEqual(std::shared_ptr<AutumnValue> other) {
+  auto otherMap = std::dynamic_pointer_cast<AutumnMap>(other);
+  if (otherMap == nullptr) {
+    return false;
+  }
+  auto values = getValues();
+  auto otherValues = otherMap->getValues();
+  if (values->size() != otherValues->size()) {
+    return false;
+  }
+  bool equal = true;
+  values->forEach([&](const std::shared_ptr<AutumnValue> &key,
+                      const std::shared_ptr<AutumnValue> &value) {
+    if (equal) {
+      auto otherValue = otherValues->find(key);
+      equal = otherValue != nullptr && value->isEqual(*otherValue);
+    }
+  });
+  return equal;
+}
+
+ValueList AutumnMap::keys() const {
+  ValueList keys;
+  getValues()->forEach([&](const std::shared_ptr<AutumnValue> &key,
+                           const std::shared_ptr<AutumnValue> &) {
+    keys.push_back(key);
+  });
+  return keys;
+}
+
 } // namespace Autumn
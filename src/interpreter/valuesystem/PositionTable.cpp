@@ -0,0 +1,76 @@
+#include "PositionTable.hpp"
+#include "AutumnInstance.hpp"
+#include "AutumnStdComponents.hpp"
+
+namespace Autumn {
+
+static std::shared_ptr<AutumnInstance> newPosition(int x, int y) {
+  // Field types are known, so the instance skips the field checks
+  return makeValue<AutumnInstance>(
+      PositionClass,
+      std::vector<std::shared_ptr<AutumnValue>>(
+          {AutumnNumber::of(x), AutumnNumber::of(y)}),
+      2);
+}
+
+std::shared_ptr<AutumnInstance> PositionTable::get(int x, int y) {
+  // Objects that drift off the grid would otherwise grow the table
+  // without bound
+  if (x < 0 || x >= kExtent || y < 0 || y >= kExtent) {
+    return newPosition(x, y);
+  }
+  std::lock_guard<std::mutex> lock(mutex);
+  auto &slot = positions[key(x, y)];
+  if (slot == nullptr) {
+    slot = newPosition(x, y);
+    slot->markInterned(this);
+  }
+  return slot;
+}
+
+ValueList PositionTable::grid(int width, int height) {
+  std::lock_guard<std::mutex> lock(tablesMutex);
+  if (width != gridWidth || height != gridHeight) {
+    gridPositions = ValueList();
+    for (int x = 0; x < width; x++) {
+      for (int y = 0; y < height; y++) {
+        gridPositions.push_back(get(x, y));
+      }
+    }
+    gridWidth = width;
+    gridHeight = height;
+  }
+  return gridPositions;
+}
+
+ValueList PositionTable::neighbors(int x, int y, int size) {
+  auto adjacent = [&] {
+    const std::pair<int, int> offsets[] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+    ValueList positions;
+    for (const auto &[dx, dy] : offsets) {
+      int nx = x + dx;
+      int ny = y + dy;
+      if (nx >= 0 && nx < size && ny >= 0 && ny < size) {
+        positions.push_back(get(nx, ny));
+      }
+    }
+    return positions;
+  };
+  if (x < 0 || x >= size || y < 0 || y >= size) {
+    return adjacent();
+  }
+  std::lock_guard<std::mutex> lock(tablesMutex);
+  if (size != neighborsSize) {
+    neighborLists.assign(static_cast<size_t>(size) * size, ValueList());
+    neighborsBuilt.assign(neighborLists.size(), false);
+    neighborsSize = size;
+  }
+  size_t cell = static_cast<size_t>(x) * size + y;
+  if (!neighborsBuilt[cell]) {
+    neighborLists[cell] = adjacent();
+    neighborsBuilt[cell] = true;
+  }
+  return neighborLists[cell];
+}
+
+} // namespace Autumn
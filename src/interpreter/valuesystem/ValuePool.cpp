@@ -0,0 +1,108 @@
+#include "ValuePool.hpp"
+#include <new>
+
+namespace Autumn {
+
+static thread_local std::shared_ptr<ValuePool> currentPool;
+
+ValuePool::Scope::Scope(const std::shared_ptr<ValuePool> &pool)
+    : previous(currentPool) {
+  currentPool = pool;
+  if (pool != nullptr) {
+    pool->owner.store(std::this_thread::get_id());
+  }
+}
+
+ValuePool::Scope::~Scope() {
+  // A thread may reuse the id of one that ended, so a pool no thread has
+  // active takes every release through the queue
+  if (currentPool != nullptr) {
+    currentPool->owner.store(std::thread::id());
+  }
+  currentPool = previous;
+  if (previous != nullptr) {
+    previous->owner.store(std::this_thread::get_id());
+  }
+}
+
+const std::shared_ptr<ValuePool> &ValuePool::current() { return currentPool; }
+
+ValuePool::~ValuePool() {
+  for (void *chunk : chunks) {
+    ::operator delete(chunk);
+  }
+}
+
+void *ValuePool::allocate(size_t bytes) {
+  size_t cls = classOf(bytes);
+  if (cls >= kClasses) {
+    return ::operator new(bytes);
+  }
+  stepStats.allocations++;
+  totalStats.allocations++;
+  stepStats.live++;
+  totalStats.live++;
+  if (freeLists[cls] != nullptr) {
+    FreeSlot *slot = freeLists[cls];
+    freeLists[cls] = slot->next;
+    stepStats.recycled++;
+    totalStats.recycled++;
+    return slot;
+  }
+  size_t slotBytes = (cls + 1) * kGranule;
+  if (bump == nullptr || static_cast<size_t>(bumpEnd - bump) < slotBytes) {
+    bump = static_cast<char *>(::operator new(kChunkBytes));
+    bumpEnd = bump + kChunkBytes;
+    chunks.push_back(bump);
+    stepStats.chunkBytes += kChunkBytes;
+    totalStats.chunkBytes += kChunkBytes;
+  }
+  void *slot = bump;
+  bump += slotBytes;
+  return slot;
+}
+
+void ValuePool::deallocate(void *ptr, size_t bytes) {
+  size_t cls = classOf(bytes);
+  if (cls >= kClasses) {
+    ::operator delete(ptr);
+    return;
+  }
+  FreeSlot *slot = static_cast<FreeSlot *>(ptr);
+  if (owner.load() != std::this_thread::get_id()) {
+    std::lock_guard<std::mutex> lock(remoteMutex);
+    slot->next = remoteFrees[cls];
+    remoteFrees[cls] = slot;
+    remoteCount++;
+    return;
+  }
+  slot->next = freeLists[cls];
+  freeLists[cls] = slot;
+  stepStats.releases++;
+  totalStats.releases++;
+  stepStats.live--;
+  totalStats.live--;
+}
+
+void ValuePool::beginStep() {
+  size_t reclaimed = 0;
+  {
+    std::lock_guard<std::mutex> lock(remoteMutex);
+    for (size_t cls = 0; cls < kClasses; cls++) {
+      while (remoteFrees[cls] != nullptr) {
+        FreeSlot *slot = remoteFrees[cls];
+        remoteFrees[cls] = slot->next;
+        slot->next = freeLists[cls];
+        freeLists[cls] = slot;
+      }
+    }
+    reclaimed = remoteCount;
+    remoteCount = 0;
+  }
+  totalStats.releases += reclaimed;
+  totalStats.live -= reclaimed;
+  stepStats = Stats();
+  stepStats.live = totalStats.live;
+}
+
+} // namespace Autumn
@@ -0,0 +1,140 @@
+#include <cassert>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "AstOptimizer.hpp"
+#include "AstPrinter.hpp"
+#include "Interpreter.hpp"
+#include "Parser.hpp"
+
+// Constants, aliases, dead branches and calls to small lambdas are rewritten
+// before the program runs; the program must behave as it did unrewritten.
+static const std::string program = R"((program
+  (= GRID_SIZE 16)
+  (= vcat concat)
+  (= twice (--> x (* x 2)))
+  (= countdown (--> x (if (> x 0) then (countdown (- x 1)) else 0)))
+  (= speed 1)
+  (= half (/ GRID_SIZE 2))
+  (: k Number)
+  (= k (if (> GRID_SIZE 4) then 1 else (twice 3)))
+  (: m Number)
+  (= m (initnext (twice 5) (+ (twice speed) (prev m))))
+  (: n Number)
+  (= n (initnext (+ half (* 2 3))
+                 (if (> half 4) then (+ (prev n) 1) else 0)))
+  (: ys (List Number))
+  (= ys (initnext (vcat (list (list 1) (list 2))) (vcat (list (prev ys) (list n)))))
+  (: z Number)
+  (= z (countdown 3))
+  (on (> n 16) (= speed 2))
+))";
+
+// What the rewritten statements must be, by the name they assign. The
+// on-clause rebinds speed, so it is read, not folded; the recursive
+// countdown is inlined once, then stops at its own call.
+static const std::string rewritten = R"((program
+  (= half 8)
+  (= k 1)
+  (= m (initnext 10 (+ (* speed 2) (prev m))))
+  (= ys (initnext (concat (list (list 1) (list 2))) (concat (list (prev ys) (list n)))))
+  (= z (countdown 2))
+))";
+
+static const int kSteps = 4;
+
+// Helper for testing and printing results:
+static void testEqual(const std::string &testName, const std::string &actual,
+                      const std::string &expected) {
+  if (actual != expected) {
+    std::cerr << "Test Failed: " << testName << "\n  Expected: " << expected
+              << "\n  Actual:   " << actual << std::endl;
+    assert(false);
+  } else {
+    std::cout << "Test Passed: " << testName << std::endl;
+  }
+}
+
+static void testTrue(const std::string &testName, bool condition) {
+  if (!condition) {
+    std::cerr << "Test Failed: " << testName << std::endl;
+    assert(false);
+  } else {
+    std::cout << "Test Passed: " << testName << std::endl;
+  }
+}
+
+// The printed assignments of stmts, by the name they assign
+static std::unordered_map<std::string, std::string>
+printAssignments(const std::vector<std::shared_ptr<Autumn::Stmt>> &stmts) {
+  std::unordered_map<std::string, std::string> printed;
+  for (const auto &stmt : stmts) {
+    auto exprStmt = std::dynamic_pointer_cast<Autumn::Expression>(stmt);
+    if (exprStmt == nullptr) {
+      continue;
+    }
+    auto assign = std::dynamic_pointer_cast<Autumn::Assign>(exprStmt->expression);
+    if (assign != nullptr) {
+      printed[assign->name.lexeme] = Autumn::AstPrinter().print(assign);
+    }
+  }
+  return printed;
+}
+
+static void testRewrites() {
+  std::string source = program;
+  Autumn::SExpParser parser(source);
+  std::vector<std::shared_ptr<Autumn::Stmt>> stmts = parser.parseStmt();
+  std::vector<std::shared_ptr<Autumn::Stmt>> stdlib;
+  Autumn::AstOptimizer optimizer;
+  optimizer.optimize(stdlib, stmts);
+
+  std::unordered_map<std::string, std::string> actual = printAssignments(stmts);
+  std::string expectedSource = rewritten;
+  Autumn::SExpParser expectedParser(expectedSource);
+  for (const auto &[name, expected] :
+       printAssignments(expectedParser.parseStmt())) {
+    testEqual("rewritten " + name, actual[name], expected);
+  }
+
+  const Autumn::AstOptimizer::Stats &stats = optimizer.getStats();
+  testTrue("folded", stats.folded > 0);
+  testTrue("aliases", stats.aliases > 0);
+  testTrue("branches", stats.branches > 0);
+  testTrue("inlined", stats.inlined > 0);
+}
+
+// Every global after each step of a run
+static std::vector<std::string> run(bool optimizeAst) {
+  std::string source = program;
+  Autumn::SExpParser parser(source);
+  Autumn::Interpreter interpreter;
+  interpreter.setOptimizeAst(optimizeAst);
+  interpreter.start(parser.parseStmt());
+  std::vector<std::string> results;
+  for (int i = 0; i < kSteps; i++) {
+    interpreter.step();
+    for (const std::string name : {"half", "k", "m", "n", "ys", "z", "speed"}) {
+      results.push_back(interpreter.evaluateToString(name));
+    }
+  }
+  return results;
+}
+
+int main() {
+  testRewrites();
+
+  std::vector<std::string> plain = run(false);
+  std::vector<std::string> optimized = run(true);
+  for (size_t i = 0; i < plain.size(); i++) {
+    testEqual("step " + std::to_string(i / 7 + 1) + " global " +
+                  std::to_string(i % 7),
+              optimized[i], plain[i]);
+  }
+
+  std::cout << "All AST optimizer tests passed!" << std::endl;
+  return 0;
+}
@@ -0,0 +1,79 @@
+#include <cassert>
+#include <iostream>
+#include <string>
+
+#include "Interpreter.hpp"
+#include "Parser.hpp"
+
+// allObjs and allObjsOf list the renderable instances the globals hold, and
+// must follow every change of a binding, removeObj included.
+static const std::string program = R"((program
+  (= GRID_SIZE 4)
+  (object Thing (Cell 0 0 "red"))
+  (object Other (Cell 0 0 "blue"))
+  (: a Thing)
+  (= a (initnext (Thing (Position 0 0)) (prev a)))
+  (: b Thing)
+  (= b (initnext (Thing (Position 1 1)) (prev b)))
+  (: others (List Other))
+  (= others (initnext (list (Other (Position 2 2)) (Other (Position 3 3)))
+                      (prev others)))
+  (: before Number)
+  (= before (initnext 0 (prev before)))
+  (: after Number)
+  (= after (initnext 0 (prev after)))
+  (on (== after 0)
+    (let (= before (length ((allObjs))))
+         (length ((allObjs)))
+         (removeObj a)
+         (= after (length ((allObjs))))
+         true))
+))";
+
+// Helper for testing and printing results:
+static void testEqual(const std::string &testName, const std::string &actual,
+                      const std::string &expected) {
+  if (actual != expected) {
+    std::cerr << "Test Failed: " << testName << "\n  Expected: " << expected
+              << "\n  Actual:   " << actual << std::endl;
+    assert(false);
+  } else {
+    std::cout << "Test Passed: " << testName << std::endl;
+  }
+}
+
+// Evaluates one expression, written without its outer parentheses
+static std::string evaluate(Autumn::Interpreter &interpreter,
+                            const std::string &expr) {
+  return interpreter.evaluateToString(expr);
+}
+
+int main() {
+  std::string source = program;
+  Autumn::SExpParser parser(source);
+  Autumn::Interpreter interpreter;
+  interpreter.start(parser.parseStmt());
+
+  testEqual("allObjs", evaluate(interpreter, "length ((allObjs))"),
+            evaluate(interpreter, "+ 2 2"));
+  testEqual("allObjsOf", evaluate(interpreter, "length (allObjsOf \"Other\")"),
+            evaluate(interpreter, "+ 1 1"));
+  testEqual("allObjsOf unknown class",
+            evaluate(interpreter, "length (allObjsOf \"Missing\")"),
+            evaluate(interpreter, "+ 0 0"));
+
+  // Rebinding a variable replaces its instances
+  evaluate(interpreter, "= others (list (Other (Position 0 1)))");
+  testEqual("allObjs after rebinding", evaluate(interpreter, "length ((allObjs))"),
+            evaluate(interpreter, "+ 1 2"));
+
+  // removeObj of a single object drops its binding in the same clause
+  interpreter.step();
+  testEqual("allObjs before removeObj", evaluate(interpreter, "before"),
+            evaluate(interpreter, "+ 1 2"));
+  testEqual("allObjs after removeObj", evaluate(interpreter, "after"),
+            evaluate(interpreter, "+ 1 1"));
+
+  std::cout << "All instance registry tests passed!" << std::endl;
+  return 0;
+}
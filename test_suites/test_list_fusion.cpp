@@ -0,0 +1,125 @@
+#include <cassert>
+#include <iostream>
+#include <string>
+
+#include "Interpreter.hpp"
+#include "Parser.hpp"
+
+// Chains of map, filter and concat over a range or a list run in one pass,
+// and must give the results and errors of the calls one by one.
+static const std::string program = R"((program
+  (= GRID_SIZE 4)
+  (: xs (List Number))
+  (= xs (list 1 2 3 4 5))
+  (: xss (List (List Number)))
+  (= xss (list (list 1 2) (list) (list 3)))
+  (= unfused (--> (f ys) (f ys)))
+))";
+
+// Helper for testing and printing results:
+static void testEqual(const std::string &testName, const std::string &actual,
+                      const std::string &expected) {
+  if (actual != expected) {
+    std::cerr << "Test Failed: " << testName << "\n  Expected: " << expected
+              << "\n  Actual:   " << actual << std::endl;
+    assert(false);
+  } else {
+    std::cout << "Test Passed: " << testName << std::endl;
+  }
+}
+
+static void testContains(const std::string &testName,
+                         const std::string &actual,
+                         const std::string &expected) {
+  if (actual.find(expected) == std::string::npos) {
+    std::cerr << "Test Failed: " << testName << "\n  Expected to contain: "
+              << expected << "\n  Actual: " << actual << std::endl;
+    assert(false);
+  } else {
+    std::cout << "Test Passed: " << testName << std::endl;
+  }
+}
+
+// Evaluates one expression, written without its outer parentheses
+static std::string evaluate(Autumn::Interpreter &interpreter,
+                            const std::string &expr) {
+  return interpreter.evaluateToString(expr);
+}
+
+// The error evaluating expr raises, or an empty string when there is none
+static std::string evaluateError(Autumn::Interpreter &interpreter,
+                                 const std::string &expr) {
+  try {
+    interpreter.evaluateToString(expr);
+  } catch (const std::exception &e) {
+    return e.what();
+  }
+  return "";
+}
+
+// Passing the inner chain through a lambda keeps the two parts from fusing
+static void testSameAsUnfused(Autumn::Interpreter &interpreter,
+                              const std::string &testName,
+                              const std::string &outer,
+                              const std::string &inner) {
+  testEqual(testName,
+            evaluate(interpreter, outer + " (" + inner + ")"),
+            evaluate(interpreter, "unfused (--> ys (" + outer + " ys)) (" +
+                                      inner + ")"));
+}
+
+int main() {
+  std::string source = program;
+  Autumn::SExpParser parser(source);
+  Autumn::Interpreter interpreter;
+  interpreter.start(parser.parseStmt());
+
+  // Results
+  testEqual("length of map over range",
+            evaluate(interpreter, "length (map (--> x (+ x 1)) (range 0 5))"),
+            evaluate(interpreter, "length xs"));
+  testEqual("foldl of filter over range",
+            evaluate(interpreter, "foldl (--> (acc x) (+ acc x)) 0 "
+                                  "(filter (--> x (> x 2)) (range 0 6))"),
+            evaluate(interpreter, "+ 5 7"));
+  testEqual("map of concat",
+            evaluate(interpreter, "map (--> x (* x 2)) (concat xss)"),
+            evaluate(interpreter, "list 2 4 6"));
+  testSameAsUnfused(interpreter, "map of map", "map (--> x (* x 2))",
+                    "map (--> x (+ x 1)) xs");
+  testSameAsUnfused(interpreter, "filter of map", "filter (--> x (> x 3))",
+                    "map (--> x (+ x 1)) xs");
+  testSameAsUnfused(interpreter, "length of filter", "length",
+                    "filter (--> x (> x 3)) xs");
+  testSameAsUnfused(interpreter, "concat of map", "concat",
+                    "map (--> x (list x x)) (range 0 3)");
+  testSameAsUnfused(interpreter, "foldl of concat",
+                    "foldl (--> (acc x) (+ acc x)) 0", "concat xss");
+
+  // Errors
+  testContains("head of failing map",
+               evaluateError(interpreter,
+                             "head (map (--> a (head a)) (list (list 1) "
+                             "(list)))"),
+               "Head() argument must not be an empty list");
+  testContains("any of failing map",
+               evaluateError(interpreter,
+                             "any (--> x (== x 1)) (map (--> a (head a)) "
+                             "(list (list 1) (list)))"),
+               "Head() argument must not be an empty list");
+  // The outer map fails on the first element, but the inner one fails on
+  // the second before the outer map starts
+  testContains("inner stage fails first",
+               evaluateError(interpreter,
+                             "map (--> x (head x)) (map (--> y (if (== y 1) "
+                             "then (list) else (head (list)))) xs)"),
+               "Error calling: (lambda (y )");
+  testContains("concat of a non-list",
+               evaluateError(interpreter,
+                             "foldl (--> (acc x) (+ acc x)) 0 "
+                             "(concat (list xs (list 1) 3))"),
+               "Concat() arguments must be a list of lists");
+
+  std::cout << "All list fusion tests passed!" << std::endl;
+  return 0;
+}
@@ -0,0 +1,132 @@
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Interpreter.hpp"
+#include "Parser.hpp"
+#include "TaskScheduler.hpp"
+
+// Large lists split across threads, and independent next expressions run
+// side by side; either must give what one thread gives, errors included.
+static const std::string program = R"((program
+  (= GRID_SIZE 16)
+  (= add (--> (a b) (+ a b)))
+  (= larger (--> (a b) (if (< a b) then b else a)))
+  (= double (--> x (* x 2)))
+  (= isThird (--> x (== (% x 3) 0)))
+  (= isLast (--> x (== x 2999)))
+  (: xs (List Number))
+  (= xs (range 0 3000))
+  (object Dot (Cell 0 0 "red"))
+  (: dots (List Dot))
+  (= dots (initnext (map (--> i (Dot (Position (% i 16) (/ i 16))))
+                         (range 0 256))
+                    (map (--> d (moveRight d)) (prev dots))))
+  (: ticks Number)
+  (= ticks (initnext 0 (+ (prev ticks) 1)))
+  (: total Number)
+  (= total (initnext 0 (foldl add 0 (map (--> x (* x (prev ticks))) xs))))
+  (: evens Number)
+  (= evens (initnext 0 (length (filter (--> x (== (% x 2) 0))
+                                       (map (--> x (+ x (prev ticks))) xs)))))
+  (: top Number)
+  (= top (initnext 0 (foldl larger 0 (map (--> x (% (* x (prev ticks)) 97))
+                                          xs))))
+))";
+
+// What each interpreter is asked after starting
+static const std::vector<std::string> expressions = {
+    "map double xs",
+    "filter isThird xs",
+    "any isLast xs",
+    "any isLast (map double xs)",
+    "foldl add 0 xs",
+    "foldl larger 0 xs",
+    "foldl add 0 (map double (filter isThird xs))",
+    // A string in the middle: the error must be the one the fold meets
+    // first, with the sum of the numbers before it
+    "foldl add 0 (concat (list (range 0 2000) (list \"x\") (range 0 10)))",
+    "map (--> x (if (== x 2000) then (head (list)) else x)) xs",
+};
+
+static const int kSteps = 5;
+
+// Helper for testing and printing results:
+static void testEqual(const std::string &testName, const std::string &actual,
+                      const std::string &expected) {
+  if (actual != expected) {
+    std::cerr << "Test Failed: " << testName << "\n  Expected: "
+              << expected.substr(0, 400)
+              << "\n  Actual:   " << actual.substr(0, 400) << std::endl;
+    assert(false);
+  } else {
+    std::cout << "Test Passed: " << testName << std::endl;
+  }
+}
+
+static void testContains(const std::string &testName,
+                         const std::string &actual,
+                         const std::string &expected) {
+  if (actual.find(expected) == std::string::npos) {
+    std::cerr << "Test Failed: " << testName << "\n  Expected to contain: "
+              << expected << "\n  Actual: " << actual << std::endl;
+    assert(false);
+  } else {
+    std::cout << "Test Passed: " << testName << std::endl;
+  }
+}
+
+// The value of expr, or its error message
+static std::string evaluate(Autumn::Interpreter &interpreter,
+                            const std::string &expr) {
+  try {
+    return interpreter.evaluateToString(expr);
+  } catch (const std::exception &e) {
+    return std::string("error: ") + e.what();
+  }
+}
+
+// Every answer and every frame of one run of the program
+static std::vector<std::string> run(size_t workers) {
+  Autumn::TaskScheduler::instance().setWorkerCount(workers);
+  std::string source = program;
+  Autumn::SExpParser parser(source);
+  Autumn::Interpreter interpreter;
+  interpreter.start(parser.parseStmt());
+  std::vector<std::string> results;
+  for (int i = 0; i < kSteps; i++) {
+    interpreter.step();
+    results.push_back(interpreter.renderAll());
+    for (const std::string name : {"total", "evens", "top"}) {
+      results.push_back(evaluate(interpreter, name));
+    }
+  }
+  // Last, since an error leaves the interpreter in the scope it failed in
+  for (const auto &expr : expressions) {
+    results.push_back(evaluate(interpreter, expr));
+  }
+  return results;
+}
+
+int main() {
+  std::vector<std::string> sequential = run(0);
+  std::vector<std::string> parallel = run(3);
+  Autumn::TaskScheduler::instance().setWorkerCount(0);
+
+  size_t stepResults = kSteps * 4;
+  for (size_t i = 0; i < stepResults; i++) {
+    testEqual("step " + std::to_string(i / 4 + 1) + " result " +
+                  std::to_string(i % 4),
+              parallel[i], sequential[i]);
+  }
+  for (size_t i = 0; i < expressions.size(); i++) {
+    testEqual(expressions[i], parallel[stepResults + i],
+              sequential[stepResults + i]);
+  }
+  testContains("fold error is the first one", parallel[stepResults + 7],
+               "(1999000: N) and (\"x\": S)");
+
+  std::cout << "All parallel builtin tests passed!" << std::endl;
+  return 0;
+}
@@ -0,0 +1,125 @@
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "PersistentHashMap.hpp"
+
+// Keys k and k + 7 hash the same, so they end up in the collision lists
+// below the last level of the trie
+struct CollidingHash {
+  size_t operator()(int key) const { return static_cast<size_t>(key % 7); }
+};
+
+// Keys 32 apart share their first slots and split further down
+struct SlotHash {
+  size_t operator()(int key) const {
+    return static_cast<size_t>(key % 32) | (static_cast<size_t>(key) << 5);
+  }
+};
+
+struct IntEqual {
+  bool operator()(int lhs, int rhs) const { return lhs == rhs; }
+};
+
+// Helper for testing and printing results:
+template <typename Map>
+static void testEqual(const std::string &testName, const Map &actual,
+                      const std::map<int, int> &expected) {
+  bool same = actual.size() == expected.size();
+  size_t visited = 0;
+  actual.forEach([&](int key, int value) {
+    auto it = expected.find(key);
+    same = same && it != expected.end() && it->second == value;
+    visited++;
+  });
+  same = same && visited == expected.size();
+  for (int key = -1; same && key <= 200; key++) {
+    const int *value = actual.find(key);
+    auto it = expected.find(key);
+    same = (value != nullptr) == (it != expected.end()) &&
+           (value == nullptr || *value == it->second);
+  }
+  if (!same) {
+    std::cerr << "Test Failed: " << testName
+              << "\n  Expected size: " << expected.size()
+              << "\n  Actual size:   " << actual.size() << std::endl;
+    assert(false);
+  }
+}
+
+static void testTrue(const std::string &testName, bool condition) {
+  if (!condition) {
+    std::cerr << "Test Failed: " << testName << std::endl;
+    assert(false);
+  }
+}
+
+// Inserts, overwrites and erases keys whose hashes collide, keeping each
+// version's copy intact
+template <typename Hash> void testCollisions(const std::string &name) {
+  using Map = Autumn::PersistentHashMap<int, int, Hash, IntEqual>;
+  std::vector<Map> versions(1);
+  std::vector<std::map<int, int>> expected(1);
+  auto record = [&](const Map &map, const std::map<int, int> &reference) {
+    versions.push_back(map);
+    expected.push_back(reference);
+  };
+
+  Map map;
+  std::map<int, int> reference;
+  for (int key = 0; key < 200; key++) {
+    testTrue(name + " insert is new", map.insert(key, key));
+    reference[key] = key;
+    record(map, reference);
+  }
+  testEqual(name + " insert", map, reference);
+
+  for (int key = 0; key < 200; key += 3) {
+    testTrue(name + " overwrite is not new", !map.insert(key, -key));
+    reference[key] = -key;
+  }
+  record(map, reference);
+  testEqual(name + " overwrite", map, reference);
+
+  // Erase in an order that empties collision lists and subtrees in turn
+  for (int step : {7, 32, 1}) {
+    for (int key = 0; key < 200; key += step) {
+      bool present = reference.erase(key) == 1;
+      testTrue(name + " erase finds key", map.erase(key) == present);
+      record(map, reference);
+    }
+  }
+  testTrue(name + " erase empties", map.empty());
+  testEqual(name + " erase", map, reference);
+
+  for (size_t i = 0; i < versions.size(); i++) {
+    testEqual(name + " version " + std::to_string(i), versions[i],
+              expected[i]);
+  }
+
+  // Reinsert into an old version that shares its nodes with the others
+  Map old = versions[100];
+  std::map<int, int> oldReference = expected[100];
+  for (int key = 0; key < 200; key += 2) {
+    old.erase(key);
+    oldReference.erase(key);
+  }
+  for (int key = 1; key < 200; key += 14) {
+    old.insert(key, 1000 + key);
+    oldReference[key] = 1000 + key;
+  }
+  testEqual(name + " old version", old, oldReference);
+  testEqual(name + " old version shared", versions[100], expected[100]);
+  std::cout << "Test Passed: " << name << std::endl;
+}
+
+int main() {
+  testCollisions<CollidingHash>("full hash collisions");
+  testCollisions<SlotHash>("slot collisions");
+
+  std::cout << "All PersistentHashMap tests passed!" << std::endl;
+  return 0;
+}
@@ -0,0 +1,166 @@
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "PersistentVector.hpp"
+
+using Vector = Autumn::PersistentVector<int>;
+
+// Sizes around the leaf (32) and two-level (1024) boundaries
+static const std::vector<size_t> sizes = {
+    0, 1, 31, 32, 33, 63, 64, 65, 1023, 1024, 1025, 1056, 2047, 2048, 2049};
+
+// Helper for testing and printing results:
+static void testEqual(const std::string &testName, const Vector &actual,
+                      const std::vector<int> &expected) {
+  bool same = actual.size() == expected.size() &&
+              actual.toVector() == expected;
+  for (size_t i = 0; same && i < expected.size(); i++) {
+    same = actual[i] == expected[i];
+  }
+  if (!same) {
+    std::cerr << "Test Failed: " << testName
+              << "\n  Expected size: " << expected.size()
+              << "\n  Actual size:   " << actual.size() << std::endl;
+    assert(false);
+  }
+}
+
+static std::vector<int> iota(size_t count, int first = 0) {
+  std::vector<int> values;
+  for (size_t i = 0; i < count; i++) {
+    values.push_back(first + static_cast<int>(i));
+  }
+  return values;
+}
+
+static Vector build(const std::vector<int> &values) {
+  Vector vector;
+  for (int value : values) {
+    vector.push_back(value);
+  }
+  return vector;
+}
+
+// Test push_back, keeping every earlier version intact
+void testPushBack() {
+  std::vector<Vector> versions;
+  Vector vector;
+  for (int i = 0; i <= 2049; i++) {
+    versions.push_back(vector);
+    vector.push_back(i);
+  }
+  testEqual("push_back 2050", vector, iota(2050));
+  for (size_t size : sizes) {
+    testEqual("push_back version " + std::to_string(size), versions[size],
+              iota(size));
+  }
+  std::cout << "Test Passed: push_back" << std::endl;
+}
+
+// Test set on either side of each boundary, on a copy
+void testSet() {
+  const std::vector<int> values = iota(2049);
+  const Vector original = build(values);
+  for (size_t index : sizes) {
+    if (index >= values.size()) {
+      continue;
+    }
+    Vector copy = original;
+    copy.set(index, -1);
+    std::vector<int> expected = values;
+    expected[index] = -1;
+    testEqual("set " + std::to_string(index), copy, expected);
+  }
+  testEqual("set leaves original", original, values);
+  std::cout << "Test Passed: set" << std::endl;
+}
+
+// Test erase at each boundary, and draining a list from the front
+void testErase() {
+  for (size_t size : sizes) {
+    const std::vector<int> values = iota(size);
+    const Vector original = build(values);
+    for (size_t index : sizes) {
+      if (index >= size) {
+        continue;
+      }
+      Vector copy = original;
+      copy.erase(index);
+      std::vector<int> expected = values;
+      expected.erase(expected.begin() + index);
+      testEqual("erase " + std::to_string(index) + " of " +
+                    std::to_string(size),
+                copy, expected);
+    }
+    testEqual("erase leaves original", original, values);
+  }
+  std::vector<int> expected = iota(1057);
+  Vector vector = build(expected);
+  while (!expected.empty()) {
+    vector.erase(0);
+    expected.erase(expected.begin());
+    testEqual("erase front", vector, expected);
+  }
+  std::cout << "Test Passed: erase" << std::endl;
+}
+
+// Test append for every pair of sizes, then push and erase on the result
+void testAppend() {
+  for (size_t left : sizes) {
+    for (size_t right : sizes) {
+      std::vector<int> leftValues = iota(left);
+      std::vector<int> rightValues = iota(right, 100000);
+      Vector vector = build(leftValues);
+      const Vector other = build(rightValues);
+      vector.append(other);
+      std::vector<int> expected = leftValues;
+      expected.insert(expected.end(), rightValues.begin(), rightValues.end());
+      std::string name =
+          "append " + std::to_string(left) + " + " + std::to_string(right);
+      testEqual(name, vector, expected);
+      testEqual(name + " leaves other", other, rightValues);
+
+      vector.push_back(-1);
+      expected.push_back(-1);
+      testEqual(name + " then push_back", vector, expected);
+      size_t middle = expected.size() / 2;
+      vector.erase(middle);
+      expected.erase(expected.begin() + middle);
+      testEqual(name + " then erase", vector, expected);
+    }
+  }
+  std::cout << "Test Passed: append" << std::endl;
+}
+
+// Test concat as the builtin does it: one append per inner list
+void testConcat() {
+  Vector vector;
+  std::vector<int> expected;
+  int next = 0;
+  for (int round = 0; round < 3; round++) {
+    for (size_t size : sizes) {
+      std::vector<int> values = iota(size, next);
+      next += static_cast<int>(size);
+      vector.append(build(values));
+      expected.insert(expected.end(), values.begin(), values.end());
+    }
+    vector.append(vector);
+    std::vector<int> twice = expected;
+    expected.insert(expected.end(), twice.begin(), twice.end());
+    testEqual("concat round " + std::to_string(round), vector, expected);
+  }
+  std::cout << "Test Passed: concat" << std::endl;
+}
+
+int main() {
+  testPushBack();
+  testSet();
+  testErase();
+  testAppend();
+  testConcat();
+
+  std::cout << "All PersistentVector tests passed!" << std::endl;
+  return 0;
+}
@@ -0,0 +1,149 @@
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Interpreter.hpp"
+#include "Parser.hpp"
+#include "TaskScheduler.hpp"
+
+// Random draws are keyed by seed, step, call site and call count, so one
+// seed gives the same draws on every run, with or without worker threads.
+// The sampling builtins draw positions from the grid without repeats.
+static const std::string program = R"((program
+  (= GRID_SIZE 16)
+  (= add (--> (a b) (+ a b)))
+  (= double (--> x (* x 2)))
+  (: xs (List Number))
+  (= xs (range 0 3000))
+  (: picks (List Number))
+  (= picks (initnext (list)
+                     (map (--> i (uniformChoice (list 1 2 3 4 5 6)))
+                          (range 0 20))))
+  (: where Position)
+  (= where (initnext (Position 0 0)
+                     (uniformChoice (allPositions GRID_SIZE))))
+  (: total Number)
+  (= total (initnext 0 (foldl add 0 (map double xs))))
+  (: doubled (List Number))
+  (= doubled (initnext (list) (map double xs)))
+  (object Block (Cell 0 0 "gray"))
+  (: blocks (List Block))
+  (= blocks (list (Block (Position 0 0)) (Block (Position 1 0))
+                  (Block (Position 2 0))))
+))";
+
+static const int kSteps = 5;
+
+// Helper for testing and printing results:
+static void testEqual(const std::string &testName,
+                      const std::vector<std::string> &actual,
+                      const std::vector<std::string> &expected) {
+  if (actual != expected) {
+    std::cerr << "Test Failed: " << testName << std::endl;
+    assert(false);
+  } else {
+    std::cout << "Test Passed: " << testName << std::endl;
+  }
+}
+
+static void testDiffer(const std::string &testName,
+                       const std::vector<std::string> &actual,
+                       const std::vector<std::string> &other) {
+  if (actual == other) {
+    std::cerr << "Test Failed: " << testName << std::endl;
+    assert(false);
+  } else {
+    std::cout << "Test Passed: " << testName << std::endl;
+  }
+}
+
+static void testEqual(const std::string &testName, const std::string &actual,
+                      const std::string &expected) {
+  if (actual != expected) {
+    std::cerr << "Test Failed: " << testName << "\n  Expected: " << expected
+              << "\n  Actual:   " << actual << std::endl;
+    assert(false);
+  } else {
+    std::cout << "Test Passed: " << testName << std::endl;
+  }
+}
+
+// Evaluates one expression, written without its outer parentheses
+static std::string evaluate(Autumn::Interpreter &interpreter,
+                            const std::string &expr) {
+  return interpreter.evaluateToString(expr);
+}
+
+// What the random variables hold after each step of a run
+static std::vector<std::string> run(uint64_t seed, size_t workers) {
+  Autumn::TaskScheduler::instance().setWorkerCount(workers);
+  std::string source = program;
+  Autumn::SExpParser parser(source);
+  Autumn::Interpreter interpreter;
+  interpreter.start(parser.parseStmt(), "", "", seed);
+  std::vector<std::string> draws;
+  for (int i = 0; i < kSteps; i++) {
+    interpreter.step();
+    draws.push_back(interpreter.evaluateToString("picks"));
+    draws.push_back(interpreter.evaluateToString("where"));
+  }
+  return draws;
+}
+
+// randomFreePositions, randomDistinctPositions and randomFreePos give
+// distinct cells of the grid, as many as asked for or as there are
+static void testSampling() {
+  std::string source = program;
+  Autumn::SExpParser parser(source);
+  Autumn::Interpreter interpreter;
+  interpreter.start(parser.parseStmt(), "", "", 7);
+  // Rendering marks the blocks' cells as occupied
+  interpreter.step();
+
+  testEqual("distinct positions",
+            evaluate(interpreter,
+                     "length (setOf (randomDistinctPositions 16 200))"),
+            evaluate(interpreter, "+ 100 100"));
+  testEqual("distinct positions in bounds",
+            evaluate(interpreter,
+                     "any (--> p (! (isWithinBounds p))) "
+                     "(randomDistinctPositions 16 200)"),
+            evaluate(interpreter, "false"));
+  testEqual("distinct positions fill the grid",
+            evaluate(interpreter,
+                     "length (setOf (randomDistinctPositions 4 100))"),
+            evaluate(interpreter, "+ 8 8"));
+  testEqual("distinct positions of no grid",
+            evaluate(interpreter, "length (randomDistinctPositions 0 3)"),
+            evaluate(interpreter, "+ 0 0"));
+  testEqual("distinct positions of a negative count",
+            evaluate(interpreter, "length (randomDistinctPositions 4 -1)"),
+            evaluate(interpreter, "+ 0 0"));
+  testEqual("free positions fill the free cells",
+            evaluate(interpreter,
+                     "length (setOf (randomFreePositions 4 100))"),
+            evaluate(interpreter, "+ 8 5"));
+  testEqual("free positions skip the blocks",
+            evaluate(interpreter,
+                     "any (--> p (== (.. p y) 0)) "
+                     "(filter (--> p (< (.. p x) 3)) "
+                     "(randomFreePositions 4 100))"),
+            evaluate(interpreter, "false"));
+  testEqual("free position is free",
+            evaluate(interpreter, "isFreePos (randomFreePos 16)"),
+            evaluate(interpreter, "true"));
+}
+
+int main() {
+  std::vector<std::string> sequential = run(7, 0);
+  testEqual("same seed", run(7, 0), sequential);
+  testDiffer("other seed", run(8, 0), sequential);
+  testEqual("same seed on worker threads", run(7, 3), sequential);
+  Autumn::TaskScheduler::instance().setWorkerCount(0);
+  testSampling();
+
+  std::cout << "All random draw tests passed!" << std::endl;
+  return 0;
+}
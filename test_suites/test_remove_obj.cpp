@@ -0,0 +1,71 @@
+#include <cassert>
+#include <iostream>
+#include <string>
+
+#include "Interpreter.hpp"
+#include "Parser.hpp"
+
+// Positions with equal coordinates share one interned value, but removeObj
+// must still treat the elements of a list as separate objects.
+static const std::string program = R"((program
+  (= GRID_SIZE 4)
+  (: ps (List Position))
+  (= ps (list (Position 1 1) (Position 2 2) (Position 1 1)))
+  (: qs (List Position))
+  (= qs (addObj (list (Position 2 2)) (Position 1 1)))
+  (: ns (List Number))
+  (= ns (list 1 5 2 5))
+))";
+
+// Helper for testing and printing results:
+static void testEqual(const std::string &testName, const std::string &actual,
+                      const std::string &expected) {
+  if (actual != expected) {
+    std::cerr << "Test Failed: " << testName << "\n  Expected: " << expected
+              << "\n  Actual:   " << actual << std::endl;
+    assert(false);
+  } else {
+    std::cout << "Test Passed: " << testName << std::endl;
+  }
+}
+
+// Evaluates one expression, written without its outer parentheses
+static std::string evaluate(Autumn::Interpreter &interpreter,
+                            const std::string &expr) {
+  return interpreter.evaluateToString(expr);
+}
+
+int main() {
+  std::string source = program;
+  Autumn::SExpParser parser(source);
+  Autumn::Interpreter interpreter;
+  interpreter.start(parser.parseStmt());
+
+  std::string ps = evaluate(interpreter, "ps");
+  std::string ns = evaluate(interpreter, "ns");
+
+  // Instance form
+  testEqual("removeObj head", evaluate(interpreter, "removeObj ps (head ps)"),
+            evaluate(interpreter, "list (Position 2 2) (Position 1 1)"));
+  testEqual("removeObj added",
+            evaluate(interpreter, "removeObj qs (at qs 1)"),
+            evaluate(interpreter, "list (Position 2 2)"));
+  testEqual("removeObj new position",
+            evaluate(interpreter, "removeObj ps (Position 1 1)"), ps);
+
+  // List form
+  testEqual("removeObj list of elements",
+            evaluate(interpreter, "removeObj ps (list (at ps 0) (at ps 1))"),
+            evaluate(interpreter, "list (Position 1 1)"));
+  testEqual("removeObj list of new positions",
+            evaluate(interpreter, "removeObj ps (list (Position 1 1))"), ps);
+  testEqual("removeObj list of numbers",
+            evaluate(interpreter, "removeObj ns (list 5)"), ns);
+  testEqual("removeObj list of interned positions",
+            evaluate(interpreter,
+                     "removeObj (allPositions 2) (allPositions 2)"),
+            evaluate(interpreter, "allPositions 2"));
+
+  std::cout << "All removeObj tests passed!" << std::endl;
+  return 0;
+}
@@ -0,0 +1,124 @@
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Interpreter.hpp"
+#include "Parser.hpp"
+#include "TypeChecker.hpp"
+
+// The type checker proves sites well-typed ahead of time; what it finds
+// wrong is reported as warnings, and the program still starts.
+static const std::string wellTyped = R"((program
+  (= GRID_SIZE 8)
+  (object Ball (: speed Number) (Cell 0 0 "red"))
+  (: ball Ball)
+  (= ball (initnext (Ball 1 (Position 0 0)) (prev ball)))
+  (: count Number)
+  (= count (initnext 0 (+ (prev count) (.. ball speed))))
+  (: xs (List Number))
+  (= xs (initnext (range 0 3) (map (--> x (+ x 1)) (prev xs))))
+))";
+
+static const std::string illTyped = R"((program
+  (= GRID_SIZE 8)
+  (object Ball (: speed Number) (Cell 0 0 "red"))
+  (: ball Ball)
+  (= ball (initnext (Ball 1 (Position 0 0)) (Ball "fast" (Position 0 0))))
+  (: count Number)
+  (= count (initnext 0 (+ (prev count) "one")))
+  (: label String)
+  (= label (initnext "a" 3))
+  (: mystery Widget)
+))";
+
+// Helper for testing and printing results:
+static void testEqual(const std::string &testName, const std::string &actual,
+                      const std::string &expected) {
+  if (actual != expected) {
+    std::cerr << "Test Failed: " << testName << "\n  Expected: " << expected
+              << "\n  Actual:   " << actual << std::endl;
+    assert(false);
+  } else {
+    std::cout << "Test Passed: " << testName << std::endl;
+  }
+}
+
+static void testTrue(const std::string &testName, bool condition) {
+  if (!condition) {
+    std::cerr << "Test Failed: " << testName << std::endl;
+    assert(false);
+  } else {
+    std::cout << "Test Passed: " << testName << std::endl;
+  }
+}
+
+// Whether one of the warnings contains expected
+static bool hasWarning(const std::vector<std::string> &warnings,
+                       const std::string &expected) {
+  for (const auto &warning : warnings) {
+    if (warning.find(expected) != std::string::npos) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static void testProofs() {
+  std::string source = wellTyped;
+  Autumn::SExpParser parser(source);
+  Autumn::TypeChecker checker;
+  std::vector<std::string> errors = checker.check(parser.parseStmt());
+  testTrue("well-typed program has no errors", errors.empty());
+  testTrue("proven next of an object", checker.isProvenNext("ball"));
+  testTrue("proven next through a field", checker.isProvenNext("count"));
+  // Collections are left to the runtime
+  testTrue("list next is not proven", !checker.isProvenNext("xs"));
+}
+
+static void testWarnings() {
+  std::string source = illTyped;
+  Autumn::SExpParser parser(source);
+  Autumn::Interpreter interpreter;
+  interpreter.start(parser.parseStmt());
+  const std::vector<std::string> &warnings = interpreter.getTypeWarnings();
+  testTrue("field mismatch",
+           hasWarning(warnings, "Field type mismatch: speed with type String "
+                                "vs Number"));
+  testTrue("binary operand",
+           hasWarning(warnings, "Binary + must be applied to two numbers, "
+                                "instead got Number and String"));
+  testTrue("assignment",
+           hasWarning(warnings, "Cannot assign value of type 'Number' to "
+                                "variable of type 'String' for variable "
+                                "'label'."));
+  testTrue("unknown type", hasWarning(warnings, "Unknown type 'Widget'"));
+  // The program runs until it reaches an ill-typed site, where the runtime
+  // checks raise the error
+  testEqual("starts despite warnings", interpreter.evaluateToString("count"),
+            interpreter.evaluateToString("+ 0 0"));
+  std::string error;
+  try {
+    interpreter.step();
+  } catch (const std::exception &e) {
+    error = e.what();
+  }
+  testTrue("step raises the error", !error.empty());
+}
+
+static void testNoWarnings() {
+  std::string source = wellTyped;
+  Autumn::SExpParser parser(source);
+  Autumn::Interpreter interpreter;
+  interpreter.start(parser.parseStmt());
+  testTrue("no warnings", interpreter.getTypeWarnings().empty());
+}
+
+int main() {
+  testProofs();
+  testNoWarnings();
+  testWarnings();
+
+  std::cout << "All type checker tests passed!" << std::endl;
+  return 0;
+}
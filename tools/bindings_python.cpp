@@ -1,6 +1,8 @@
 #include "AutumnValue.hpp"
 #include "Interpreter.hpp"
 #include "Parser.hpp"
+#include "TaskScheduler.hpp"
+#include <map>
 #include <memory>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
@@ -85,11 +87,78 @@ public:
   std::string evaluateToString(std::string expr) { return interpreter->evaluateToString(expr); }
   int getOnClauseCount() { return interpreter->getOnClauseCount(); }
   int getCoveredOnClauseCount() { return interpreter->getCoveredOnClauseCount(); }
+
+  std::map<std::string, size_t> getPoolStats() {
+    const Autumn::ValuePool::Stats &stats = interpreter->getPoolStats();
+    return {{"allocations", stats.allocations},
+            {"recycled", stats.recycled},
+            {"releases", stats.releases},
+            {"chunk_bytes", stats.chunkBytes},
+            {"live", stats.live}};
+  }
+
+  std::map<std::string, size_t> getStepMemoStats() {
+    const Autumn::StepMemo::Stats &stats = interpreter->getStepMemoStats();
+    return {{"hits", stats.hits},
+            {"misses", stats.misses},
+            {"uncached", stats.uncached},
+            {"slots", interpreter->getStepMemoSlotCount()}};
+  }
+
+  void setOptimizeAst(bool optimize) { interpreter->setOptimizeAst(optimize); }
+
+  void setParallel(bool parallel) { interpreter->setParallel(parallel); }
+
+  void setMemoizePureFunctions(bool memoize) {
+    interpreter->setMemoizePureFunctions(memoize);
+  }
+
+  std::map<std::string, std::map<std::string, size_t>> getFunctionMemoStats() {
+    std::map<std::string, std::map<std::string, size_t>> result;
+    for (const auto &[name, stats] : interpreter->getFunctionMemoStats()) {
+      result[name] = {{"hits", stats.hits},
+                      {"misses", stats.misses},
+                      {"uncached", stats.uncached},
+                      {"evictions", stats.evictions},
+                      {"entries", stats.entries},
+                      {"disabled", stats.disabled}};
+    }
+    return result;
+  }
 };
 
+static void stepAll(const std::vector<std::shared_ptr<InterpreterWrapper>> &wrappers) {
+  std::vector<Autumn::Interpreter *> interpreters;
+  interpreters.reserve(wrappers.size());
+  for (const auto &wrapper : wrappers) {
+    interpreters.push_back(wrapper->interpreter.get());
+  }
+  py::gil_scoped_release release;
+  Autumn::Interpreter::stepAll(interpreters);
+}
+
+static std::map<std::string, std::map<std::string, uint64_t>> getSchedulerStats() {
+  std::map<std::string, std::map<std::string, uint64_t>> result;
+  for (const auto &[label, stats] : Autumn::TaskScheduler::instance().getStats()) {
+    result[label] = {{"tasks", stats.tasks},
+                     {"stolen", stats.stolen},
+                     {"busy_ns", stats.busyNanos}};
+  }
+  return result;
+}
+
 PYBIND11_MODULE(interpreter_module, m) {
   m.doc() = "Autumn Interpreter";
 
+  m.def("step_all", &stepAll, "Step several interpreters at once on the shared worker threads");
+  m.def("set_worker_count", [](size_t count) { Autumn::TaskScheduler::instance().setWorkerCount(count); },
+        "Worker threads shared by all interpreters; 0 keeps all work on the calling thread");
+  m.def("get_worker_count", [] { return Autumn::TaskScheduler::instance().getWorkerCount(); },
+        "Get the number of shared worker threads");
+  m.def("get_scheduler_stats", &getSchedulerStats, "Get the task counters of the shared workers, by label");
+  m.def("reset_scheduler_stats", [] { Autumn::TaskScheduler::instance().resetStats(); },
+        "Reset the task counters of the shared workers");
+
   py::class_<InterpreterWrapper, std::shared_ptr<InterpreterWrapper>> cls(m, "Interpreter");
   cls.def(py::init<>())
       .def("step", &InterpreterWrapper::step, "Execute a step")
@@ -105,6 +174,12 @@ PYBIND11_MODULE(interpreter_module, m) {
       .def("get_environment_string", &InterpreterWrapper::getEnvironmentString, "Get environment string")
       .def("get_on_clause_count", &InterpreterWrapper::getOnClauseCount, "Get on clause count")
       .def("get_covered_on_clause_count", &InterpreterWrapper::getCoveredOnClauseCount, "Get covered on clause count")
+      .def("get_pool_stats", &InterpreterWrapper::getPoolStats, "Get value pool counters for the last step")
+      .def("get_step_memo_stats", &InterpreterWrapper::getStepMemoStats, "Get step memo counters for the last step")
+      .def("set_optimize_ast", &InterpreterWrapper::setOptimizeAst, "Fold constants before running; call before run_script")
+      .def("set_parallel", &InterpreterWrapper::setParallel, "Let map split large lists across the shared worker threads")
+      .def("set_memoize_pure_functions", &InterpreterWrapper::setMemoizePureFunctions, "Cache the results of pure functions; call before run_script")
+      .def("get_function_memo_stats", &InterpreterWrapper::getFunctionMemoStats, "Get the counters of each memoized function")
       .def("evaluate_to_string", &InterpreterWrapper::evaluateToString, "Evaluate to string")
       .def("restore_environment", &InterpreterWrapper::restoreEnvironment, "Restore environment")
       .def("tmp_execute_stmt", &InterpreterWrapper::tmpExecuteStmt, "Execute a statement")
@@ -1,7 +1,9 @@
 #include "sexpresso.hpp"
 // adding file handling
+#include "AstOptimizer.hpp"
 #include "AstPrinter.hpp"
 #include "Parser.hpp"
+#include "PositionTable.hpp"
 #include <fstream>
 #include <iostream>
 #include <iterator>
@@ -16,12 +18,31 @@ std::string readFile(const std::string &filename) {
   return buffer.str();
 }
 
+// parser <program> [--optimize [stdlib]]
+// With --optimize, prints the program as the interpreter runs it after the
+// optimizer has folded it together with the stdlib
 int main(int argc, char **argv) {
   std::string mysexpr = readFile(argv[1]);
+  bool optimize = argc > 2 && std::string(argv[2]) == "--optimize";
+  std::string stdlibPath = argc > 3 ? argv[3] : "autumnstdlib/stdlib.sexp";
   Autumn::SExpParser parser(mysexpr);
   Autumn::AstPrinter printer;
   try {
     std::vector<std::shared_ptr<Autumn::Stmt>> stmts = parser.parseStmt();
+    if (optimize) {
+      std::string stdlibSource = readFile(stdlibPath);
+      Autumn::SExpParser stdlibParser(stdlibSource);
+      std::vector<std::shared_ptr<Autumn::Stmt>> stdlib =
+          stdlibParser.parseStmt();
+      Autumn::PositionTable positions;
+      Autumn::AstOptimizer optimizer(&positions);
+      optimizer.optimize(stdlib, stmts);
+      const Autumn::AstOptimizer::Stats &stats = optimizer.getStats();
+      std::cerr << "Folded " << stats.folded << ", resolved "
+                << stats.aliases << " aliases, dropped " << stats.branches
+                << " branches, inlined " << stats.inlined << " calls"
+                << std::endl;
+    }
     for (const auto &stmt : stmts) {
       std::cout << printer.print(stmt) << std::endl;
     }